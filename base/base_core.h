@@ -27,8 +27,10 @@
 
 #if VOID_MSVC
     #define FindFirstBit(Mask) _tzcnt_u32(Mask)
+    #define CountSetBits(Mask) __popcnt(Mask)
 #elif VOID_CLANG || VOID_GCC
     #define FindFirstBit(Mask) __builtin_ctz(Mask)
+    #define CountSetBits(Mask) __builtin_popcount(Mask)
 #endif
 
 #define VOID_NAMECONCAT2(a, b)   a##b
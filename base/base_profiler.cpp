@@ -41,6 +41,8 @@ struct profile_anchor
     uint64_t TSCElapsedInclusive;
     uint64_t HitCount;
     uint64_t ProcessedByteCount;
+    uint64_t CounterValue;
+    uint64_t CounterMax;
     char const* Label;
 };
 static profile_anchor GlobalProfilerAnchors[4096];
@@ -87,6 +89,21 @@ struct profile_block
 
 #define TimeBandwidth(Name, ByteCount) profile_block VOID_NAMECONCAT(Block, __LINE__)(Name, __COUNTER__ + 1, ByteCount)
 
+// Counters sample a value instead of timing a block (queue depths, overruns). The anchor
+// keeps the amount of samples, the last one and the largest one.
+
+static void
+RecordProfileCounter(char const* Label, uint32_t AnchorIndex, uint64_t Value)
+{
+    profile_anchor* Anchor = GlobalProfilerAnchors + AnchorIndex;
+    Anchor->Label        = Label;
+    Anchor->HitCount    += 1;
+    Anchor->CounterValue = Value;
+    Anchor->CounterMax   = Value > Anchor->CounterMax ? Value : Anchor->CounterMax;
+}
+
+#define ProfileCounter(Name, Value) RecordProfileCounter(Name, __COUNTER__ + 1, Value)
+
 static void
 PrintTimeElapsed(uint64_t TotalTSCElapsed, uint64_t TimerFreq, profile_anchor* Anchor)
 {
@@ -125,12 +142,17 @@ PrintAnchorData(uint64_t TotalCPUElapsed, uint64_t TimerFreq)
         {
             PrintTimeElapsed(TotalCPUElapsed, TimerFreq, Anchor);
         }
+        else if (Anchor->HitCount)
+        {
+            printf("  %s[%llu]: %llu (max %llu)\n", Anchor->Label, Anchor->HitCount, Anchor->CounterValue, Anchor->CounterMax);
+        }
     }
 }
 
 #else
 
 #define TimeBandwidth(...)
+#define ProfileCounter(...)
 #define PrintAnchorData(...)
 
 static_assert(__COUNTER__ < VOID_ARRAYCOUNT(GlobalProfilerAnchors), "Number of profile points exceeds size of profiler::Anchors array");
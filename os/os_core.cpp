@@ -55,6 +55,20 @@ EnqueuePointerReleaseEvent(uint32_t Button, vec2_float Position, memory_arena *A
     }
 }
 
+static void
+EnqueueTextEvent(TextEvent Type, uint32_t Value, os_inputs *Inputs)
+{
+    VOID_ASSERT(Type != TextEvent::None);  // Internal Corruption
+
+    if(Inputs->TextEventCount < OSConstant_TextEventCapacity)
+    {
+        text_event &Event = Inputs->TextEvents[Inputs->TextEventCount++];
+        Event.Type      = Type;
+        Event.Codepoint = Type == TextEvent::Char ? Value : 0;
+        Event.Key       = Type == TextEvent::Key  ? Value : OSInputKey_None;
+    }
+}
+
 // -----------------------------------------------------------------------------------
 // Inputs Private Implementation
 
@@ -112,6 +126,123 @@ OSClearInputs(os_inputs *Inputs)
     Inputs->PointerEventList.Last  = 0;
     Inputs->PointerEventList.Count = 0;
     Inputs->Pointers[0].Delta      = vec2_float(0.f, 0.f);
+    Inputs->TextEventCount         = 0;
+}
+
+static bool
+OSHasInputs(os_inputs *Inputs)
+{
+    bool Result = (Inputs->PointerEventList.Count > 0 || Inputs->TextEventCount > 0 || Inputs->ScrollDeltaInLines != 0.f);
+
+    for (uint32_t Idx = 0; Idx < OS_KeyboardButtonCount && !Result; Idx++)
+    {
+        Result = (Inputs->KeyboardButtons[Idx].HalfTransitionCount > 0);
+    }
+
+    return Result;
+}
+
+// [Work Queue]
+
+// Returns 1 when there was nothing to do.
+
+static bool
+DoNextWorkEntry(os_work_queue *Queue)
+{
+    bool ShouldSleep = 0;
+
+    uint32_t OriginalNextEntryToRead = Queue->NextEntryToRead;
+    uint32_t NewNextEntryToRead      = (OriginalNextEntryToRead + 1) % OSConstant_WorkQueueCapacity;
+
+    if (OriginalNextEntryToRead != Queue->NextEntryToWrite)
+    {
+        uint32_t Index = OSAtomicCompareExchange32(&Queue->NextEntryToRead, NewNextEntryToRead, OriginalNextEntryToRead);
+        if (Index == OriginalNextEntryToRead)
+        {
+            os_work_entry Entry = Queue->Entries[Index];
+            Entry.Callback(Entry.Data);
+
+            OSAtomicIncrement32(&Queue->CompletionCount);
+        }
+    }
+    else
+    {
+        ShouldSleep = 1;
+    }
+
+    return ShouldSleep;
+}
+
+static void
+WorkQueueThreadProc(void *Data)
+{
+    os_work_queue *Queue = (os_work_queue *)Data;
+
+    for (;;)
+    {
+        if (DoNextWorkEntry(Queue))
+        {
+            OSWaitSemaphore(Queue->Semaphore);
+        }
+    }
+}
+
+static bool
+InitializeWorkQueue(os_work_queue *Queue, uint32_t ThreadCount)
+{
+    VOID_ASSERT(Queue);
+
+    Queue->CompletionGoal   = 0;
+    Queue->CompletionCount  = 0;
+    Queue->NextEntryToWrite = 0;
+    Queue->NextEntryToRead  = 0;
+    Queue->ThreadCount      = 0;
+    Queue->Semaphore        = OSCreateSemaphore(0, Max(ThreadCount, 1u));
+
+    if (!OSIsValidHandle(Queue->Semaphore))
+    {
+        return 0;
+    }
+
+    for (uint32_t Idx = 0; Idx < ThreadCount; ++Idx)
+    {
+        if (OSCreateThread(WorkQueueThreadProc, Queue))
+        {
+            Queue->ThreadCount += 1;
+        }
+    }
+
+    return 1;
+}
+
+static void
+PushWorkEntry(os_work_queue *Queue, os_work_proc *Callback, void *Data)
+{
+    uint32_t NewNextEntryToWrite = (Queue->NextEntryToWrite + 1) % OSConstant_WorkQueueCapacity;
+    VOID_ASSERT(NewNextEntryToWrite != Queue->NextEntryToRead);
+
+    os_work_entry *Entry = Queue->Entries + Queue->NextEntryToWrite;
+    Entry->Callback = Callback;
+    Entry->Data     = Data;
+
+    Queue->CompletionGoal = Queue->CompletionGoal + 1;  // Single writer, a store instead of a volatile increment
+
+    OSCompletePreviousWrites();
+
+    Queue->NextEntryToWrite = NewNextEntryToWrite;
+    OSSignalSemaphore(Queue->Semaphore);
+}
+
+static void
+CompleteAllWork(os_work_queue *Queue)
+{
+    while (Queue->CompletionGoal != Queue->CompletionCount)
+    {
+        DoNextWorkEntry(Queue);
+    }
+
+    Queue->CompletionGoal  = 0;
+    Queue->CompletionCount = 0;
 }
 
 // [Agnostic File API]
@@ -21,6 +21,8 @@ typedef enum OSConstant_Type
     OSConstant_MouseButtonCount       = 5,
     OSConstant_KeyboardButtonCount    = 256,
     OSConstant_MaxPath                = 256,
+    OSConstant_WorkQueueCapacity      = 256,
+    OSConstant_TextEventCapacity      = 256,
 } OSConstant_Type;
 
 typedef enum OSMouseButton_Type
@@ -127,6 +129,24 @@ static void EnqueuePointerMoveEvent     (vec2_float Position, vec2_float Delta,
 static void EnqueuePointerClickEvent    (uint32_t Button, vec2_float Position, memory_arena *Arena, pointer_event_list &List);
 static void EnqueuePointerReleaseEvent  (uint32_t Button, vec2_float Position, memory_arena *Arena, pointer_event_list &List);
 
+// Text events are the typed characters (surrogate pairs joined, returns as '\n') and the
+// editing keys, repeats included, in the order they were received. Key holds an
+// OSInputKey_Type. Events past OSConstant_TextEventCapacity in a frame are dropped.
+
+enum class TextEvent
+{
+    None = 0,
+    Char = 1,
+    Key  = 2,
+};
+
+struct text_event
+{
+    TextEvent Type;
+    uint32_t  Codepoint;
+    uint32_t  Key;
+};
+
 // ------------------------------------------------------------------------------------
 
 // NOTE:
@@ -137,12 +157,16 @@ struct os_inputs
     os_button_state    KeyboardButtons[OS_KeyboardButtonCount];
     input_pointer      Pointers[1];
     pointer_event_list PointerEventList;
+    text_event         TextEvents[OSConstant_TextEventCapacity];
+    uint32_t           TextEventCount;
 
     // Mouse
     float ScrollDeltaInLines;
     int   WheelScrollLine;
 };
 
+static void EnqueueTextEvent  (TextEvent Type, uint32_t Value, os_inputs *Inputs);
+
 typedef struct os_read_file
 {
     byte_string Content;
@@ -150,6 +174,40 @@ typedef struct os_read_file
     bool        FullyRead;
 } os_read_file;
 
+// Read-only view of a whole file, Content stays valid until OSUnmapFile.
+
+typedef struct os_mapped_file
+{
+    byte_string Content;
+    os_handle   File;
+    os_handle   Mapping;
+} os_mapped_file;
+
+// Work Queue
+// Single producer, multiple consumers. The producing thread pushes entries and helps
+// draining the queue while it waits for completion.
+
+typedef void os_thread_proc (void *Data);
+typedef void os_work_proc   (void *Data);
+
+typedef struct os_work_entry
+{
+    os_work_proc *Callback;
+    void         *Data;
+} os_work_entry;
+
+typedef struct os_work_queue
+{
+    uint32_t volatile CompletionGoal;
+    uint32_t volatile CompletionCount;
+    uint32_t volatile NextEntryToWrite;
+    uint32_t volatile NextEntryToRead;
+
+    os_handle     Semaphore;
+    uint32_t      ThreadCount;
+    os_work_entry Entries[OSConstant_WorkQueueCapacity];
+} os_work_queue;
+
 typedef struct os_glyph_info
 {
     vec2_int   Size;
@@ -162,6 +220,7 @@ typedef struct os_glyph_info
 static void       ProcessInputMessage  (os_button_state *NewState, bool IsDown);
 static float      OSGetScrollDelta     (void);
 static void       OSClearInputs        (os_inputs *Inputs);
+static bool       OSHasInputs          (os_inputs *Inputs);
 
 // [Files]
 
@@ -174,6 +233,24 @@ static os_handle    OSFindFile     (byte_string Path);
 static uint64_t          OSFileSize     (os_handle Handle);
 static os_read_file OSReadFile     (os_handle Handle, memory_arena *Arena);
 static void         OSReleaseFile  (os_handle Handle);
+static bool         OSWriteFile    (byte_string Path, byte_string Content);
+static os_mapped_file OSMapFile    (byte_string Path);
+static void           OSUnmapFile  (os_mapped_file *File);
+
+// [Threads]
+
+static bool      OSCreateThread            (os_thread_proc *Proc, void *Data);
+static os_handle OSCreateSemaphore         (uint32_t InitialCount, uint32_t MaxCount);
+static void      OSSignalSemaphore         (os_handle Semaphore);
+static void      OSWaitSemaphore           (os_handle Semaphore);
+
+static uint32_t  OSAtomicIncrement32       (uint32_t volatile *Value);
+static uint32_t  OSAtomicCompareExchange32 (uint32_t volatile *Value, uint32_t New, uint32_t Expected);
+static void      OSCompletePreviousWrites  (void);
+
+static bool      InitializeWorkQueue       (os_work_queue *Queue, uint32_t ThreadCount);
+static void      PushWorkEntry             (os_work_queue *Queue, os_work_proc *Callback, void *Data);
+static void      CompleteAllWork           (os_work_queue *Queue);
 
 // [OS State]
 
@@ -195,6 +272,10 @@ static void  OSSetCursor          (OSCursor_Type Type);
 static uint64_t OSReadTimer          (void);
 static uint64_t OSGetTimerFrequency  (void);
 
+// Blocks until an input/window event is queued or the deadline (OSReadTimer ticks) passes.
+// A deadline of 0 waits without a timeout.
+static void     OSWaitForEvents      (uint64_t Deadline);
+
 // Inputs:
 //   You may query input state using OSInputKey_Type.
 
@@ -254,6 +335,13 @@ typedef enum OSInputKey_Type
     OSInputKey_Slash,
     OSInputKey_Grave,
 
+    OSInputKey_Backspace,
+    OSInputKey_Delete,
+    OSInputKey_Left,
+    OSInputKey_Right,
+    OSInputKey_Home,
+    OSInputKey_End,
+
     OSInputKey_Count
 } OSInputKey_Type;
 
@@ -56,6 +56,13 @@ constexpr auto MakeWin32InputTable()
     Table[VK_OEM_PERIOD] = OSInputKey_Period;
     Table[VK_OEM_2]      = OSInputKey_Slash;
     Table[VK_OEM_3]      = OSInputKey_Grave;
+
+    Table[VK_BACK]       = OSInputKey_Backspace;
+    Table[VK_DELETE]     = OSInputKey_Delete;
+    Table[VK_LEFT]       = OSInputKey_Left;
+    Table[VK_RIGHT]      = OSInputKey_Right;
+    Table[VK_HOME]       = OSInputKey_Home;
+    Table[VK_END]        = OSInputKey_End;
     return Table;
 }
 
@@ -119,6 +126,47 @@ OSWin32WindowProc(HWND Handle, UINT Message, WPARAM WParam, LPARAM LParam)
         {
             ProcessInputMessage(&Inputs->KeyboardButtons[KeyIndex], IsDown);
         }
+
+        // Editing keys repeat while held, unlike the button states.
+
+        bool IsEditingKey = (KeyIndex >= OSInputKey_Backspace && KeyIndex <= OSInputKey_End);
+        if (IsDown && IsEditingKey)
+        {
+            EnqueueTextEvent(TextEvent::Key, KeyIndex, Inputs);
+        }
+    } break;
+
+    // Characters arrive as UTF-16 units. Control characters other than tabs and returns are
+    // dropped, backspace is sent as a key.
+
+    case WM_CHAR:
+    {
+        uint32_t Unit      = (uint32_t)WParam;
+        uint32_t Codepoint = Unit;
+
+        if (Unit >= 0xD800 && Unit < 0xDC00)
+        {
+            OSWin32State.HighSurrogate = Unit;
+            break;
+        }
+
+        if (Unit >= 0xDC00 && Unit < 0xE000)
+        {
+            uint32_t High = OSWin32State.HighSurrogate;
+            Codepoint = High ? 0x10000 + ((High - 0xD800) << 10) + (Unit - 0xDC00) : 0;
+        }
+
+        OSWin32State.HighSurrogate = 0;
+
+        if (Codepoint == '\r')
+        {
+            Codepoint = '\n';
+        }
+
+        if ((Codepoint >= 0x20 && Codepoint != 0x7F) || Codepoint == '\n' || Codepoint == '\t')
+        {
+            EnqueueTextEvent(TextEvent::Char, Codepoint, Inputs);
+        }
     } break;
 
     case WM_LBUTTONDOWN:
@@ -267,6 +315,7 @@ wWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPWSTR CmdLine, int ShowCmd
     }
 
     CreateVoidContext(); // NOTE: Perhaps lazily intialized?
+    UISetGlyphCacheDirectory(str8_lit("."));
 
     // Render State
     {
@@ -274,6 +323,9 @@ wWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPWSTR CmdLine, int ShowCmd
         vec2_int ClientSize = OSWin32GetClientSize(HWindow);
 
         RenderState.Renderer = InitializeRenderer(HWindow, ClientSize, OSWin32State.Arena);
+
+        // If the thread can't be created, frames are submitted from this thread instead.
+        StartRenderThread();
     }
 
     BeginProfile();
@@ -300,33 +352,47 @@ wWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, LPWSTR CmdLine, int ShowCmd
 
         vec2_int ClientSize = OSWin32GetClientSize(OSWin32State.HWindow);
 
+        ui_frame_status FrameStatus = {};
         {
             TimeBlock("UI Logic");
 
+            BeginRenderFrame(ClientSize);
             UIBeginFrame(ClientSize);
             Inspector::ShowUI();
-            UIEndFrame();
+            FrameStatus = UIEndFrame();
         }
 
         {
             TimeBlock("Render Commands");
-            SubmitRenderCommands(RenderState.Renderer, ClientSize, &RenderState.PassList);
+            EndRenderFrame(FrameStatus.NeedsRepaint);
         }
 
+        // Input may change state that only shows on the next frame, so we keep polling
+        // until a frame is fully quiet. Then we block until something happens.
+
+        if(FrameStatus.NeedsRepaint || FrameStatus.HadInput)
         {
             TimeBlock("Sleeping");
             Sleep(5);
         }
+        else
+        {
+            TimeBlock("Idle");
+            OSWaitForEvents(FrameStatus.WakeDeadline);
+        }
 
 
         PrintProfilingFrame += 1;
         if(PrintProfilingFrame == PrintProfilingFrameDelta)
         {
+            ProfileRenderFrameStats();
             EndAndPrintProfile();
             PrintProfilingFrame = 0;
         }
     }
 
+    UISaveGlyphCaches();
+
     return 0;
 }
 
@@ -448,6 +514,179 @@ OSReleaseFile(os_handle Handle)
     }
 }
 
+static bool
+OSWriteFile(byte_string Path, byte_string Content)
+{
+    bool Result = 0;
+
+    if (Path.String)
+    {
+        HANDLE FileHandle = CreateFileA((LPCSTR)Path.String, GENERIC_WRITE, 0, NULL,
+                                        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            BOOL     Success = 1;
+            uint64_t Written = 0;
+
+            while (Success && Written < Content.Size)
+            {
+                DWORD ToWrite = (DWORD)Min(Content.Size - Written, (uint64_t)VOID_MEGABYTE(64));
+                DWORD Wrote   = 0;
+
+                Success  = WriteFile(FileHandle, Content.String + Written, ToWrite, &Wrote, NULL);
+                Written += Wrote;
+            }
+
+            Result = Success && (Written == Content.Size);
+
+            CloseHandle(FileHandle);
+        }
+    }
+
+    return Result;
+}
+
+static os_mapped_file
+OSMapFile(byte_string Path)
+{
+    os_mapped_file Result = {};
+
+    if (Path.String)
+    {
+        HANDLE FileHandle = CreateFileA((LPCSTR)Path.String, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (FileHandle != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER FileSize = {};
+            HANDLE        Mapping  = 0;
+            void         *View     = 0;
+
+            // Empty files can't be mapped.
+            if (GetFileSizeEx(FileHandle, &FileSize) && FileSize.QuadPart > 0)
+            {
+                Mapping = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+                View    = Mapping ? MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0) : 0;
+            }
+
+            if (View)
+            {
+                Result.Content.String      = (uint8_t *)View;
+                Result.Content.Size        = FileSize.QuadPart;
+                Result.File.uint64_t[0]    = (uint64_t)FileHandle;
+                Result.Mapping.uint64_t[0] = (uint64_t)Mapping;
+            }
+            else
+            {
+                if (Mapping)
+                {
+                    CloseHandle(Mapping);
+                }
+
+                CloseHandle(FileHandle);
+            }
+        }
+    }
+
+    return Result;
+}
+
+static void
+OSUnmapFile(os_mapped_file *File)
+{
+    if (File->Content.String)
+    {
+        UnmapViewOfFile(File->Content.String);
+        CloseHandle((HANDLE)File->Mapping.uint64_t[0]);
+        CloseHandle((HANDLE)File->File.uint64_t[0]);
+    }
+
+    *File = {};
+}
+
+// [Threads]
+
+typedef struct os_win32_thread_params
+{
+    os_thread_proc *Proc;
+    void           *Data;
+} os_win32_thread_params;
+
+static DWORD WINAPI
+OSWin32ThreadProc(LPVOID Parameter)
+{
+    os_win32_thread_params Params = *(os_win32_thread_params *)Parameter;
+    free(Parameter);
+
+    Params.Proc(Params.Data);
+    return 0;
+}
+
+static bool
+OSCreateThread(os_thread_proc *Proc, void *Data)
+{
+    bool Result = 0;
+
+    auto *Params = static_cast<os_win32_thread_params *>(malloc(sizeof(os_win32_thread_params)));
+    if (Params)
+    {
+        Params->Proc = Proc;
+        Params->Data = Data;
+
+        HANDLE Thread = CreateThread(0, 0, OSWin32ThreadProc, Params, 0, 0);
+        if (Thread)
+        {
+            CloseHandle(Thread);
+            Result = 1;
+        }
+        else
+        {
+            free(Params);
+        }
+    }
+
+    return Result;
+}
+
+static os_handle
+OSCreateSemaphore(uint32_t InitialCount, uint32_t MaxCount)
+{
+    os_handle Result = {0};
+    Result.uint64_t[0] = (uint64_t)CreateSemaphoreEx(0, InitialCount, MaxCount, 0, 0, SEMAPHORE_ALL_ACCESS);
+    return Result;
+}
+
+static void
+OSSignalSemaphore(os_handle Semaphore)
+{
+    ReleaseSemaphore(OSWin32GetNativeHandle(Semaphore), 1, 0);
+}
+
+static void
+OSWaitSemaphore(os_handle Semaphore)
+{
+    WaitForSingleObjectEx(OSWin32GetNativeHandle(Semaphore), INFINITE, FALSE);
+}
+
+static uint32_t
+OSAtomicIncrement32(uint32_t volatile *Value)
+{
+    uint32_t Result = (uint32_t)InterlockedIncrement((LONG volatile *)Value);
+    return Result;
+}
+
+static uint32_t
+OSAtomicCompareExchange32(uint32_t volatile *Value, uint32_t New, uint32_t Expected)
+{
+    uint32_t Result = (uint32_t)InterlockedCompareExchange((LONG volatile *)Value, (LONG)New, (LONG)Expected);
+    return Result;
+}
+
+static void
+OSCompletePreviousWrites(void)
+{
+    MemoryBarrier();
+}
+
 // [Windowing]
 
 
@@ -480,3 +719,23 @@ OSGetTimerFrequency(void)
     QueryPerformanceFrequency(&Freq);
     return Freq.QuadPart;
     }
+
+static void
+OSWaitForEvents(uint64_t Deadline)
+{
+    DWORD Timeout = INFINITE;
+
+    if (Deadline)
+    {
+        uint64_t Now = OSReadTimer();
+        if (Deadline <= Now)
+        {
+            return;
+        }
+
+        uint64_t Milliseconds = ((Deadline - Now) * 1000) / OSGetTimerFrequency();
+        Timeout = (DWORD)Min(Milliseconds, (uint64_t)(INFINITE - 1));
+    }
+
+    MsgWaitForMultipleObjectsEx(0, 0, Timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+}
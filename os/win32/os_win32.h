@@ -24,6 +24,7 @@ typedef struct os_win32_state
 
     // internal (Queried by win32 specific code)
     HWND            HWindow;
+    uint32_t        HighSurrogate;  // Of a pending WM_CHAR pair, 0 if none
 } os_win32_state;
 
 extern os_win32_state OSWin32State;
@@ -28,19 +28,6 @@ D3D11GetShaderView(render_handle Handle)
     return Result;
 }
 
-static ID3D11Buffer *
-D3D11GetVertexBuffer(uint64_t Size, d3d11_renderer *Renderer)
-{
-    ID3D11Buffer *Result = Renderer->VBuffer64KB;
-
-    if(Size > VOID_KILOBYTE(64))
-    {
-        VOID_ASSERT(!"Implement");
-    }
-
-    return Result;
-}
-
 static void
 D3D11Release(d3d11_renderer *Renderer)
 {
@@ -71,6 +58,57 @@ D3D11Release(d3d11_renderer *Renderer)
     }
 }
 
+// Replaces the clip buffer by one of Capacity entries. Called at init and when a pass has
+// more clips than the buffer.
+
+static bool
+D3D11CreateClipBuffer(d3d11_renderer *Renderer, uint32_t Capacity)
+{
+    if (Renderer->ClipBufferView)
+    {
+        Renderer->ClipBufferView->Release();
+        Renderer->ClipBufferView = nullptr;
+    }
+
+    if (Renderer->ClipBuffer)
+    {
+        Renderer->ClipBuffer->Release();
+        Renderer->ClipBuffer = nullptr;
+    }
+
+    Renderer->ClipBufferCapacity = 0;
+
+    D3D11_BUFFER_DESC Desc = {};
+    Desc.ByteWidth           = Capacity * sizeof(d3d11_rect_clip);
+    Desc.Usage               = D3D11_USAGE_DYNAMIC;
+    Desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+    Desc.CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE;
+    Desc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    Desc.StructureByteStride = sizeof(d3d11_rect_clip);
+
+    HRESULT Error = Renderer->Device->CreateBuffer(&Desc, NULL, &Renderer->ClipBuffer);
+    if (FAILED(Error))
+    {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC ViewDesc = {};
+    ViewDesc.Format              = DXGI_FORMAT_UNKNOWN;
+    ViewDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+    ViewDesc.Buffer.FirstElement = 0;
+    ViewDesc.Buffer.NumElements  = Capacity;
+
+    Error = Renderer->Device->CreateShaderResourceView((ID3D11Resource *)Renderer->ClipBuffer, &ViewDesc, &Renderer->ClipBufferView);
+    if (FAILED(Error))
+    {
+        return false;
+    }
+
+    Renderer->ClipBufferCapacity = Capacity;
+
+    return true;
+}
+
 static d3d11_format
 D3D11GetFormat(RenderTexture Type)
 {
@@ -84,6 +122,12 @@ D3D11GetFormat(RenderTexture Type)
             Result.BytesPerPixel = 4;
         } break;
 
+        case RenderTexture::GreyScale:
+        {
+            Result.Native        = DXGI_FORMAT_R8_UNORM;
+            Result.BytesPerPixel = 1;
+        } break;
+
         default:
         {
             VOID_ASSERT(!"Invalid Format Type");
@@ -208,6 +252,46 @@ InitializeRenderer(void *HWindow, vec2_int Resolution, memory_arena *Arena)
         }
     }
 
+    // Clip Table
+    {
+        if(!D3D11CreateClipBuffer(Renderer, RectClipTableCapacity))
+        {
+            D3D11Release(Renderer);
+            return Result;
+        }
+    }
+
+    // Glyph Run Table
+    {
+        D3D11_BUFFER_DESC Desc = {};
+        Desc.ByteWidth           = GlyphRunCapacity * sizeof(render_glyph_run);
+        Desc.Usage               = D3D11_USAGE_DYNAMIC;
+        Desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        Desc.CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE;
+        Desc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        Desc.StructureByteStride = sizeof(render_glyph_run);
+
+        Error = Renderer->Device->CreateBuffer(&Desc, NULL, &Renderer->GlyphRunBuffer);
+        if(FAILED(Error))
+        {
+            D3D11Release(Renderer);
+            return Result;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC ViewDesc = {};
+        ViewDesc.Format              = DXGI_FORMAT_UNKNOWN;
+        ViewDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+        ViewDesc.Buffer.FirstElement = 0;
+        ViewDesc.Buffer.NumElements  = GlyphRunCapacity;
+
+        Error = Renderer->Device->CreateShaderResourceView((ID3D11Resource *)Renderer->GlyphRunBuffer, &ViewDesc, &Renderer->GlyphRunBufferView);
+        if(FAILED(Error))
+        {
+            D3D11Release(Renderer);
+            return Result;
+        }
+    }
+
     // Default Shaders
     {
         ID3D11Device       *Device  = Renderer->Device;
@@ -273,6 +357,41 @@ InitializeRenderer(void *HWindow, vec2_int Resolution, memory_arena *Arena)
         }
     }
 
+    // Glyph Shaders
+    {
+        ID3D11Device *Device = Renderer->Device;
+        byte_string   Source = byte_string_compile(D3D11GlyphShader);
+
+        ID3DBlob *VShaderSrcBlob = nullptr;
+        ID3DBlob *VShaderErrBlob = nullptr;
+        Error = D3DCompile(Source.String, Source.Size,
+                           0, 0, 0, "VSMain", "vs_5_0",
+                           0, 0, &VShaderSrcBlob, &VShaderErrBlob);
+        if(FAILED(Error))
+        {
+        }
+
+        void    *ByteCode = VShaderSrcBlob->GetBufferPointer();
+        uint64_t ByteSize = VShaderSrcBlob->GetBufferSize();
+        Device->CreateVertexShader(ByteCode, ByteSize, 0, &Renderer->GlyphVShader);
+        Device->CreateInputLayout(D3D11GlyphILayout, VOID_ARRAYCOUNT(D3D11GlyphILayout), ByteCode, ByteSize, &Renderer->GlyphILayout);
+
+        VShaderSrcBlob->Release();
+
+        ID3DBlob *PShaderSrcBlob = nullptr;
+        ID3DBlob *PShaderErrBlob = nullptr;
+        Error = D3DCompile(Source.String, Source.Size,
+                           0, 0, 0, "PSMain", "ps_5_0",
+                           0, 0, &PShaderSrcBlob, &PShaderErrBlob);
+        if(FAILED(Error))
+        {
+        }
+
+        Device->CreatePixelShader(PShaderSrcBlob->GetBufferPointer(), PShaderSrcBlob->GetBufferSize(), 0, &Renderer->GlyphPShader);
+
+        PShaderSrcBlob->Release();
+    }
+
     // Uniform Buffers
     {
         ID3D11Device *Device = Renderer->Device;
@@ -327,6 +446,13 @@ InitializeRenderer(void *HWindow, vec2_int Resolution, memory_arena *Arena)
         if (FAILED(Error))
         {
         }
+
+        Desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+
+        Error = Renderer->Device->CreateSamplerState(&Desc, &Renderer->DistanceSamplerState);
+        if (FAILED(Error))
+        {
+        }
     }
 
     // Raster State
@@ -386,6 +512,23 @@ SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_l
         DeviceContext->ClearRenderTargetView(RenderView, ClearColor);
     }
 
+    // Texture Updates
+    for (render_texture_update_node *Node = RenderPassList->FirstUpdate; Node != 0; Node = Node->Next)
+    {
+        render_texture_update Update  = Node->Value;
+        ID3D11Texture2D      *Texture = D3D11GetTexture2D(Update.Texture);
+
+        D3D11_BOX Box;
+        Box.left   = Update.X;
+        Box.top    = Update.Y;
+        Box.front  = 0;
+        Box.right  = Update.X + Update.Width;
+        Box.bottom = Update.Y + Update.Height;
+        Box.back   = 1;
+
+        DeviceContext->UpdateSubresource((ID3D11Resource *)Texture, 0, &Box, Update.Pixels, Update.Pitch, 0);
+    }
+
     for (render_pass_node *PassNode = RenderPassList->First; PassNode != 0; PassNode = PassNode->Next)
     {
         render_pass Pass = PassNode->Value;
@@ -402,36 +545,73 @@ SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_l
             DeviceContext->RSSetState(Renderer->RasterSt[RenderPass_UI]);
             DeviceContext->RSSetViewports(1, &Viewport);
 
-            for (rect_group_node *Node = Params.First; Node != 0; Node = Node->Next)
+            // Scissor (Clipping is resolved per-instance in the shader)
             {
-                render_batch_list BatchList  = Node->BatchList;
-                rect_group_params NodeParams = Node->Params;
+                D3D11_RECT Rect = {};
+                Rect.left   = 0;
+                Rect.right  = Resolution.X;
+                Rect.top    = 0;
+                Rect.bottom = Resolution.Y;
 
-                // Vertex Buffer
-                ID3D11Buffer *VBuffer = D3D11GetVertexBuffer(BatchList.ByteCount, Renderer);
+                DeviceContext->RSSetScissorRects(1, &Rect);
+            }
+
+            // Clip Table
+            {
+                rect_clip_table Table = Params.ClipTable;
+
+                if (Table.Count > Renderer->ClipBufferCapacity)
                 {
-                    D3D11_MAPPED_SUBRESOURCE Resource = { 0 };
-                    DeviceContext->Map((ID3D11Resource *)VBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Resource);
+                    uint32_t Capacity = Max(Renderer->ClipBufferCapacity, RectClipTableCapacity);
+                    while (Capacity < Table.Count)
+                    {
+                        Capacity *= 2;
+                    }
 
-                    uint8_t *WritePointer = static_cast<uint8_t*>(Resource.pData);
-                    uint64_t WriteOffset  = 0;
-                    for (render_batch_node *Batch = BatchList.First; Batch != 0; Batch = Batch->Next)
+                    // Clips past a failed resize read as zero, which draws nothing.
+                    if (!D3D11CreateClipBuffer(Renderer, Capacity))
                     {
-                        uint64_t WriteSize = Batch->Value.ByteCount;
-                        MemoryCopy(WritePointer + WriteOffset, Batch->Value.Memory, WriteSize);
-                        WriteOffset += WriteSize;
+                        D3D11CreateClipBuffer(Renderer, RectClipTableCapacity);
                     }
 
-                    DeviceContext->Unmap((ID3D11Resource *)VBuffer, 0);
+                    Table.Count = Min(Table.Count, Renderer->ClipBufferCapacity);
+                }
+
+                D3D11_MAPPED_SUBRESOURCE Resource = {};
+                DeviceContext->Map((ID3D11Resource *)Renderer->ClipBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Resource);
+
+                d3d11_rect_clip *Clips = static_cast<d3d11_rect_clip *>(Resource.pData);
+                if (Table.Count == 0)
+                {
+                    Clips[0].Transform[0] = Vec4float(1, 0, 0, 0);
+                    Clips[0].Transform[1] = Vec4float(0, 1, 0, 0);
+                    Clips[0].Transform[2] = Vec4float(0, 0, 1, 0);
+                    Clips[0].Clip         = Vec4float(0, 0, 0, 0);
                 }
 
+                for (uint32_t Idx = 0; Idx < Table.Count; ++Idx)
+                {
+                    matrix_3x3 Transform = Table.Entries[Idx].Transform;
+                    rect_float Clip      = Table.Entries[Idx].Clip;
+
+                    Clips[Idx].Transform[0] = Vec4float(Transform.c0r0, Transform.c0r1, Transform.c0r2, 0);
+                    Clips[Idx].Transform[1] = Vec4float(Transform.c1r0, Transform.c1r1, Transform.c1r2, 0);
+                    Clips[Idx].Transform[2] = Vec4float(Transform.c2r0, Transform.c2r1, Transform.c2r2, 0);
+                    Clips[Idx].Clip         = Vec4float(Clip.Left, Clip.Top, Clip.Right, Clip.Bottom);
+                }
+
+                DeviceContext->Unmap((ID3D11Resource *)Renderer->ClipBuffer, 0);
+            }
+
+            for (rect_group_node *Node = Params.First; Node != 0; Node = Node->Next)
+            {
+                render_batch_list BatchList  = Node->BatchList;
+                rect_group_params NodeParams = Node->Params;
+
                 // Uniform Buffers
                 ID3D11Buffer *UniformBuffer = Renderer->UBuffers[RenderPass_UI];
                 {
                     d3d11_rect_uniform_buffer Uniform = {};
-                    Uniform.Transform[0]        = Vec4float(NodeParams.Transform.c0r0, NodeParams.Transform.c0r1, NodeParams.Transform.c0r2, 0);
-                    Uniform.Transform[1]        = Vec4float(NodeParams.Transform.c1r0, NodeParams.Transform.c1r1, NodeParams.Transform.c1r2, 0);
-                    Uniform.Transform[2]        = Vec4float(NodeParams.Transform.c2r0, NodeParams.Transform.c2r1, NodeParams.Transform.c2r2, 0);
                     Uniform.ViewportSizeInPixel = vec2_float((float)Resolution.X, (float)Resolution.Y);
                     Uniform.AtlasSizeInPixel    = vec2_float((float)NodeParams.TextureSize.X, (float)NodeParams.TextureSize.Y);
 
@@ -442,11 +622,30 @@ SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_l
                 }
 
                 // Pipeline Info
+                ID3D11Buffer             *VBuffer   = Renderer->VBuffer64KB;
                 ID3D11InputLayout        *ILayout   = Renderer->ILayouts[RenderPass_UI];
                 ID3D11VertexShader       *VShader   = Renderer->VShaders[RenderPass_UI];
                 ID3D11PixelShader        *PShader   = Renderer->PShaders[RenderPass_UI];
                 ID3D11ShaderResourceView *AtlasView = D3D11GetShaderView(NodeParams.Texture);
 
+                // Glyph Runs (Paint caps a group at GlyphRunCapacity runs)
+                if (NodeParams.Type == RectGroup_Glyphs)
+                {
+                    ILayout = Renderer->GlyphILayout;
+                    VShader = Renderer->GlyphVShader;
+                    PShader = Renderer->GlyphPShader;
+
+                    VOID_ASSERT(GetGlyphRunCount(Node) <= GlyphRunCapacity);
+
+                    D3D11_MAPPED_SUBRESOURCE Resource = {};
+                    DeviceContext->Map((ID3D11Resource *)Renderer->GlyphRunBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Resource);
+                    GatherGlyphRuns(Node, static_cast<render_glyph_run *>(Resource.pData));
+                    DeviceContext->Unmap((ID3D11Resource *)Renderer->GlyphRunBuffer, 0);
+
+                    DeviceContext->VSSetShaderResources(2, 1, &Renderer->GlyphRunBufferView);
+                    DeviceContext->PSSetSamplers(1, 1, &Renderer->DistanceSamplerState);
+                }
+
                 // OM
                 DeviceContext->OMSetRenderTargets(1, &Renderer->RenderView, 0);
                 DeviceContext->OMSetBlendState(Renderer->DefaultBlendState, 0, 0xFFFFFFFF);
@@ -461,43 +660,48 @@ SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_l
                 // Shaders
                 DeviceContext->VSSetShader(VShader, 0, 0);
                 DeviceContext->VSSetConstantBuffers(0, 1, &UniformBuffer);
+                DeviceContext->VSSetShaderResources(1, 1, &Renderer->ClipBufferView);
                 DeviceContext->PSSetShader(PShader, 0, 0);
                 DeviceContext->PSSetShaderResources(0, 1, &AtlasView);
                 DeviceContext->PSSetSamplers(0, 1, &Renderer->AtlasSamplerState);
 
-                // Scissor
+                // Draw
+                // Groups only break on texture changes so they can outgrow the vertex buffer.
+                // Upload as many whole instances as fit, draw them and repeat. A batch bigger
+                // than the buffer is split across several rounds.
+                uint64_t           BytesPerInstance = BatchList.BytesPerInstance;
+                uint64_t           Capacity         = VOID_KILOBYTE(64) - (VOID_KILOBYTE(64) % BytesPerInstance);
+                render_batch_node *Batch            = BatchList.First;
+                uint64_t           BatchOffset      = 0;
+                while (Batch)
                 {
-                    rect_float   Clip = NodeParams.Clip;
-                    D3D11_RECT Rect = {};
+                    D3D11_MAPPED_SUBRESOURCE Resource = { 0 };
+                    DeviceContext->Map((ID3D11Resource *)VBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &Resource);
 
-                    if (Clip.Left == 0 && Clip.Top == 0 && Clip.Right == 0 && Clip.Bottom == 0)
-                    {
-                        Rect.left   = 0;
-                        Rect.right  = Resolution.X;
-                        Rect.top    = 0;
-                        Rect.bottom = Resolution.Y;
-                    } else
-                    if (Clip.Left > Clip.Right || Clip.Top > Clip.Bottom)
-                    {
-                        Rect.left   = 0;
-                        Rect.right  = 0;
-                        Rect.top    = 0;
-                        Rect.bottom = 0;
-                    }
-                    else
+                    uint8_t *WritePointer = static_cast<uint8_t*>(Resource.pData);
+                    uint64_t WriteOffset  = 0;
+                    while (Batch && WriteOffset < Capacity)
                     {
-                        Rect.left   = Clip.Left;
-                        Rect.right  = Clip.Right;
-                        Rect.top    = Clip.Top;
-                        Rect.bottom = Clip.Bottom;
+                        VOID_ASSERT(Batch->Value.ByteCount % BytesPerInstance == 0);
+
+                        uint64_t Remaining = Batch->Value.ByteCount - BatchOffset;
+                        uint64_t WriteSize = Min(Remaining, Capacity - WriteOffset);
+                        MemoryCopy(WritePointer + WriteOffset, Batch->Value.Memory + BatchOffset, WriteSize);
+                        WriteOffset += WriteSize;
+                        BatchOffset += WriteSize;
+
+                        if (BatchOffset == Batch->Value.ByteCount)
+                        {
+                            Batch       = Batch->Next;
+                            BatchOffset = 0;
+                        }
                     }
 
-                    DeviceContext->RSSetScissorRects(1, &Rect);
-                }
+                    DeviceContext->Unmap((ID3D11Resource *)VBuffer, 0);
 
-                // Draw
-                uint32_t InstanceCount = (uint32_t)(BatchList.ByteCount / BatchList.BytesPerInstance);
-                DeviceContext->DrawInstanced(4, InstanceCount, 0, 0);
+                    uint32_t InstanceCount = (uint32_t)(WriteOffset / BatchList.BytesPerInstance);
+                    DeviceContext->DrawInstanced(4, InstanceCount, 0, 0);
+                }
             }
         } break;
 
@@ -514,8 +718,7 @@ SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_l
     DeviceContext->ClearState();
 
     // Clear
-    RenderPassList->First = 0;
-    RenderPassList->Last  = 0;
+    ClearRenderPassList(RenderPassList);
 }
 
 // -----------------------------------------------------------------------------------
@@ -27,11 +27,18 @@ typedef struct gpu_font_context
 
 typedef struct d3d11_rect_uniform_buffer
 {
-    vec4_float Transform[3];
     vec2_float ViewportSizeInPixel;
     vec2_float AtlasSizeInPixel;
 } d3d11_rect_uniform_buffer;
 
+// Mirrors RectClip in the rect shader, one entry per rect_clip_params.
+
+typedef struct d3d11_rect_clip
+{
+    vec4_float Transform[3];
+    vec4_float Clip;
+} d3d11_rect_clip;
+
 typedef struct d3d11_input_layout
 {
     const D3D11_INPUT_ELEMENT_DESC *Desc;
@@ -47,9 +54,15 @@ typedef struct d3d11_renderer
     ID3D11RenderTargetView *RenderView;
     ID3D11BlendState       *DefaultBlendState;
     ID3D11SamplerState     *AtlasSamplerState;
+    ID3D11SamplerState     *DistanceSamplerState;   // Bilinear, distance fields are scaled
 
     // Buffers
-    ID3D11Buffer *VBuffer64KB;
+    ID3D11Buffer             *VBuffer64KB;
+    ID3D11Buffer             *ClipBuffer;
+    ID3D11ShaderResourceView *ClipBufferView;
+    uint32_t                  ClipBufferCapacity;   // Grows with the clip tables
+    ID3D11Buffer             *GlyphRunBuffer;
+    ID3D11ShaderResourceView *GlyphRunBufferView;
 
     // Pipelines
     ID3D11InputLayout     *ILayouts[RenderPass_Count];
@@ -58,6 +71,11 @@ typedef struct d3d11_renderer
     ID3D11Buffer          *UBuffers[RenderPass_Count];
     ID3D11RasterizerState *RasterSt[RenderPass_Count];
 
+    // Glyph groups share the rect pass state but expand instances from their run.
+    ID3D11InputLayout     *GlyphILayout;
+    ID3D11VertexShader    *GlyphVShader;
+    ID3D11PixelShader     *GlyphPShader;
+
     // State
     vec2_int LastResolution;
 } d3d11_renderer;
@@ -73,7 +91,8 @@ const static D3D11_INPUT_ELEMENT_DESC D3D11RectILayout[] =
     {"COL" , 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
     {"COL" , 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
     {"CORR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
-    {"STY" , 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"STY" , 0, DXGI_FORMAT_R32G32B32_FLOAT   , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"CLIP", 0, DXGI_FORMAT_R32_UINT          , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
 };
 
 const static uint8_t D3D11RectShader[] =
@@ -81,7 +100,6 @@ const static uint8_t D3D11RectShader[] =
 "                                                                                                  \n"
 "cbuffer Constants : register(b0)                                                                  \n"
 "{                                                                                                 \n"
-"    float3x3 Transform;                                                                           \n"
 "    float2   ViewportSizeInPixel;                                                                 \n"
 "    float2   AtlasSizeInPixel;                                                                    \n" 
 "};                                                                                                \n"
@@ -95,7 +113,8 @@ const static uint8_t D3D11RectShader[] =
 "    float4 ColorTopRight      : COL2;                                                            \n"
 "    float4 ColorBotRight      : COL3;                                                            \n"
 "    float4 CornerRadiiInPixel : CORR;                                                            \n"
-"    float4 StyleParams        : STY;                                                             \n" // X: BorderWidth, Y: Softness, Z: Sample Atlas
+"    float3 StyleParams        : STY;                                                             \n" // X: BorderWidth, Y: Softness, Z: Sample Atlas
+"    uint   ClipIndex          : CLIP;                                                            \n" // Index in the clip table
 "    uint   VertexId           : SV_VertexID;                                                     \n"
 "};                                                                                                \n"
 "                                                                                                  \n"
@@ -111,11 +130,22 @@ const static uint8_t D3D11RectShader[] =
 "   nointerpolation float  SoftnessInPixel     : SFT;                                              \n"
 "   nointerpolation float  BorderWidthInPixel  : BDW;                                              \n"
 "   nointerpolation float  MustSampleAtlas     : MSA;                                              \n"
+"   nointerpolation float4 ClipInPixel         : CLP;                                              \n"
 "};                                                                                                \n"
 "                                                                                                  \n"
 "Texture2D    AtlasTexture : register(t0);                                                         \n"
 "SamplerState AtlasSampler : register(s0);                                                         \n"
 "                                                                                                  \n"
+"struct RectClip                                                                                   \n"
+"{                                                                                                 \n"
+"    float4 TransformC0;                                                                           \n"
+"    float4 TransformC1;                                                                           \n"
+"    float4 TransformC2;                                                                           \n"
+"    float4 ClipInPixel;                                                                           \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"StructuredBuffer<RectClip> ClipTable : register(t1);                                              \n"
+"                                                                                                  \n"
 "// [Helpers]                                                                                      \n"
 "                                                                                                  \n"
 "float RectSDF(float2 SamplePosition, float2 RectHalfSize, float Radius)                           \n" // Everything is solved in the first quadrant because of symmetry on both axes.
@@ -171,6 +201,10 @@ const static uint8_t D3D11RectShader[] =
 "    CornerAxisPercent.x = (Input.VertexId >> 1) ? 1.f : 0.f;                                      \n"
 "    CornerAxisPercent.y = (Input.VertexId &  1) ? 0.f : 1.f;                                      \n"
 "                                                                                                  \n"
+"    RectClip Clip      = ClipTable[Input.ClipIndex];                                              \n"
+"    float3x3 Transform = float3x3(Clip.TransformC0.xyz, Clip.TransformC1.xyz, Clip.TransformC2.xyz);\n" // The constructor takes rows but columns are stored
+"    Transform          = transpose(Transform);                                                    \n"
+"                                                                                                  \n"
 "    float2 Transformed = mul(Transform, float3(CornerPositionInPixel[Input.VertexId], 1.f)).xy;   \n"
 "    Transformed.y = ViewportSizeInPixel.y - Transformed.y;                                        \n"
 "                                                                                                  \n"
@@ -186,12 +220,19 @@ const static uint8_t D3D11RectShader[] =
 "    Output.Tint                = SourceColor[Input.VertexId];                                     \n"
 "    Output.MustSampleAtlas     = Input.StyleParams.z;                                             \n"
 "    Output.TexCoordInPercent   = AtlasSourceInPixel[Input.VertexId] / AtlasSizeInPixel;           \n"
+"    Output.ClipInPixel         = Clip.ClipInPixel;                                                \n"
 "                                                                                                  \n"
 "    return Output;                                                                                \n"
 "}                                                                                                 \n"
 "                                                                                                  \n"
 "float4 PSMain(VertexToPixel Input) : SV_TARGET                                                    \n"
 "{                                                                                                 \n"
+"    float4 Clip = Input.ClipInPixel;                                                              \n"
+"    if(any(Clip != 0))                                                                            \n" // A zero clip means no clip, an inverted clip rejects everything
+"    {                                                                                             \n"
+"        float2 Pixel = Input.Position.xy;                                                         \n"
+"        if(any(Pixel < Clip.xy) || any(Pixel >= Clip.zw)) discard;                                \n"
+"    }                                                                                             \n"
 "                                                                                                  \n"
 "    float4 AlbedoSample = float4(1, 1, 1, 1);                                                     \n"
 "    if(Input.MustSampleAtlas > 0)                                                                 \n"
@@ -234,6 +275,122 @@ const static uint8_t D3D11RectShader[] =
 "}                                                                                                 \n"
 ;
 
+// Glyph instances only hold an offset and a source rect, everything shared by a label
+// is read from the run table. Matches render_glyph and render_glyph_run.
+
+const static D3D11_INPUT_ELEMENT_DESC D3D11GlyphILayout[] =
+{
+    {"OFS", 0, DXGI_FORMAT_R16G16_SINT      , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"SRC", 0, DXGI_FORMAT_R16G16B16A16_UINT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+    {"RUN", 0, DXGI_FORMAT_R32_UINT         , 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+};
+
+const static uint8_t D3D11GlyphShader[] =
+"// [Inputs/Outputs]                                                                               \n"
+"                                                                                                  \n"
+"cbuffer Constants : register(b0)                                                                  \n"
+"{                                                                                                 \n"
+"    float2   ViewportSizeInPixel;                                                                 \n"
+"    float2   AtlasSizeInPixel;                                                                    \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"struct CPUToVertex                                                                                \n"
+"{                                                                                                 \n"
+"    int2   OffsetInPixel      : OFS;                                                              \n"
+"    uint4  AtlasSrcInPixel    : SRC;                                                              \n"
+"    uint   RunIndex           : RUN;                                                              \n"
+"    uint   VertexId           : SV_VertexID;                                                      \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"struct VertexToPixel                                                                              \n"
+"{                                                                                                 \n"
+"   float4 Position            : SV_POSITION;                                                      \n"
+"   float2 TexCoordInPercent   : TXP;                                                              \n"
+"                                                                                                  \n"
+"   nointerpolation float4 Tint        : TINT;                                                     \n"
+"   nointerpolation float4 ClipInPixel : CLP;                                                      \n"
+"   nointerpolation float  Sharpness   : SHP;                                                      \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"Texture2D    AtlasTexture : register(t0);                                                         \n"
+"SamplerState AtlasSampler : register(s0);                                                         \n"
+"SamplerState DistanceSampler : register(s1);                                                      \n"
+"                                                                                                  \n"
+"struct RectClip                                                                                   \n"
+"{                                                                                                 \n"
+"    float4 TransformC0;                                                                           \n"
+"    float4 TransformC1;                                                                           \n"
+"    float4 TransformC2;                                                                           \n"
+"    float4 ClipInPixel;                                                                           \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"struct GlyphRun                                                                                   \n"
+"{                                                                                                 \n"
+"    float2 OriginInPixel;                                                                         \n"
+"    uint   Color;                                                                                 \n"
+"    uint   ClipIndex;                                                                             \n"
+"    float  Scale;                                                                                 \n"
+"    float  Sharpness;                                                                             \n"
+"};                                                                                                \n"
+"                                                                                                  \n"
+"StructuredBuffer<RectClip> ClipTable : register(t1);                                              \n"
+"StructuredBuffer<GlyphRun> RunTable  : register(t2);                                              \n"
+"                                                                                                  \n"
+"VertexToPixel VSMain(CPUToVertex Input)                                                           \n"
+"{                                                                                                 \n"
+"    GlyphRun Run = RunTable[Input.RunIndex];                                                      \n"
+"                                                                                                  \n"
+"    float2 CornerAxisPercent;                                                                     \n"
+"    CornerAxisPercent.x = (Input.VertexId >> 1) ? 1.f : 0.f;                                      \n"
+"    CornerAxisPercent.y = (Input.VertexId &  1) ? 0.f : 1.f;                                      \n"
+"                                                                                                  \n"
+"    float2 SourceSize    = float2(Input.AtlasSrcInPixel.zw);                                      \n"
+"    float2 CornerInPixel = Run.OriginInPixel + float2(Input.OffsetInPixel) + CornerAxisPercent * SourceSize * Run.Scale;\n"
+"    float2 SourceInPixel = float2(Input.AtlasSrcInPixel.xy) + CornerAxisPercent * SourceSize;     \n"
+"                                                                                                  \n"
+"    RectClip Clip      = ClipTable[Run.ClipIndex];                                                \n"
+"    float3x3 Transform = float3x3(Clip.TransformC0.xyz, Clip.TransformC1.xyz, Clip.TransformC2.xyz);\n"
+"    Transform          = transpose(Transform);                                                    \n"
+"                                                                                                  \n"
+"    float2 Transformed = mul(Transform, float3(CornerInPixel, 1.f)).xy;                           \n"
+"    Transformed.y = ViewportSizeInPixel.y - Transformed.y;                                        \n"
+"                                                                                                  \n"
+"    uint4 Color = uint4(Run.Color, Run.Color >> 8, Run.Color >> 16, Run.Color >> 24) & 0xFF;      \n"
+"                                                                                                  \n"
+"    VertexToPixel Output;                                                                         \n"
+"    Output.Position.xy       = ((2.f * Transformed) / ViewportSizeInPixel) - 1.f;                 \n"
+"    Output.Position.z        = 0.f;                                                               \n"
+"    Output.Position.w        = 1.f;                                                               \n"
+"    Output.TexCoordInPercent = SourceInPixel / AtlasSizeInPixel;                                  \n"
+"    Output.Tint              = float4(Color) / 255.f;                                             \n"
+"    Output.ClipInPixel       = Clip.ClipInPixel;                                                  \n"
+"    Output.Sharpness         = Run.Sharpness;                                                     \n"
+"                                                                                                  \n"
+"    return Output;                                                                                \n"
+"}                                                                                                 \n"
+"                                                                                                  \n"
+"float4 PSMain(VertexToPixel Input) : SV_TARGET                                                    \n"
+"{                                                                                                 \n"
+"    float4 Clip = Input.ClipInPixel;                                                              \n"
+"    if(any(Clip != 0))                                                                            \n"
+"    {                                                                                             \n"
+"        float2 Pixel = Input.Position.xy;                                                         \n"
+"        if(any(Pixel < Clip.xy) || any(Pixel >= Clip.zw)) discard;                                \n"
+"    }                                                                                             \n"
+"                                                                                                  \n"
+"    float  Coverage = AtlasTexture.Sample(AtlasSampler, Input.TexCoordInPercent).r;               \n" // Glyph atlases are R8, coverage or distance is in the red channel
+"    if(Input.Sharpness > 0.f)                                                                     \n"
+"    {                                                                                             \n"
+"        float Distance = AtlasTexture.Sample(DistanceSampler, Input.TexCoordInPercent).r;         \n"
+"        Coverage       = saturate((Distance - 0.5f) * Input.Sharpness + 0.5f);                    \n"
+"    }                                                                                             \n"
+"                                                                                                  \n"
+"    float4 Output   = Input.Tint;                                                                 \n"
+"    Output.a       *= Coverage;                                                                   \n"
+"                                                                                                  \n"
+"    return Output;                                                                                \n"
+"}                                                                                                 \n"
+;
 
 const static byte_string D3D11ShaderSourceTable[] =
 {
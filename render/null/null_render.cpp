@@ -0,0 +1,141 @@
+// ------------------------------------------------------------------------------------
+// Private Helpers
+
+static null_renderer *
+NullGetRenderer(render_handle HRenderer)
+{
+    null_renderer *Result = (null_renderer *)HRenderer.Value[0];
+    return Result;
+}
+
+static void
+NullLockLog(null_renderer *Renderer)
+{
+    while (OSAtomicCompareExchange32(&Renderer->LogLock, 1, 0) != 0)
+    {
+        _mm_pause();
+    }
+}
+
+static void
+NullUnlockLog(null_renderer *Renderer)
+{
+    OSCompletePreviousWrites();
+    Renderer->LogLock = 0;
+}
+
+// [PER-RENDERER API]
+
+static render_handle
+InitializeRenderer(void *HWindow, vec2_int Resolution, memory_arena *Arena)
+{
+    VOID_UNUSED(HWindow);
+
+    render_handle  Result   = { 0 };
+    null_renderer *Renderer = PushArray(Arena, null_renderer, 1);
+
+    Renderer->Log = CreateRenderCommandLog(NullCommandLogCapacity, 1);
+    if (!Renderer->Log)
+    {
+        return Result;
+    }
+
+    Renderer->LastResolution = Resolution;
+    Renderer->NextTexture    = 1;
+
+    Result.Value[0] = (uint64_t)Renderer;
+    return Result;
+}
+
+static void
+SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_list *RenderPassList)
+{
+    null_renderer *Renderer = NullGetRenderer(HRenderer);
+
+    if(!Renderer || !RenderPassList)
+    {
+        return;
+    }
+
+    Renderer->LastResolution = Resolution;
+
+    NullLockLog(Renderer);
+    LogRenderFrame(Renderer->Log, Resolution, RenderPassList);
+    NullUnlockLog(Renderer);
+
+    // Stats
+    {
+        for (render_pass_node *PassNode = RenderPassList->First; PassNode != 0; PassNode = PassNode->Next)
+        {
+            if (PassNode->Value.Type == RenderPass_UI)
+            {
+                render_pass_params_ui Params = PassNode->Value.Params.UI.Params;
+                for (rect_group_node *Node = Params.First; Node != 0; Node = Node->Next)
+                {
+                    Renderer->SubmittedGroupCount    += 1;
+                    Renderer->SubmittedInstanceCount += Node->BatchList.ByteCount / Node->BatchList.BytesPerInstance;
+                    Renderer->SubmittedByteCount     += Node->BatchList.ByteCount + Node->RunList.ByteCount;
+                }
+            }
+        }
+
+        Renderer->SubmittedFrameCount += 1;
+    }
+
+    // Clear
+    ClearRenderPassList(RenderPassList);
+}
+
+// -----------------------------------------------------------------------------------
+// @Public: Texture API
+
+// Textures have no storage, handles are unique identifiers such that the UI still
+// groups instances by texture exactly as it would with a real backend.
+
+static render_handle
+CreateRenderTexture(uint16_t SizeX, uint16_t SizeY, RenderTexture Type)
+{
+    VOID_ASSERT(SizeX > 0 && SizeY > 0);
+    VOID_ASSERT(Type != RenderTexture::None);
+
+    render_handle Result = RenderHandle(0);
+
+    null_renderer *Backend = NullGetRenderer(RenderState.Renderer);
+    VOID_ASSERT(Backend);
+
+    if(Backend)
+    {
+        NullLockLog(Backend);
+        Result = RenderHandle(Backend->NextTexture++);
+        LogRenderTexture(Backend->Log, Result, SizeX, SizeY, Type);
+        NullUnlockLog(Backend);
+    }
+
+    return Result;
+}
+
+static render_handle
+CreateRenderTextureView(render_handle TextureHandle, RenderTexture Type)
+{
+    VOID_UNUSED(Type);
+
+    render_handle Result = TextureHandle;
+    return Result;
+}
+
+// -----------------------------------------------------------------------------------
+// @Public: Null API
+
+static render_command_log *
+NullGetCommandLog(render_handle HRenderer)
+{
+    render_command_log *Result   = 0;
+    null_renderer      *Renderer = NullGetRenderer(HRenderer);
+
+    if (Renderer)
+    {
+        Result = Renderer->Log;
+    }
+
+    return Result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// [Core Types]
+
+// The null renderer implements the per-renderer API without a GPU. Submitted pass lists
+// are recorded in a render_command_log instead of being drawn, which lets the full
+// UI -> render path run headless (benchmarks, CI) and frames be captured for replay.
+
+typedef struct null_renderer
+{
+    render_command_log *Log;
+    uint32_t volatile   LogLock;     // Textures are created on the main thread, frames may be submitted from the render thread
+    vec2_int            LastResolution;
+    uint64_t            NextTexture;
+
+    // Stats
+    uint64_t SubmittedFrameCount;
+    uint64_t SubmittedGroupCount;
+    uint64_t SubmittedInstanceCount;
+    uint64_t SubmittedByteCount;
+} null_renderer;
+
+// [Globals]
+
+const static uint64_t NullCommandLogCapacity = VOID_MEGABYTE(256);
+
+// [API]
+
+static render_command_log * NullGetCommandLog  (render_handle HRenderer);
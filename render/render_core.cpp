@@ -88,23 +88,908 @@ GetRenderPass(memory_arena *Arena,  RenderPass_Type Type)
 static bool
 CanMergeRectGroupParams(rect_group_params *Old, rect_group_params *New)
 {
+    // Rects and glyphs are different instance streams.
+    if (Old->Type != New->Type)
+    {
+        return 0;
+    }
+
     // If the old value had some texture and it is not the same, then we can't merge.
     if (IsValidRenderHandle(Old->Texture) && !RenderHandleMatches(Old->Texture, New->Texture))
     {
         return 0;
     }
 
-    // If the old value has a different transform, then we can't merge.
-    if (!Mat3x3AreEqual(&Old->Transform, &New->Transform))
+    // Clips and transforms live in the clip table, they never prevent a merge.
+
+    return 1;
+}
+
+static uint32_t
+GetGlyphRunCount(rect_group_node *Group)
+{
+    uint32_t Result = 0;
+
+    if (Group->RunList.BytesPerInstance)
     {
-        return 0;
+        Result = (uint32_t)(Group->RunList.ByteCount / Group->RunList.BytesPerInstance);
+    }
+
+    return Result;
+}
+
+// Runs are indexed by glyphs, backends flatten the run list before expanding them.
+
+static void
+GatherGlyphRuns(rect_group_node *Group, render_glyph_run *Runs)
+{
+    uint8_t *WritePointer = (uint8_t *)Runs;
+
+    for (render_batch_node *Batch = Group->RunList.First; Batch != 0; Batch = Batch->Next)
+    {
+        MemoryCopy(WritePointer, Batch->Value.Memory, Batch->Value.ByteCount);
+        WritePointer += Batch->Value.ByteCount;
+    }
+}
+
+// [Textures]
+
+static void
+PushRenderTextureUpdate(memory_arena *Arena, render_handle Texture, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, void *Pixels, uint32_t Pitch)
+{
+    VOID_ASSERT(Arena && Pixels);
+
+    if (!IsValidRenderHandle(Texture) || Width == 0 || Height == 0)
+    {
+        return;
+    }
+
+    render_pass_list           *List = &RenderState.PassList;
+    render_texture_update_node *Node = PushStruct(Arena, render_texture_update_node);
+
+    Node->Value.Texture = Texture;
+    Node->Value.X       = X;
+    Node->Value.Y       = Y;
+    Node->Value.Width   = Width;
+    Node->Value.Height  = Height;
+    Node->Value.Pitch   = Pitch;
+    Node->Value.Pixels  = PushArrayNoZero(Arena, uint8_t, (uint64_t)Pitch * Height);
+    MemoryCopy(Node->Value.Pixels, Pixels, (uint64_t)Pitch * Height);
+
+    if (!List->FirstUpdate)
+    {
+        List->FirstUpdate = Node;
+    }
+
+    if (List->LastUpdate)
+    {
+        List->LastUpdate->Next = Node;
+    }
+
+    List->LastUpdate = Node;
+}
+
+static void
+ClearRenderPassList(render_pass_list *List)
+{
+    List->First       = 0;
+    List->Last        = 0;
+    List->FirstUpdate = 0;
+    List->LastUpdate  = 0;
+
+    MarkRenderDamageFull(List);
+}
+
+// [Damage]
+
+static void
+BeginRenderDamage(render_pass_list *List)
+{
+    List->Damage.Count = 0;
+    List->Damage.Full  = false;
+}
+
+// Overlapping rects are merged on push. Once the list is full, the rect is merged into the
+// entry that grows the least, damage only ever over-estimates.
+
+static void
+PushRenderDamage(render_pass_list *List, rect_float Rect)
+{
+    render_damage *Damage = &List->Damage;
+
+    if (Damage->Full || Rect.Right <= Rect.Left || Rect.Bottom <= Rect.Top)
+    {
+        return;
+    }
+
+    uint32_t MergeIndex = Damage->Count;
+    float    MergeCost  = 0.f;
+
+    for (uint32_t Idx = 0; Idx < Damage->Count; ++Idx)
+    {
+        rect_float Entry = Damage->Rects[Idx];
+        rect_float Union = {Min(Entry.Left, Rect.Left), Min(Entry.Top, Rect.Top), Max(Entry.Right, Rect.Right), Max(Entry.Bottom, Rect.Bottom)};
+
+        float Growth = (Union.Right - Union.Left) * (Union.Bottom - Union.Top) - (Entry.Right - Entry.Left) * (Entry.Bottom - Entry.Top);
+
+        if (Entry.IsIntersecting(Rect))
+        {
+            MergeIndex = Idx;
+            break;
+        }
+
+        if (Damage->Count == RenderConstant_DamageCapacity && (MergeIndex == Damage->Count || Growth < MergeCost))
+        {
+            MergeIndex = Idx;
+            MergeCost  = Growth;
+        }
+    }
+
+    if (MergeIndex < Damage->Count)
+    {
+        rect_float *Entry = &Damage->Rects[MergeIndex];
+        Entry->Left   = Min(Entry->Left  , Rect.Left  );
+        Entry->Top    = Min(Entry->Top   , Rect.Top   );
+        Entry->Right  = Max(Entry->Right , Rect.Right );
+        Entry->Bottom = Max(Entry->Bottom, Rect.Bottom);
+    }
+    else
+    {
+        Damage->Rects[Damage->Count++] = Rect;
+    }
+}
+
+static void
+MarkRenderDamageFull(render_pass_list *List)
+{
+    List->Damage.Count = 0;
+    List->Damage.Full  = true;
+}
+
+// [Frames]
+
+static render_frame *
+GetRenderFrame(render_frame_queue *Queue, uint32_t Count)
+{
+    render_frame *Result = &Queue->Frames[Count % RenderConstant_FrameCount];
+    return Result;
+}
+
+// The consumer side. Submission stats are only written here, the overlap is measured
+// against the frame the main thread is building when the submission ends. EndRenderFrame
+// measures the other half, a build that ends during a submission, such that each side
+// writes its own counter.
+
+static void
+RenderThreadProc(void *Data)
+{
+    render_frame_queue *Queue = (render_frame_queue *)Data;
+
+    for (;;)
+    {
+        OSWaitSemaphore(Queue->FrameReady);
+
+        render_frame *Frame = GetRenderFrame(Queue, Queue->ReadCount);
+
+        uint64_t SubmitBegin = OSReadTimer();
+        Queue->ConsumerSubmitBegin = SubmitBegin;
+
+        SubmitRenderCommands(RenderState.Renderer, Frame->Resolution, &Frame->PassList);
+
+        uint64_t SubmitEnd  = OSReadTimer();
+        uint64_t BuildBegin = Queue->ProducerBuildBegin;
+        Queue->ConsumerSubmitBegin = 0;
+
+        Queue->Stats.SubmitTicks += SubmitEnd - SubmitBegin;
+        if (BuildBegin && BuildBegin < SubmitEnd)
+        {
+            Queue->Stats.OverlapTicks += SubmitEnd - Max(BuildBegin, SubmitBegin);
+        }
+
+        OSCompletePreviousWrites();
+        OSAtomicIncrement32(&Queue->ReadCount);
+        OSSignalSemaphore(Queue->FrameFree);
+    }
+}
+
+static bool
+StartRenderThread(void)
+{
+    render_frame_queue *Queue = &RenderState.FrameQueue;
+    VOID_ASSERT(!Queue->Threaded && !Queue->Building);
+
+    Queue->FrameReady = OSCreateSemaphore(0, RenderConstant_FrameCount);
+    Queue->FrameFree  = OSCreateSemaphore(RenderConstant_FrameCount, RenderConstant_FrameCount);
+
+    if (OSIsValidHandle(Queue->FrameReady) && OSIsValidHandle(Queue->FrameFree))
+    {
+        Queue->Threaded = OSCreateThread(RenderThreadProc, Queue);
+    }
+
+    bool Result = Queue->Threaded;
+    return Result;
+}
+
+static memory_arena *
+BeginRenderFrame(vec2_int Resolution)
+{
+    render_frame_queue *Queue = &RenderState.FrameQueue;
+    VOID_ASSERT(!Queue->Building);
+
+    // Owning a FrameFree count guarantees the render thread is done with this slot.
+    if (Queue->Threaded)
+    {
+        uint64_t WaitBegin = OSReadTimer();
+        OSWaitSemaphore(Queue->FrameFree);
+        Queue->Stats.WaitTicks += OSReadTimer() - WaitBegin;
+    }
+
+    render_frame *Frame = GetRenderFrame(Queue, Queue->WriteCount);
+    if (!Frame->Arena)
+    {
+        Frame->Arena = AllocateArena({});
+        VOID_ASSERT(Frame->Arena);
+    }
+
+    PopArenaTo(Frame->Arena, 0);
+
+    Frame->Resolution = Resolution;
+    Frame->BuildBegin = OSReadTimer();
+
+    Queue->ProducerBuildBegin = Frame->BuildBegin;
+    Queue->Building           = true;
+
+    memory_arena *Result = Frame->Arena;
+    return Result;
+}
+
+static void
+EndRenderFrame(bool Submit)
+{
+    render_frame_queue *Queue = &RenderState.FrameQueue;
+    render_frame       *Frame = GetRenderFrame(Queue, Queue->WriteCount);
+    VOID_ASSERT(Queue->Building);
+
+    Frame->BuildEnd           = OSReadTimer();
+    Queue->ProducerBuildBegin = 0;
+    Queue->Building           = false;
+    Queue->Stats.BuildTicks  += Frame->BuildEnd - Frame->BuildBegin;
+
+    uint64_t SubmitBegin = Queue->ConsumerSubmitBegin;
+    if (SubmitBegin && SubmitBegin < Frame->BuildEnd)
+    {
+        Queue->Stats.BuildOverlapTicks += Frame->BuildEnd - Max(Frame->BuildBegin, SubmitBegin);
+    }
+
+    if (!Submit)
+    {
+        ClearRenderPassList(&RenderState.PassList);
+        Queue->Stats.DiscardedCount += 1;
+
+        if (Queue->Threaded)
+        {
+            OSSignalSemaphore(Queue->FrameFree);
+        }
+
+        return;
+    }
+
+    Frame->PassList = RenderState.PassList;
+    ClearRenderPassList(&RenderState.PassList);
+
+    Queue->Stats.PublishedCount += 1;
+
+    if (Queue->Threaded)
+    {
+        // The frame must be fully visible before the consumer can see the new count.
+        OSCompletePreviousWrites();
+
+        uint32_t WriteCount = OSAtomicIncrement32(&Queue->WriteCount);
+        uint32_t Depth      = WriteCount - Queue->ReadCount;
+
+        Queue->Stats.QueueDepth    = Depth;
+        Queue->Stats.MaxQueueDepth = Max(Queue->Stats.MaxQueueDepth, Depth);
+
+        ProfileCounter("Render Queue Depth", Depth);
+
+        OSSignalSemaphore(Queue->FrameReady);
+    }
+    else
+    {
+        uint64_t SubmitBegin = OSReadTimer();
+        SubmitRenderCommands(RenderState.Renderer, Frame->Resolution, &Frame->PassList);
+        Queue->Stats.SubmitTicks += OSReadTimer() - SubmitBegin;
+
+        // Single writer, volatile counters are stored instead of incremented.
+        uint32_t WriteCount = Queue->WriteCount + 1;
+
+        Queue->WriteCount = WriteCount;
+        Queue->ReadCount  = WriteCount;
+    }
+}
+
+// The render thread writes the submission stats concurrently, values may be one frame
+// apart from each other.
+
+static render_frame_stats
+GetRenderFrameStats(void)
+{
+    render_frame_stats Result = RenderState.FrameQueue.Stats;
+    return Result;
+}
+
+// Samples the totals into the profiler counters, times are in microseconds. The overlap is
+// the time during which a frame was built while another was submitted, its share is of the
+// build time. Both are 0 when frames are submitted inline.
+
+static void
+ProfileRenderFrameStats(void)
+{
+    render_frame_stats Stats     = GetRenderFrameStats();
+    uint64_t           Frequency = OSGetTimerFrequency();
+
+    if (Frequency)
+    {
+        ProfileCounter("Render Frames Published", Stats.PublishedCount);
+        ProfileCounter("Render Frames Discarded", Stats.DiscardedCount);
+        ProfileCounter("Render Max Queue Depth" , Stats.MaxQueueDepth);
+        ProfileCounter("Render Build us"        , Stats.BuildTicks   * 1000000 / Frequency);
+        ProfileCounter("Render Submit us"       , Stats.SubmitTicks  * 1000000 / Frequency);
+        ProfileCounter("Render Wait us"         , Stats.WaitTicks    * 1000000 / Frequency);
+        ProfileCounter("Render Overlap us"      , (Stats.OverlapTicks + Stats.BuildOverlapTicks) * 1000000 / Frequency);
+        ProfileCounter("Render Overlap %"       , Stats.BuildTicks ? (Stats.OverlapTicks + Stats.BuildOverlapTicks) * 100 / Stats.BuildTicks : 0);
+    }
+}
+
+static memory_arena *
+GetRenderFrameArena(void)
+{
+    render_frame_queue *Queue  = &RenderState.FrameQueue;
+    memory_arena       *Result = 0;
+
+    if (Queue->Building)
+    {
+        Result = GetRenderFrame(Queue, Queue->WriteCount)->Arena;
+    }
+
+    return Result;
+}
+
+// [Clips]
+
+static uint32_t *
+FindRectClipSlot(rect_clip_table *Table, rect_clip_params *Params)
+{
+    uint32_t Mask = Table->HashSlotCount - 1;
+    uint32_t Slot = (uint32_t)XXH3_64bits(Params, sizeof(rect_clip_params)) & Mask;
+
+    while (Table->HashSlots[Slot])
+    {
+        rect_clip_params *Entry = &Table->Entries[Table->HashSlots[Slot] - 1];
+        if (MemoryCompare(Entry, Params, sizeof(rect_clip_params)) == 0)
+        {
+            break;
+        }
+
+        Slot = (Slot + 1) & Mask;
+    }
+
+    uint32_t *Result = &Table->HashSlots[Slot];
+    return Result;
+}
+
+// Moves the entries to a table of Capacity entries and hashes them again. Also used on
+// tables which were filled without hashing (replayed frames).
+
+static void
+ResizeRectClipTable(memory_arena *Arena, rect_clip_table *Table, uint32_t Capacity)
+{
+    VOID_ASSERT(Capacity >= Table->Count && VOID_ISPOWEROFTWO(Capacity));
+
+    rect_clip_params *Entries = PushArray(Arena, rect_clip_params, Capacity);
+    MemoryCopy(Entries, Table->Entries, Table->Count * sizeof(rect_clip_params));
+
+    Table->Entries       = Entries;
+    Table->Capacity      = Capacity;
+    Table->HashSlotCount = Capacity * 2;
+    Table->HashSlots     = PushArray(Arena, uint32_t, Table->HashSlotCount);
+
+    for (uint32_t Idx = 0; Idx < Table->Count; ++Idx)
+    {
+        uint32_t *Slot = FindRectClipSlot(Table, &Table->Entries[Idx]);
+        if (!Slot[0])
+        {
+            Slot[0] = Idx + 1;
+        }
+    }
+}
+
+static uint32_t
+PushRectClip(memory_arena *Arena, rect_clip_table *Table, matrix_3x3 Transform, rect_float Clip)
+{
+    VOID_ASSERT(Arena && Table);
+
+    if (!Table->Entries)
+    {
+        Table->Entries  = PushArray(Arena, rect_clip_params, RectClipTableCapacity);
+        Table->Capacity = RectClipTableCapacity;
+        Table->Count    = 1;
+
+        Table->Entries[0].Transform = Mat3x3Identity();
+        Table->Entries[0].Clip      = {};
+    }
+
+    if (!Table->HashSlots)
+    {
+        uint32_t Capacity = RectClipTableCapacity;
+        while (Capacity < Table->Count)
+        {
+            Capacity *= 2;
+        }
+
+        ResizeRectClipTable(Arena, Table, Capacity);
     }
 
-    // If the clip is different, then we can't merge.
-    if(MemoryCompare(&Old->Clip, &New->Clip, sizeof(rect_float)) != 0)
+    rect_clip_params Params = {.Transform = Transform, .Clip = Clip};
+
+    // Commands are emitted in tree order, so consecutive rects mostly share the same clip.
+    // The last entry is checked before hashing.
+
+    uint32_t Last = Table->Count - 1;
+    if (MemoryCompare(&Table->Entries[Last], &Params, sizeof(rect_clip_params)) == 0)
+    {
+        return Last;
+    }
+
+    uint32_t *Slot = FindRectClipSlot(Table, &Params);
+    if (Slot[0])
+    {
+        return Slot[0] - 1;
+    }
+
+    if (Table->Count == Table->Capacity)
+    {
+        ResizeRectClipTable(Arena, Table, Table->Capacity * 2);
+        Slot = FindRectClipSlot(Table, &Params);
+    }
+
+    uint32_t Result = Table->Count++;
+    Table->Entries[Result] = Params;
+    Slot[0]                = Result + 1;
+
+    return Result;
+}
+
+// ------------------------------------------------------------------------------------
+// @Internal : Command Log
+
+static void *
+PushRenderLogBytes(render_command_log *Log, uint64_t Size)
+{
+    void *Result = 0;
+
+    // The log must stay contiguous, so we never let the arena chain a new block.
+    memory_arena *Arena = Log->Arena;
+    if (!Log->Overflowed && GetArenaPosition(Arena) + Size <= Arena->Reserved)
+    {
+        Result = PushArena(Arena, Size, 1);
+    }
+
+    if (Result)
+    {
+        Log->Size += Size;
+    }
+    else
+    {
+        Log->Overflowed = 1;
+    }
+
+    return Result;
+}
+
+static void *
+PushRenderLogRecord(render_command_log *Log, RenderLog_Type Type, uint64_t PayloadSize)
+{
+    void *Result = 0;
+
+    render_log_record *Record = (render_log_record *)PushRenderLogBytes(Log, sizeof(render_log_record) + PayloadSize);
+    if (Record)
+    {
+        Record->Type = Type;
+        Record->Size = (uint32_t)PayloadSize;
+
+        Result = Record + 1;
+    }
+
+    return Result;
+}
+
+static render_command_log *
+CreateRenderCommandLog(uint64_t Capacity, bool RecordInstances)
+{
+    memory_arena_params Params = {};
+    Params.ReserveSize       = Capacity;
+    Params.CommitSize        = VOID_KILOBYTE(64);
+    Params.AllocatedFromFile = __FILE__;
+    Params.AllocatedFromLine = __LINE__;
+
+    memory_arena *Arena = AllocateArena(Params);
+
+    render_command_log *Result = PushStruct(Arena, render_command_log);
+    Result->Arena           = Arena;
+    Result->RecordInstances = RecordInstances;
+
+    ResetRenderCommandLog(Result);
+
+    return Result;
+}
+
+static void
+ResetRenderCommandLog(render_command_log *Log)
+{
+    VOID_ASSERT(Log);
+
+    uint64_t Start = sizeof(memory_arena) + sizeof(render_command_log);
+    PopArenaTo(Log->Arena, AlignPow2(Start, 8));
+
+    Log->Size       = 0;
+    Log->FrameCount = 0;
+    Log->Overflowed = 0;
+
+    render_log_header *Header = (render_log_header *)PushRenderLogBytes(Log, sizeof(render_log_header));
+    Header->Magic   = RenderLogMagic;
+    Header->Version = RenderLogVersion;
+
+    Log->Base = (uint8_t *)Header;
+}
+
+static byte_string
+GetRenderCommandLogData(render_command_log *Log)
+{
+    byte_string Result = ByteString(Log->Base, Log->Size);
+    return Result;
+}
+
+static void
+LogRenderTexture(render_command_log *Log, render_handle Texture, uint16_t SizeX, uint16_t SizeY, RenderTexture Type)
+{
+    VOID_ASSERT(Log);
+
+    render_log_texture *Payload = (render_log_texture *)PushRenderLogRecord(Log, RenderLog_Texture, sizeof(render_log_texture));
+    if (Payload)
+    {
+        Payload->Texture = Texture.Value[0];
+        Payload->SizeX   = SizeX;
+        Payload->SizeY   = SizeY;
+        Payload->Format  = (uint32_t)Type;
+    }
+}
+
+static void
+LogRenderFrame(render_command_log *Log, vec2_int Resolution, render_pass_list *PassList)
+{
+    VOID_ASSERT(Log && PassList);
+
+    // Updates are applied before the passes, so they are logged before the frame.
+    for (render_texture_update_node *Node = PassList->FirstUpdate; Node != 0; Node = Node->Next)
+    {
+        render_texture_update *Update    = &Node->Value;
+        uint64_t               PixelSize = (uint64_t)Update->Pitch * Update->Height;
+
+        render_log_update *LogUpdate = (render_log_update *)PushRenderLogRecord(Log, RenderLog_Update, sizeof(render_log_update) + PixelSize);
+        if (!LogUpdate)
+        {
+            return;
+        }
+
+        LogUpdate->Texture = Update->Texture.Value[0];
+        LogUpdate->X       = Update->X;
+        LogUpdate->Y       = Update->Y;
+        LogUpdate->Width   = Update->Width;
+        LogUpdate->Height  = Update->Height;
+        LogUpdate->Pitch   = Update->Pitch;
+        MemoryCopy(LogUpdate + 1, Update->Pixels, PixelSize);
+    }
+
+    render_log_frame *Frame = (render_log_frame *)PushRenderLogRecord(Log, RenderLog_Frame, sizeof(render_log_frame));
+    if (!Frame)
+    {
+        return;
+    }
+
+    Frame->Index       = Log->FrameCount++;
+    Frame->ResolutionX = Resolution.X;
+    Frame->ResolutionY = Resolution.Y;
+    Frame->PassCount   = 0;
+
+    for (render_pass_node *PassNode = PassList->First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        render_pass *Pass = &PassNode->Value;
+
+        switch (Pass->Type)
+        {
+
+        case RenderPass_UI:
+        {
+            render_pass_params_ui *Params    = &Pass->Params.UI.Params;
+            rect_clip_table       *ClipTable = &Params->ClipTable;
+            uint64_t               ClipSize  = ClipTable->Count * sizeof(rect_clip_params);
+
+            render_log_pass *LogPass = (render_log_pass *)PushRenderLogRecord(Log, RenderLog_Pass, sizeof(render_log_pass) + ClipSize);
+            if (!LogPass)
+            {
+                return;
+            }
+
+            LogPass->Type       = Pass->Type;
+            LogPass->GroupCount = Params->Count;
+            LogPass->ClipCount  = ClipTable->Count;
+            MemoryCopy(LogPass + 1, ClipTable->Entries, ClipSize);
+
+            for (rect_group_node *Node = Params->First; Node != 0; Node = Node->Next)
+            {
+                render_batch_list *BatchList    = &Node->BatchList;
+                uint64_t           InstanceSize = Log->RecordInstances ? BatchList->ByteCount    : 0;
+                uint64_t           RunSize      = Log->RecordInstances ? Node->RunList.ByteCount : 0;
+
+                render_log_group *Group = (render_log_group *)PushRenderLogRecord(Log, RenderLog_Group, sizeof(render_log_group) + InstanceSize + RunSize);
+                if (!Group)
+                {
+                    return;
+                }
+
+                Group->Texture          = Node->Params.Texture.Value[0];
+                Group->TextureSizeX     = Node->Params.TextureSize.X;
+                Group->TextureSizeY     = Node->Params.TextureSize.Y;
+                Group->BytesPerInstance = (uint32_t)BatchList->BytesPerInstance;
+                Group->InstanceCount    = (uint32_t)(BatchList->ByteCount / BatchList->BytesPerInstance);
+                Group->HasInstances     = Log->RecordInstances;
+                Group->Type             = Node->Params.Type;
+                Group->RunCount         = GetGlyphRunCount(Node);
+
+                uint8_t *WritePointer = (uint8_t *)(Group + 1);
+                for (render_batch_node *Batch = BatchList->First; Batch != 0 && InstanceSize; Batch = Batch->Next)
+                {
+                    MemoryCopy(WritePointer, Batch->Value.Memory, Batch->Value.ByteCount);
+                    WritePointer += Batch->Value.ByteCount;
+                }
+
+                if (RunSize)
+                {
+                    GatherGlyphRuns(Node, (render_glyph_run *)WritePointer);
+                }
+            }
+
+            Frame->PassCount += 1;
+        } break;
+
+        default: break;
+
+        }
+    }
+}
+
+// Decodes the next frame at Offset into PassList, including the texture updates that
+// precede it. Texture creation records are skipped. Texture handles are the ones of the
+// recording session, the caller is responsible for remapping them. Returns 0 at the end
+// of the log or on malformed data.
+
+static bool
+ReplayRenderFrame(byte_string Data, uint64_t *Offset, memory_arena *Arena, vec2_int *Resolution, render_pass_list *PassList)
+{
+    VOID_ASSERT(Offset && Arena && Resolution && PassList);
+
+    uint64_t At = *Offset;
+
+    if (At == 0)
+    {
+        render_log_header *Header = (render_log_header *)Data.String;
+        if (Data.Size < sizeof(render_log_header) || Header->Magic != RenderLogMagic || Header->Version != RenderLogVersion)
+        {
+            return 0;
+        }
+
+        At = sizeof(render_log_header);
+    }
+
+    ClearRenderPassList(PassList);
+
+    render_log_frame *Frame = 0;
+    while (!Frame && At + sizeof(render_log_record) <= Data.Size)
+    {
+        render_log_record *Record = (render_log_record *)(Data.String + At);
+        if (At + sizeof(render_log_record) + Record->Size > Data.Size)
+        {
+            return 0;
+        }
+
+        if (Record->Type == RenderLog_Frame)
+        {
+            if (Record->Size < sizeof(render_log_frame))
+            {
+                return 0;
+            }
+
+            Frame = (render_log_frame *)(Record + 1);
+        } else
+        if (Record->Type == RenderLog_Update)
+        {
+            if (Record->Size < sizeof(render_log_update))
+            {
+                return 0;
+            }
+
+            render_log_update *LogUpdate = (render_log_update *)(Record + 1);
+            uint64_t           PixelSize = (uint64_t)LogUpdate->Pitch * LogUpdate->Height;
+
+            if (sizeof(render_log_update) + PixelSize > Record->Size)
+            {
+                return 0;
+            }
+
+            render_texture_update_node *Node = PushStruct(Arena, render_texture_update_node);
+
+            Node->Value.Texture = RenderHandle(LogUpdate->Texture);
+            Node->Value.X       = LogUpdate->X;
+            Node->Value.Y       = LogUpdate->Y;
+            Node->Value.Width   = LogUpdate->Width;
+            Node->Value.Height  = LogUpdate->Height;
+            Node->Value.Pitch   = LogUpdate->Pitch;
+            Node->Value.Pixels  = PushArrayNoZero(Arena, uint8_t, PixelSize);
+            MemoryCopy(Node->Value.Pixels, LogUpdate + 1, PixelSize);
+
+            if (!PassList->FirstUpdate)
+            {
+                PassList->FirstUpdate = Node;
+            }
+
+            if (PassList->LastUpdate)
+            {
+                PassList->LastUpdate->Next = Node;
+            }
+
+            PassList->LastUpdate = Node;
+        }
+
+        At += sizeof(render_log_record) + Record->Size;
+    }
+
+    if (!Frame)
     {
         return 0;
     }
 
+    *Resolution = vec2_int(Frame->ResolutionX, Frame->ResolutionY);
+
+    for (uint32_t PassIdx = 0; PassIdx < Frame->PassCount; ++PassIdx)
+    {
+        render_log_record *Record = (render_log_record *)(Data.String + At);
+        if (At + sizeof(render_log_record) > Data.Size || Record->Type != RenderLog_Pass)
+        {
+            return 0;
+        }
+
+        At += sizeof(render_log_record) + Record->Size;
+        if (At > Data.Size)
+        {
+            return 0;
+        }
+
+        render_log_pass  *LogPass  = (render_log_pass *)(Record + 1);
+        if (Record->Size < sizeof(render_log_pass) || sizeof(render_log_pass) + (uint64_t)LogPass->ClipCount * sizeof(rect_clip_params) > Record->Size)
+        {
+            return 0;
+        }
+
+        render_pass_node *PassNode = PushStruct(Arena, render_pass_node);
+        PassNode->Value.Type = (RenderPass_Type)LogPass->Type;
+
+        if (!PassList->First)
+        {
+            PassList->First = PassNode;
+        }
+
+        if (PassList->Last)
+        {
+            PassList->Last->Next = PassNode;
+        }
+
+        PassList->Last = PassNode;
+
+        render_pass_params_ui *Params = &PassNode->Value.Params.UI.Params;
+        render_pass_ui_stats  *Stats  = &PassNode->Value.Params.UI.Stats;
+
+        if (LogPass->ClipCount)
+        {
+            Params->ClipTable.Entries  = PushArray(Arena, rect_clip_params, LogPass->ClipCount);
+            Params->ClipTable.Count    = LogPass->ClipCount;
+            Params->ClipTable.Capacity = LogPass->ClipCount;
+            MemoryCopy(Params->ClipTable.Entries, LogPass + 1, Params->ClipTable.Count * sizeof(rect_clip_params));
+        }
+
+        for (uint32_t GroupIdx = 0; GroupIdx < LogPass->GroupCount; ++GroupIdx)
+        {
+            render_log_record *GroupRecord = (render_log_record *)(Data.String + At);
+            if (At + sizeof(render_log_record) > Data.Size || GroupRecord->Type != RenderLog_Group)
+            {
+                return 0;
+            }
+
+            At += sizeof(render_log_record) + GroupRecord->Size;
+            if (At > Data.Size)
+            {
+                return 0;
+            }
+
+            if (GroupRecord->Size < sizeof(render_log_group))
+            {
+                return 0;
+            }
+
+            render_log_group *Group    = (render_log_group *)(GroupRecord + 1);
+            uint64_t          ByteSize = (uint64_t)Group->InstanceCount * Group->BytesPerInstance;
+            uint64_t          RunSize  = (uint64_t)Group->RunCount      * sizeof(render_glyph_run);
+
+            if (Group->HasInstances && sizeof(render_log_group) + ByteSize + RunSize > GroupRecord->Size)
+            {
+                return 0;
+            }
+
+            if (Group->HasInstances && Group->InstanceCount && (!Group->BytesPerInstance || Group->BytesPerInstance > VOID_KILOBYTE(5)))
+            {
+                return 0;
+            }
+
+            rect_group_node *Node = PushStruct(Arena, rect_group_node);
+            Node->Params.Texture             = RenderHandle(Group->Texture);
+            Node->Params.TextureSize.X       = Group->TextureSizeX;
+            Node->Params.TextureSize.Y       = Group->TextureSizeY;
+            Node->Params.Type                = (RectGroup_Type)Group->Type;
+            Node->BatchList.BytesPerInstance = Group->BytesPerInstance;
+            Node->RunList.BytesPerInstance   = sizeof(render_glyph_run);
+
+            // Instances are pushed one by one such that the batches have the shape of live
+            // ones, backends size their uploads for those.
+
+            if (Group->HasInstances && ByteSize)
+            {
+                uint8_t *Instances = (uint8_t *)(Group + 1);
+
+                for (uint32_t Idx = 0; Idx < Group->InstanceCount; ++Idx)
+                {
+                    void *Instance = PushDataInBatchList(Arena, &Node->BatchList);
+                    MemoryCopy(Instance, Instances + Idx * Group->BytesPerInstance, Group->BytesPerInstance);
+                }
+
+                Stats->BatchCount       += Node->BatchList.BatchCount;
+                Stats->RenderedDataSize += ByteSize;
+            }
+
+            if (Group->HasInstances && RunSize)
+            {
+                render_batch_node *Batch = PushStruct(Arena, render_batch_node);
+                Batch->Value.Memory       = PushArrayNoZero(Arena, uint8_t, RunSize);
+                Batch->Value.ByteCount    = RunSize;
+                Batch->Value.ByteCapacity = RunSize;
+                MemoryCopy(Batch->Value.Memory, (uint8_t *)(Group + 1) + ByteSize, RunSize);
+
+                Node->RunList.First      = Batch;
+                Node->RunList.Last       = Batch;
+                Node->RunList.BatchCount = 1;
+                Node->RunList.ByteCount  = RunSize;
+
+                Stats->RenderedDataSize += RunSize;
+            }
+
+            AppendToLinkedList(Params, Node, Params->Count);
+
+            Stats->GroupCount += 1;
+        }
+
+        Stats->PassCount += 1;
+    }
+
+    *Offset = At;
+
     return 1;
 }
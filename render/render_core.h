@@ -2,8 +2,10 @@
 
 typedef enum Renderer_Backend
 {
-    Renderer_None  = 0,
-    Renderer_D3D11 = 1,
+    Renderer_None     = 0,
+    Renderer_D3D11    = 1,
+    Renderer_Null     = 2,
+    Renderer_Software = 3,
 } Renderer_Backend;
 
 typedef enum RenderPass_Type
@@ -13,6 +15,12 @@ typedef enum RenderPass_Type
     RenderPass_Count = 1,
 } RenderPass_Type;
 
+typedef enum RenderConstant_Type
+{
+    RenderConstant_DamageCapacity = 16,
+    RenderConstant_FrameCount     = 3,     // One being built, one queued, one being submitted
+} RenderConstant_Type;
+
 typedef struct render_handle
 {
     uint64_t Value[1];
@@ -50,14 +58,71 @@ typedef struct render_batch_list
 // Specific parameters that must be set by the rendering 
 // backend before drawing the corresponding batch.
 
+typedef enum RectGroup_Type
+{
+    RectGroup_Rects  = 0,
+    RectGroup_Glyphs = 1,
+} RectGroup_Type;
+
 typedef struct rect_group_params
 {
-    vec2_uint16   TextureSize;
-    render_handle Texture;
-    matrix_3x3    Transform;
-    rect_float    Clip;
+    vec2_uint16    TextureSize;
+    render_handle  Texture;
+    RectGroup_Type Type;
 } rect_group_params;
 
+// Glyph Types
+// Text is submitted as glyph runs instead of rects. A run holds what every glyph of a label
+// shares and glyphs only carry their offset from the run origin and their atlas source,
+// which is drawn Scale times its size. Backends expand glyphs to quads themselves. A glyph
+// group references at most GlyphRunCapacity runs.
+//
+// Sharpness is 0 when the atlas holds coverage. Otherwise it holds signed distances where
+// 0.5 is the outline and coverage is saturate((Texel - 0.5) * Sharpness + 0.5).
+
+typedef struct render_glyph_run
+{
+    vec2_float Origin;
+    uint32_t   Color;        // RGBA8, R in the low byte
+    uint32_t   ClipIndex;
+    float      Scale;
+    float      Sharpness;
+} render_glyph_run;
+
+typedef struct render_glyph
+{
+    int16_t  OffsetX;
+    int16_t  OffsetY;
+    uint16_t SourceX;
+    uint16_t SourceY;
+    uint16_t SourceWidth;
+    uint16_t SourceHeight;
+    uint32_t RunIndex;       // In the run list of the group
+} render_glyph;
+
+// Clip Types
+// Clips and transforms are stored once per pass in a table and each instance
+// references an entry by index. Changing them does not break batches. Entry 0
+// is always the identity transform with no clip.
+
+typedef struct rect_clip_params
+{
+    matrix_3x3 Transform;
+    rect_float Clip;
+} rect_clip_params;
+
+// Entries are deduplicated through an open addressed hash table of entry indices plus one,
+// twice the capacity. A full table doubles, backends grow their clip buffer to match.
+
+typedef struct rect_clip_table
+{
+    rect_clip_params *Entries;
+    uint32_t          Count;
+    uint32_t          Capacity;
+    uint32_t         *HashSlots;
+    uint32_t          HashSlotCount;
+} rect_clip_table;
+
 // Group Types
 // Group are logical grouping of batches as well as specific
 // parameters that must be set by the rendering backend before
@@ -67,7 +132,8 @@ typedef struct rect_group_node rect_group_node;
 struct rect_group_node
 {
     rect_group_node  *Next;
-    render_batch_list BatchList;
+    render_batch_list BatchList;    // ui_rect, or render_glyph for glyph groups
+    render_batch_list RunList;      // render_glyph_run, glyph groups only
     rect_group_params Params;
 };
 
@@ -78,7 +144,8 @@ typedef struct render_pass_params_ui
 {
     rect_group_node *First;
     rect_group_node *Last;
-    uint32_t              Count;
+    uint32_t         Count;
+    rect_clip_table  ClipTable;
 } render_pass_params_ui;
 
 // Stats Types
@@ -89,6 +156,7 @@ typedef struct render_pass_ui_stats
     uint32_t BatchCount;
     uint32_t GroupCount;
     uint32_t PassCount;
+    uint32_t CulledInstanceCount;   // Instances dropped because a later opaque rect covers them
     uint64_t RenderedDataSize;
 } render_pass_ui_stats;
 
@@ -117,18 +185,103 @@ struct render_pass_node
     render_pass       Value;
 };
 
+// Texture Update Types
+// Pixel uploads are queued with the pass list and applied by the backend before any
+// pass is drawn. Pixels are copied in the frame arena when pushed.
+
+typedef struct render_texture_update
+{
+    render_handle Texture;
+    uint16_t      X;
+    uint16_t      Y;
+    uint16_t      Width;
+    uint16_t      Height;
+    uint32_t      Pitch;
+    uint8_t      *Pixels;
+} render_texture_update;
+
+typedef struct render_texture_update_node render_texture_update_node;
+struct render_texture_update_node
+{
+    render_texture_update_node *Next;
+    render_texture_update       Value;
+};
+
+// Damage Types
+// Pixel regions that changed since the previous submitted frame. Backends which keep their
+// target between frames may only redraw these, others are free to ignore them. A list
+// that is never tracked stays Full, such that a producer unaware of damage is always correct.
+
+typedef struct render_damage
+{
+    rect_float Rects[RenderConstant_DamageCapacity];
+    uint32_t   Count;
+    bool       Full;
+} render_damage;
+
 typedef struct render_pass_list
 {
     render_pass_node *First;
     render_pass_node *Last;
+
+    render_texture_update_node *FirstUpdate;
+    render_texture_update_node *LastUpdate;
+
+    render_damage Damage;
 } render_pass_list;
 
+// Frame Types
+// A frame owns the arena every pass, batch and update it references is allocated from.
+// Frames are built into RenderState.PassList on the main thread and handed to the render
+// thread through a single-producer/single-consumer ring. Slots are only indexed by the two
+// counters, semaphores are used to sleep and never to protect data.
+
+typedef struct render_frame
+{
+    memory_arena     *Arena;
+    render_pass_list  PassList;
+    vec2_int          Resolution;
+
+    // Instrumentation (OSReadTimer ticks)
+    uint64_t          BuildBegin;
+    uint64_t          BuildEnd;
+} render_frame;
+
+typedef struct render_frame_stats
+{
+    uint64_t PublishedCount;
+    uint64_t DiscardedCount;
+    uint32_t QueueDepth;          // Published frames not yet fully submitted, at last publish
+    uint32_t MaxQueueDepth;
+    uint64_t BuildTicks;          // Main thread, BeginRenderFrame -> EndRenderFrame
+    uint64_t SubmitTicks;         // Render thread, inside SubmitRenderCommands
+    uint64_t OverlapTicks;        // Submission time during which the next frame was being built,
+                                  // counted by the render thread when a submission ends
+    uint64_t BuildOverlapTicks;   // Same, counted by the main thread when a build ends
+    uint64_t WaitTicks;           // Main thread blocked on a free slot
+} render_frame_stats;
+
+typedef struct render_frame_queue
+{
+    render_frame       Frames[RenderConstant_FrameCount];
+    uint32_t volatile  WriteCount;          // Written by the producer only
+    uint32_t volatile  ReadCount;           // Written by the consumer only
+    uint64_t volatile  ProducerBuildBegin;  // 0 when no frame is being built
+    uint64_t volatile  ConsumerSubmitBegin; // 0 when no frame is being submitted
+    os_handle          FrameReady;
+    os_handle          FrameFree;
+    bool               Threaded;
+    bool               Building;
+    render_frame_stats Stats;
+} render_frame_queue;
+
 // One of the three globals (GAME, UI, RENDERER)
 
 typedef struct render_state
 {
-    render_handle    Renderer;
-    render_pass_list PassList;
+    render_handle      Renderer;
+    render_pass_list   PassList;
+    render_frame_queue FrameQueue;
 } render_state;
 
 static render_state RenderState;
@@ -140,6 +293,9 @@ const static uint64_t RenderPassDataSizeTable[] =
     128, // Inputs to UI pass (ui_rect)
 };
 
+const static uint32_t RectClipTableCapacity = 256;   // Initial, tables grow
+const static uint32_t GlyphRunCapacity      = 4096;
+
 // [Handles]
 
 static bool          IsValidRenderHandle    (render_handle Handle);
@@ -151,6 +307,9 @@ static bool          RenderHandleMatches    (render_handle H1, render_handle H2)
 static void        * PushDataInBatchList      (memory_arena *Arena, render_batch_list *BatchList);
 static render_pass * GetRenderPass            (memory_arena *Arena, RenderPass_Type Type);
 static bool          CanMergeRectGroupParams  (rect_group_params *Old, rect_group_params *New);
+static uint32_t      PushRectClip             (memory_arena *Arena, rect_clip_table *Table, matrix_3x3 Transform, rect_float Clip);
+static uint32_t      GetGlyphRunCount         (rect_group_node *Group);
+static void          GatherGlyphRuns          (rect_group_node *Group, render_glyph_run *Runs);
 
 // [PER-RENDERER API]
 
@@ -160,11 +319,146 @@ static void          SubmitRenderCommands  (render_handle HRenderer, vec2_int Re
 // ------------------------------------------------------------------------------------
 // @Internal : Textures
 
+// GreyScale is a single 8 bits channel (R8), used for glyph coverage.
+
 enum class RenderTexture
 {
-    None = 0,
-    RGBA = 1,
+    None      = 0,
+    RGBA      = 1,
+    GreyScale = 2,
 };
 
 static render_handle CreateRenderTexture      (uint16_t SizeX, uint16_t SizeY, RenderTexture Type);
 static render_handle CreateRenderTextureView  (render_handle TextureHandle, RenderTexture Type);
+
+static void          PushRenderTextureUpdate  (memory_arena *Arena, render_handle Texture, uint16_t X, uint16_t Y, uint16_t Width, uint16_t Height, void *Pixels, uint32_t Pitch);
+static void          ClearRenderPassList      (render_pass_list *List);
+
+// ------------------------------------------------------------------------------------
+// @Internal : Frames
+//   BeginRenderFrame waits for a free slot and returns the arena render data of the frame
+//   must be allocated from (GetRenderFrameArena returns it too, 0 outside of a frame).
+//   EndRenderFrame publishes RenderState.PassList to the render thread, or submits it
+//   inline when no render thread was started. Passing Submit = 0 drops the frame (nothing
+//   changed) and keeps the slot. ProfileRenderFrameStats samples the queue stats into
+//   the profiler output.
+
+static bool               StartRenderThread      (void);
+static memory_arena     * BeginRenderFrame       (vec2_int Resolution);
+static void               EndRenderFrame         (bool Submit);
+static render_frame_stats GetRenderFrameStats    (void);
+static void               ProfileRenderFrameStats(void);
+static memory_arena     * GetRenderFrameArena    (void);
+
+// ------------------------------------------------------------------------------------
+// @Internal : Damage
+
+static void          BeginRenderDamage        (render_pass_list *List);
+static void          PushRenderDamage         (render_pass_list *List, rect_float Rect);
+static void          MarkRenderDamageFull     (render_pass_list *List);
+
+// ------------------------------------------------------------------------------------
+// @Internal : Command Log
+// A compact binary stream of submitted pass lists. Used by the null backend to run the
+// full UI -> render path without a GPU and to replay captured frames offline.
+//
+// Layout: render_log_header, then every record is a render_log_record followed by Size
+// bytes of payload. A frame is a RenderLog_Frame record followed by its passes, a pass
+// is a RenderLog_Pass record followed by its groups. Textures are logged on creation.
+
+#define RenderLogMagic   0x4C524F56u // 'VORL'
+#define RenderLogVersion 3u
+
+typedef enum RenderLog_Type
+{
+    RenderLog_None    = 0,
+    RenderLog_Frame   = 1,
+    RenderLog_Pass    = 2,
+    RenderLog_Group   = 3,
+    RenderLog_Texture = 4,
+    RenderLog_Update  = 5,
+} RenderLog_Type;
+
+typedef struct render_log_header
+{
+    uint32_t Magic;
+    uint32_t Version;
+} render_log_header;
+
+typedef struct render_log_record
+{
+    uint32_t Type;
+    uint32_t Size;
+} render_log_record;
+
+typedef struct render_log_frame
+{
+    uint64_t Index;
+    int32_t  ResolutionX;
+    int32_t  ResolutionY;
+    uint32_t PassCount;
+    uint32_t _P0;
+} render_log_frame;
+
+// Followed by ClipCount rect_clip_params.
+
+typedef struct render_log_pass
+{
+    uint32_t Type;
+    uint32_t GroupCount;
+    uint32_t ClipCount;
+    uint32_t _P0;
+} render_log_pass;
+
+// Followed by InstanceCount * BytesPerInstance bytes then RunCount render_glyph_run if
+// HasInstances is set.
+
+typedef struct render_log_group
+{
+    uint64_t Texture;
+    uint16_t TextureSizeX;
+    uint16_t TextureSizeY;
+    uint32_t BytesPerInstance;
+    uint32_t InstanceCount;
+    uint32_t HasInstances;
+    uint32_t Type;
+    uint32_t RunCount;
+} render_log_group;
+
+typedef struct render_log_texture
+{
+    uint64_t Texture;
+    uint16_t SizeX;
+    uint16_t SizeY;
+    uint32_t Format;
+} render_log_texture;
+
+// Followed by Pitch * Height bytes of pixels.
+
+typedef struct render_log_update
+{
+    uint64_t Texture;
+    uint16_t X;
+    uint16_t Y;
+    uint16_t Width;
+    uint16_t Height;
+    uint32_t Pitch;
+    uint32_t _P0;
+} render_log_update;
+
+typedef struct render_command_log
+{
+    memory_arena *Arena;
+    uint8_t      *Base;
+    uint64_t      Size;
+    uint64_t      FrameCount;
+    bool          RecordInstances;
+    bool          Overflowed;
+} render_command_log;
+
+static render_command_log * CreateRenderCommandLog   (uint64_t Capacity, bool RecordInstances);
+static void                 ResetRenderCommandLog    (render_command_log *Log);
+static byte_string          GetRenderCommandLogData  (render_command_log *Log);
+static void                 LogRenderFrame           (render_command_log *Log, vec2_int Resolution, render_pass_list *PassList);
+static void                 LogRenderTexture         (render_command_log *Log, render_handle Texture, uint16_t SizeX, uint16_t SizeY, RenderTexture Type);
+static bool                 ReplayRenderFrame        (byte_string Data, uint64_t *Offset, memory_arena *Arena, vec2_int *Resolution, render_pass_list *PassList);
@@ -1,5 +1,9 @@
 #include "render_core.cpp"
 
-#ifdef _WIN32
+#if defined(VOID_RENDER_SOFTWARE)
+#include "./software/software_render.cpp"
+#elif defined(VOID_RENDER_NULL) || !defined(_WIN32)
+#include "./null/null_render.cpp"
+#else
 #include "./d3d11/d3d11_render.cpp"
 #endif
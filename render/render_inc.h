@@ -1,5 +1,9 @@
 #include "render_core.h"
 
-#ifdef _WIN32
+#if defined(VOID_RENDER_SOFTWARE)
+#include "./software/software_render.h"
+#elif defined(VOID_RENDER_NULL) || !defined(_WIN32)
+#include "./null/null_render.h"
+#else
 #include "./d3d11/d3d11_render.h"
 #endif
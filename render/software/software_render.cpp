@@ -0,0 +1,1002 @@
+// ------------------------------------------------------------------------------------
+// Private SIMD Helpers
+// Kernels are written against an 8-wide type. With AVX2 it is a single register,
+// otherwise it is a pair of SSE2 registers and gathers fall back to scalar loads. SSE2 has
+// no floor nor blend: floor corrects a truncation and selects are and/andnot/or.
+
+#if defined(__AVX2__)
+
+typedef __m256  sw_f32;
+typedef __m256i sw_u32;
+
+static inline sw_f32 SWSet1       (float A)                        { return _mm256_set1_ps(A); }
+static inline sw_f32 SWRamp       (void)                           { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+static inline sw_f32 SWAdd        (sw_f32 A, sw_f32 B)             { return _mm256_add_ps(A, B); }
+static inline sw_f32 SWSub        (sw_f32 A, sw_f32 B)             { return _mm256_sub_ps(A, B); }
+static inline sw_f32 SWMul        (sw_f32 A, sw_f32 B)             { return _mm256_mul_ps(A, B); }
+static inline sw_f32 SWMin        (sw_f32 A, sw_f32 B)             { return _mm256_min_ps(A, B); }
+static inline sw_f32 SWMax        (sw_f32 A, sw_f32 B)             { return _mm256_max_ps(A, B); }
+static inline sw_f32 SWSqrt       (sw_f32 A)                       { return _mm256_sqrt_ps(A); }
+static inline sw_f32 SWFloor      (sw_f32 A)                       { return _mm256_floor_ps(A); }
+static inline sw_f32 SWAbs        (sw_f32 A)                       { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), A); }
+static inline sw_f32 SWLess       (sw_f32 A, sw_f32 B)             { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+static inline sw_f32 SWGreater    (sw_f32 A, sw_f32 B)             { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+static inline sw_f32 SWGreaterEq  (sw_f32 A, sw_f32 B)             { return _mm256_cmp_ps(A, B, _CMP_GE_OQ); }
+static inline sw_f32 SWAnd        (sw_f32 A, sw_f32 B)             { return _mm256_and_ps(A, B); }
+static inline sw_f32 SWOr         (sw_f32 A, sw_f32 B)             { return _mm256_or_ps(A, B); }
+static inline sw_f32 SWSelect     (sw_f32 Mask, sw_f32 A, sw_f32 B){ return _mm256_blendv_ps(B, A, Mask); }
+static inline bool   SWAnyLane    (sw_f32 Mask)                    { return _mm256_movemask_ps(Mask) != 0; }
+
+static inline sw_u32 SWLoadU32    (uint32_t *Memory)               { return _mm256_loadu_si256((__m256i *)Memory); }
+static inline void   SWStoreU32   (uint32_t *Memory, sw_u32 A)     { _mm256_storeu_si256((__m256i *)Memory, A); }
+static inline sw_u32 SWToU32      (sw_f32 A)                       { return _mm256_cvtps_epi32(A); }
+static inline sw_f32 SWToF32      (sw_u32 A)                       { return _mm256_cvtepi32_ps(A); }
+static inline sw_u32 SWByte       (sw_u32 A, int Shift)            { return _mm256_and_si256(_mm256_srli_epi32(A, Shift), _mm256_set1_epi32(0xFF)); }
+static inline sw_u32 SWPack       (sw_u32 R, sw_u32 G, sw_u32 B, sw_u32 A)
+{
+    sw_u32 Result = _mm256_or_si256(_mm256_or_si256(R, _mm256_slli_epi32(G, 8)), _mm256_or_si256(_mm256_slli_epi32(B, 16), _mm256_slli_epi32(A, 24)));
+    return Result;
+}
+static inline sw_u32 SWSelectU32  (sw_f32 Mask, sw_u32 A, sw_u32 B){ return _mm256_blendv_epi8(B, A, _mm256_castps_si256(Mask)); }
+static inline sw_u32 SWGather     (uint32_t *Base, sw_f32 X, sw_f32 Y, int32_t Pitch)
+{
+    sw_u32 Index  = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(Y), _mm256_set1_epi32(Pitch)), _mm256_cvttps_epi32(X));
+    sw_u32 Result = _mm256_i32gather_epi32((const int *)Base, Index, 4);
+    return Result;
+}
+static inline sw_u32 SWGatherU8   (uint8_t *Base, sw_f32 X, sw_f32 Y, int32_t Pitch)
+{
+    sw_u32 Index  = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(Y), _mm256_set1_epi32(Pitch)), _mm256_cvttps_epi32(X));
+    sw_u32 Result = _mm256_and_si256(_mm256_i32gather_epi32((const int *)Base, Index, 1), _mm256_set1_epi32(0xFF));
+    return Result;
+}
+
+#else
+
+typedef struct sw_f32 { __m128  Lo, Hi; } sw_f32;
+typedef struct sw_u32 { __m128i Lo, Hi; } sw_u32;
+
+#define SW_F32_OP2(Name, Op)  static inline sw_f32 Name(sw_f32 A, sw_f32 B) { return {Op(A.Lo, B.Lo), Op(A.Hi, B.Hi)}; }
+
+SW_F32_OP2(SWAdd      , _mm_add_ps)
+SW_F32_OP2(SWSub      , _mm_sub_ps)
+SW_F32_OP2(SWMul      , _mm_mul_ps)
+SW_F32_OP2(SWMin      , _mm_min_ps)
+SW_F32_OP2(SWMax      , _mm_max_ps)
+SW_F32_OP2(SWLess     , _mm_cmplt_ps)
+SW_F32_OP2(SWGreater  , _mm_cmpgt_ps)
+SW_F32_OP2(SWGreaterEq, _mm_cmpge_ps)
+SW_F32_OP2(SWAnd      , _mm_and_ps)
+SW_F32_OP2(SWOr       , _mm_or_ps)
+
+#undef SW_F32_OP2
+
+static inline sw_f32 SWSet1       (float A)                        { return {_mm_set1_ps(A), _mm_set1_ps(A)}; }
+static inline sw_f32 SWRamp       (void)                           { return {_mm_setr_ps(0, 1, 2, 3), _mm_setr_ps(4, 5, 6, 7)}; }
+static inline sw_f32 SWSqrt       (sw_f32 A)                       { return {_mm_sqrt_ps(A.Lo), _mm_sqrt_ps(A.Hi)}; }
+static inline __m128 SWFloor4     (__m128 A)
+{
+    __m128 Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(A));
+    __m128 Result    = _mm_sub_ps(Truncated, _mm_and_ps(_mm_cmpgt_ps(Truncated, A), _mm_set1_ps(1.f)));
+    return Result;
+}
+static inline __m128 SWSelect4    (__m128 Mask, __m128 A, __m128 B){ return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B)); }
+
+static inline sw_f32 SWFloor      (sw_f32 A)                       { return {SWFloor4(A.Lo), SWFloor4(A.Hi)}; }
+static inline sw_f32 SWAbs        (sw_f32 A)                       { __m128 S = _mm_set1_ps(-0.f); return {_mm_andnot_ps(S, A.Lo), _mm_andnot_ps(S, A.Hi)}; }
+static inline sw_f32 SWSelect     (sw_f32 Mask, sw_f32 A, sw_f32 B){ return {SWSelect4(Mask.Lo, A.Lo, B.Lo), SWSelect4(Mask.Hi, A.Hi, B.Hi)}; }
+static inline bool   SWAnyLane    (sw_f32 Mask)                    { return (_mm_movemask_ps(Mask.Lo) | _mm_movemask_ps(Mask.Hi)) != 0; }
+
+static inline sw_u32 SWLoadU32    (uint32_t *Memory)               { return {_mm_loadu_si128((__m128i *)Memory), _mm_loadu_si128((__m128i *)(Memory + 4))}; }
+static inline void   SWStoreU32   (uint32_t *Memory, sw_u32 A)     { _mm_storeu_si128((__m128i *)Memory, A.Lo); _mm_storeu_si128((__m128i *)(Memory + 4), A.Hi); }
+static inline sw_u32 SWToU32      (sw_f32 A)                       { return {_mm_cvtps_epi32(A.Lo), _mm_cvtps_epi32(A.Hi)}; }
+static inline sw_f32 SWToF32      (sw_u32 A)                       { return {_mm_cvtepi32_ps(A.Lo), _mm_cvtepi32_ps(A.Hi)}; }
+static inline sw_u32 SWByte       (sw_u32 A, int Shift)
+{
+    __m128i Mask = _mm_set1_epi32(0xFF);
+    return {_mm_and_si128(_mm_srli_epi32(A.Lo, Shift), Mask), _mm_and_si128(_mm_srli_epi32(A.Hi, Shift), Mask)};
+}
+static inline sw_u32 SWPack       (sw_u32 R, sw_u32 G, sw_u32 B, sw_u32 A)
+{
+    sw_u32 Result;
+    Result.Lo = _mm_or_si128(_mm_or_si128(R.Lo, _mm_slli_epi32(G.Lo, 8)), _mm_or_si128(_mm_slli_epi32(B.Lo, 16), _mm_slli_epi32(A.Lo, 24)));
+    Result.Hi = _mm_or_si128(_mm_or_si128(R.Hi, _mm_slli_epi32(G.Hi, 8)), _mm_or_si128(_mm_slli_epi32(B.Hi, 16), _mm_slli_epi32(A.Hi, 24)));
+    return Result;
+}
+static inline sw_u32 SWSelectU32  (sw_f32 Mask, sw_u32 A, sw_u32 B)
+{
+    sw_u32 Result;
+    Result.Lo = _mm_castps_si128(SWSelect4(Mask.Lo, _mm_castsi128_ps(A.Lo), _mm_castsi128_ps(B.Lo)));
+    Result.Hi = _mm_castps_si128(SWSelect4(Mask.Hi, _mm_castsi128_ps(A.Hi), _mm_castsi128_ps(B.Hi)));
+    return Result;
+}
+static inline sw_u32 SWGather     (uint32_t *Base, sw_f32 X, sw_f32 Y, int32_t Pitch)
+{
+    alignas(16) float    XS[8];
+    alignas(16) float    YS[8];
+    alignas(16) uint32_t Texels[8];
+
+    _mm_store_ps(XS, X.Lo); _mm_store_ps(XS + 4, X.Hi);
+    _mm_store_ps(YS, Y.Lo); _mm_store_ps(YS + 4, Y.Hi);
+
+    for (uint32_t Lane = 0; Lane < 8; ++Lane)
+    {
+        Texels[Lane] = Base[(int32_t)YS[Lane] * Pitch + (int32_t)XS[Lane]];
+    }
+
+    return {_mm_load_si128((__m128i *)Texels), _mm_load_si128((__m128i *)(Texels + 4))};
+}
+static inline sw_u32 SWGatherU8   (uint8_t *Base, sw_f32 X, sw_f32 Y, int32_t Pitch)
+{
+    alignas(16) float    XS[8];
+    alignas(16) float    YS[8];
+    alignas(16) uint32_t Texels[8];
+
+    _mm_store_ps(XS, X.Lo); _mm_store_ps(XS + 4, X.Hi);
+    _mm_store_ps(YS, Y.Lo); _mm_store_ps(YS + 4, Y.Hi);
+
+    for (uint32_t Lane = 0; Lane < 8; ++Lane)
+    {
+        Texels[Lane] = Base[(int32_t)YS[Lane] * Pitch + (int32_t)XS[Lane]];
+    }
+
+    return {_mm_load_si128((__m128i *)Texels), _mm_load_si128((__m128i *)(Texels + 4))};
+}
+
+#endif
+
+static inline sw_f32
+SWLerp(sw_f32 A, sw_f32 B, sw_f32 T)
+{
+    sw_f32 Result = SWAdd(A, SWMul(SWSub(B, A), T));
+    return Result;
+}
+
+static inline sw_f32
+SWClamp01(sw_f32 A)
+{
+    sw_f32 Result = SWMin(SWMax(A, SWSet1(0.f)), SWSet1(1.f));
+    return Result;
+}
+
+// Same as RectSDF in the rect shader.
+
+static inline sw_f32
+SWRectSDF(sw_f32 X, sw_f32 Y, sw_f32 HalfX, sw_f32 HalfY, sw_f32 Radius)
+{
+    sw_f32 Zero = SWSet1(0.f);
+    sw_f32 QX   = SWAdd(SWSub(SWAbs(X), HalfX), Radius);
+    sw_f32 QY   = SWAdd(SWSub(SWAbs(Y), HalfY), Radius);
+    sw_f32 OX   = SWMax(QX, Zero);
+    sw_f32 OY   = SWMax(QY, Zero);
+
+    sw_f32 Outer  = SWSqrt(SWAdd(SWMul(OX, OX), SWMul(OY, OY)));
+    sw_f32 Inner  = SWMin(SWMax(QX, QY), Zero);
+    sw_f32 Result = SWSub(SWAdd(Outer, Inner), Radius);
+
+    return Result;
+}
+
+// smoothstep(0, Edge, X). With a zero edge the GPU yields a hard step (x / 0 saturates).
+
+static inline sw_f32
+SWSmoothStep(float Edge, sw_f32 X)
+{
+    sw_f32 Zero = SWSet1(0.f);
+    sw_f32 One  = SWSet1(1.f);
+
+    if (Edge <= 0.f)
+    {
+        sw_f32 Result = SWSelect(SWGreater(X, Zero), One, Zero);
+        return Result;
+    }
+
+    sw_f32 T      = SWClamp01(SWMul(X, SWSet1(1.f / Edge)));
+    sw_f32 Result = SWMul(SWMul(T, T), SWSub(SWSet1(3.f), SWAdd(T, T)));
+    return Result;
+}
+
+// ------------------------------------------------------------------------------------
+// Private Helpers
+
+static software_renderer *
+SoftwareGetRenderer(render_handle HRenderer)
+{
+    software_renderer *Result = (software_renderer *)HRenderer.Value[0];
+    return Result;
+}
+
+static software_texture *
+SoftwareGetTexture(render_handle Handle)
+{
+    software_texture *Result = (software_texture *)Handle.Value[0];
+    return Result;
+}
+
+static void
+SoftwareResizeFramebuffer(software_renderer *Renderer, vec2_int Resolution)
+{
+    software_framebuffer *Framebuffer = &Renderer->Framebuffer;
+
+    int32_t Width  = Max(Resolution.X, 0);
+    int32_t Height = Max(Resolution.Y, 0);
+    int32_t Pitch  = AlignPow2(Width, SoftwareLaneWidth);
+
+    PopArenaTo(Renderer->FramebufferArena, 0);
+
+    Framebuffer->Pixels = PushArrayNoZeroAligned(Renderer->FramebufferArena, uint32_t, (uint64_t)Pitch * Height, 64);
+    Framebuffer->Width  = Width;
+    Framebuffer->Height = Height;
+    Framebuffer->Pitch  = Pitch;
+
+    Renderer->LastResolution = Resolution;
+    Renderer->MustRedrawAll  = true;
+}
+
+static uint32_t
+SoftwareGetBytesPerPixel(RenderTexture Format)
+{
+    uint32_t Result = 0;
+
+    switch(Format)
+    {
+        case RenderTexture::RGBA:      Result = 4; break;
+        case RenderTexture::GreyScale: Result = 1; break;
+        default:                                   break;
+    }
+
+    return Result;
+}
+
+static void
+SoftwareApplyTextureUpdate(render_texture_update *Update)
+{
+    software_texture *Texture = SoftwareGetTexture(Update->Texture);
+    if (!Texture || !Texture->Pixels)
+    {
+        return;
+    }
+
+    VOID_ASSERT(Update->X + Update->Width  <= Texture->Width);
+    VOID_ASSERT(Update->Y + Update->Height <= Texture->Height);
+
+    uint32_t BytesPerPixel = SoftwareGetBytesPerPixel(Texture->Format);
+    uint64_t TexturePitch  = (uint64_t)Texture->Width * BytesPerPixel;
+
+    for (uint32_t Row = 0; Row < Update->Height; ++Row)
+    {
+        uint8_t *Target = Texture->Pixels + (uint64_t)(Update->Y + Row) * TexturePitch + (uint64_t)Update->X * BytesPerPixel;
+        uint8_t *Source = Update->Pixels  + (uint64_t)Row * Update->Pitch;
+
+        MemoryCopy(Target, Source, Update->Width * BytesPerPixel);
+    }
+}
+
+// ------------------------------------------------------------------------------------
+// Rasterization
+// Mirrors the rect shader. Differences with the GPU:
+// - Corner radii are picked per quadrant instead of being interpolated across the quad.
+// - Colors are interpolated bilinearly instead of per triangle.
+
+static bool
+SoftwarePrepareRect(software_framebuffer *Framebuffer, software_rect_instance *Rect, rect_clip_params *ClipParams, software_texture *Texture, software_prepared_rect *Prepared)
+{
+    float Left   = Rect->RectBounds[0];
+    float Top    = Rect->RectBounds[1];
+    float Right  = Rect->RectBounds[2];
+    float Bottom = Rect->RectBounds[3];
+
+    // Inverted rects flip the winding and are culled on the GPU.
+    if (Right <= Left || Bottom <= Top)
+    {
+        return 0;
+    }
+
+    // Pixels are mapped back into rect space. Mirrored transforms are culled like the
+    // GPU culls back faces.
+    matrix_3x3 T   = ClipParams->Transform;
+    float      Det = T.c0r0 * T.c1r1 - T.c1r0 * T.c0r1;
+    if (Det <= 0.f)
+    {
+        return 0;
+    }
+
+    float InvDet = 1.f / Det;
+    Prepared->Inverse[0]     =  T.c1r1 * InvDet;
+    Prepared->Inverse[1]     = -T.c1r0 * InvDet;
+    Prepared->Inverse[2]     = -T.c0r1 * InvDet;
+    Prepared->Inverse[3]     =  T.c0r0 * InvDet;
+    Prepared->Translation[0] = T.c2r0;
+    Prepared->Translation[1] = T.c2r1;
+
+    // Bounding box in pixels
+    float MinX = FLT_MAX, MinY = FLT_MAX, MaxX = -FLT_MAX, MaxY = -FLT_MAX;
+    {
+        float CornerX[4] = {Left, Right, Left  , Right };
+        float CornerY[4] = {Top , Top  , Bottom, Bottom};
+
+        for (uint32_t Idx = 0; Idx < 4; ++Idx)
+        {
+            float X = T.c0r0 * CornerX[Idx] + T.c1r0 * CornerY[Idx] + T.c2r0;
+            float Y = T.c0r1 * CornerX[Idx] + T.c1r1 * CornerY[Idx] + T.c2r1;
+
+            MinX = Min(MinX, X); MaxX = Max(MaxX, X);
+            MinY = Min(MinY, Y); MaxY = Max(MaxY, Y);
+        }
+    }
+
+    // Clip (zero == none, inverted == reject)
+    rect_float Clip = ClipParams->Clip;
+    Prepared->HasClip = (Clip.Left != 0 || Clip.Top != 0 || Clip.Right != 0 || Clip.Bottom != 0);
+    Prepared->Clip    = Clip;
+    if (Prepared->HasClip)
+    {
+        if (Clip.Left > Clip.Right || Clip.Top > Clip.Bottom)
+        {
+            return 0;
+        }
+
+        MinX = Max(MinX, Clip.Left); MaxX = Min(MaxX, Clip.Right);
+        MinY = Max(MinY, Clip.Top ); MaxY = Min(MaxY, Clip.Bottom);
+    }
+
+    Prepared->Bounds.Left   = Max((int32_t)floorf(MinX), 0);
+    Prepared->Bounds.Top    = Max((int32_t)floorf(MinY), 0);
+    Prepared->Bounds.Right  = Min((int32_t)ceilf (MaxX), Framebuffer->Width);
+    Prepared->Bounds.Bottom = Min((int32_t)ceilf (MaxY), Framebuffer->Height);
+    Prepared->Rect          = Rect;
+    Prepared->Texture       = (Rect->SampleTexture > 0.f && Texture && Texture->Pixels) ? Texture : 0;
+
+    bool Result = (Prepared->Bounds.Left < Prepared->Bounds.Right && Prepared->Bounds.Top < Prepared->Bounds.Bottom);
+    return Result;
+}
+
+// Rasterizes the part of the rect that lies within Area. Area must start on a lane boundary.
+
+static void
+SoftwareRasterizeRect(software_framebuffer *Framebuffer, software_prepared_rect *Prepared, rect_int Area)
+{
+    software_rect_instance *Rect    = Prepared->Rect;
+    software_texture       *Texture = Prepared->Texture;
+
+    int32_t X0 = Max(Prepared->Bounds.Left  , Area.Left  );
+    int32_t Y0 = Max(Prepared->Bounds.Top   , Area.Top   );
+    int32_t X1 = Min(Prepared->Bounds.Right , Area.Right );
+    int32_t Y1 = Min(Prepared->Bounds.Bottom, Area.Bottom);
+    if (X0 >= X1 || Y0 >= Y1)
+    {
+        return;
+    }
+
+    // Per-instance constants
+    float Left        = Rect->RectBounds[0];
+    float Top         = Rect->RectBounds[1];
+    float Width       = Rect->RectBounds[2] - Left;
+    float Height      = Rect->RectBounds[3] - Top;
+    float HalfX       = Width  * 0.5f;
+    float HalfY       = Height * 0.5f;
+    float CenterX     = Left + HalfX;
+    float CenterY     = Top  + HalfY;
+    float BorderWidth = Rect->BorderWidth;
+    float Softness    = Rect->Softness;
+    float Softness2   = 2.f * Softness;
+    bool  HasBorder   = BorderWidth > 0.f;
+    bool  HasClip     = Prepared->HasClip;
+    float IA          = Prepared->Inverse[0];
+    float IB          = Prepared->Inverse[1];
+    float IC          = Prepared->Inverse[2];
+    float ID          = Prepared->Inverse[3];
+
+    sw_f32 Zero       = SWSet1(0.f);
+    sw_f32 One        = SWSet1(1.f);
+    sw_f32 Ramp       = SWRamp();
+    sw_f32 RadiusTL   = SWSet1(Rect->CornerRadii[0]);
+    sw_f32 RadiusTR   = SWSet1(Rect->CornerRadii[1]);
+    sw_f32 RadiusBR   = SWSet1(Rect->CornerRadii[2]);
+    sw_f32 RadiusBL   = SWSet1(Rect->CornerRadii[3]);
+    sw_f32 InvWidth   = SWSet1(1.f / Width);
+    sw_f32 InvHeight  = SWSet1(1.f / Height);
+    sw_f32 CornerSoft = (Softness > 0.75f) ? SWGreaterEq(One, Zero) : Zero;
+
+    rect_float Clip = Prepared->Clip;
+    sw_f32 ClipL = SWSet1(Clip.Left ), ClipT = SWSet1(Clip.Top   );
+    sw_f32 ClipR = SWSet1(Clip.Right), ClipB = SWSet1(Clip.Bottom);
+
+    for (int32_t Y = Y0; Y < Y1; ++Y)
+    {
+        uint32_t *Row    = Framebuffer->Pixels + (uint64_t)Y * Framebuffer->Pitch;
+        float     PixelY = (float)Y + 0.5f - Prepared->Translation[1];
+
+        for (int32_t X = X0 & ~(SoftwareLaneWidth - 1); X < X1; X += SoftwareLaneWidth)
+        {
+            // Coverage masks
+            sw_f32 PX   = SWAdd(SWSet1((float)X + 0.5f), Ramp);
+            sw_f32 Live = SWAnd(SWGreaterEq(PX, SWSet1((float)X0)), SWLess(PX, SWSet1((float)X1)));
+
+            if (HasClip)
+            {
+                sw_f32 PY = SWSet1((float)Y + 0.5f);
+                Live = SWAnd(Live, SWAnd(SWGreaterEq(PX, ClipL), SWLess(PX, ClipR)));
+                Live = SWAnd(Live, SWAnd(SWGreaterEq(PY, ClipT), SWLess(PY, ClipB)));
+            }
+
+            sw_f32 TX     = SWSub(PX, SWSet1(Prepared->Translation[0]));
+            sw_f32 LocalX = SWAdd(SWMul(SWSet1(IA), TX), SWSet1(IB * PixelY));
+            sw_f32 LocalY = SWAdd(SWMul(SWSet1(IC), TX), SWSet1(ID * PixelY));
+            sw_f32 U      = SWMul(SWSub(LocalX, SWSet1(Left)), InvWidth);
+            sw_f32 V      = SWMul(SWSub(LocalY, SWSet1(Top )), InvHeight);
+
+            Live = SWAnd(Live, SWAnd(SWGreaterEq(U, Zero), SWLess(U, One)));
+            Live = SWAnd(Live, SWAnd(SWGreaterEq(V, Zero), SWLess(V, One)));
+            if (!SWAnyLane(Live))
+            {
+                continue;
+            }
+
+            sw_f32 SampleX = SWSub(LocalX, SWSet1(CenterX));
+            sw_f32 SampleY = SWSub(LocalY, SWSet1(CenterY));
+            sw_f32 IsLeft  = SWLess(SampleX, Zero);
+            sw_f32 IsTop   = SWLess(SampleY, Zero);
+            sw_f32 Radius  = SWSelect(IsTop, SWSelect(IsLeft, RadiusTL, RadiusTR), SWSelect(IsLeft, RadiusBL, RadiusBR));
+
+            // Border mask (hollow center)
+            sw_f32 BorderSDF = One;
+            if (HasBorder)
+            {
+                sw_f32 BorderHalfX = SWSet1(HalfX - BorderWidth - Softness2);
+                sw_f32 BorderHalfY = SWSet1(HalfY - BorderWidth - Softness2);
+                sw_f32 BorderRad   = SWMax(SWSub(Radius, SWSet1(BorderWidth)), Zero);
+
+                BorderSDF = SWRectSDF(SampleX, SampleY, BorderHalfX, BorderHalfY, BorderRad);
+                BorderSDF = SWSmoothStep(Softness2, BorderSDF);
+
+                Live = SWAnd(Live, SWGreaterEq(BorderSDF, SWSet1(0.001f)));
+                if (!SWAnyLane(Live))
+                {
+                    continue;
+                }
+            }
+
+            // Corner mask
+            sw_f32 CornerSDF = One;
+            {
+                sw_f32 Needed = SWOr(SWGreater(Radius, Zero), CornerSoft);
+                if (SWAnyLane(Needed))
+                {
+                    sw_f32 CornerHalfX = SWSet1(HalfX - Softness2);
+                    sw_f32 CornerHalfY = SWSet1(HalfY - Softness2);
+                    sw_f32 Distance    = SWRectSDF(SampleX, SampleY, CornerHalfX, CornerHalfY, Radius);
+
+                    CornerSDF = SWSelect(Needed, SWSub(One, SWSmoothStep(Softness2, Distance)), One);
+                }
+            }
+
+            // Tint
+            sw_f32 Tint[4];
+            for (uint32_t Channel = 0; Channel < 4; ++Channel)
+            {
+                sw_f32 TopColor = SWLerp(SWSet1(Rect->ColorTL[Channel]), SWSet1(Rect->ColorTR[Channel]), U);
+                sw_f32 BotColor = SWLerp(SWSet1(Rect->ColorBL[Channel]), SWSet1(Rect->ColorBR[Channel]), U);
+                Tint[Channel]   = SWLerp(TopColor, BotColor, V);
+            }
+
+            // Albedo (point sampling, clamped)
+            if (Texture)
+            {
+                sw_f32 SourceX = SWLerp(SWSet1(Rect->TextureSource[0]), SWSet1(Rect->TextureSource[2]), U);
+                sw_f32 SourceY = SWLerp(SWSet1(Rect->TextureSource[1]), SWSet1(Rect->TextureSource[3]), V);
+                sw_f32 MaxTexX = SWSet1((float)(Texture->Width  - 1));
+                sw_f32 MaxTexY = SWSet1((float)(Texture->Height - 1));
+                sw_f32 TexX    = SWMin(SWMax(SWFloor(SourceX), Zero), MaxTexX);
+                sw_f32 TexY    = SWMin(SWMax(SWFloor(SourceY), Zero), MaxTexY);
+
+                sw_f32 Inverse = SWSet1(1.f / 255.f);
+
+                if (Texture->Format == RenderTexture::GreyScale && Rect->SampleTexture > 1.f)
+                {
+                    // Distance fields are scaled, they are sampled bilinearly
+                    sw_f32 Half = SWSet1(0.5f);
+                    sw_f32 FX   = SWSub(SourceX, Half);
+                    sw_f32 FY   = SWSub(SourceY, Half);
+                    sw_f32 BX   = SWFloor(FX);
+                    sw_f32 BY   = SWFloor(FY);
+                    sw_f32 WX   = SWSub(FX, BX);
+                    sw_f32 WY   = SWSub(FY, BY);
+                    sw_f32 X0   = SWMin(SWMax(BX, Zero), MaxTexX);
+                    sw_f32 Y0   = SWMin(SWMax(BY, Zero), MaxTexY);
+                    sw_f32 X1   = SWMin(SWMax(SWAdd(BX, One), Zero), MaxTexX);
+                    sw_f32 Y1   = SWMin(SWMax(SWAdd(BY, One), Zero), MaxTexY);
+
+                    sw_f32 D00 = SWToF32(SWGatherU8(Texture->Pixels, X0, Y0, Texture->Width));
+                    sw_f32 D10 = SWToF32(SWGatherU8(Texture->Pixels, X1, Y0, Texture->Width));
+                    sw_f32 D01 = SWToF32(SWGatherU8(Texture->Pixels, X0, Y1, Texture->Width));
+                    sw_f32 D11 = SWToF32(SWGatherU8(Texture->Pixels, X1, Y1, Texture->Width));
+
+                    sw_f32 Distance  = SWMul(SWLerp(SWLerp(D00, D10, WX), SWLerp(D01, D11, WX), WY), Inverse);
+                    sw_f32 Sharpness = SWSet1(Rect->SampleTexture - 1.f);
+                    sw_f32 Coverage  = SWClamp01(SWAdd(SWMul(SWSub(Distance, Half), Sharpness), Half));
+
+                    Tint[3] = SWMul(Tint[3], Coverage);
+                }
+                else if (Texture->Format == RenderTexture::GreyScale)
+                {
+                    sw_u32 Coverage = SWGatherU8(Texture->Pixels, TexX, TexY, Texture->Width);
+
+                    Tint[3] = SWMul(Tint[3], SWMul(SWToF32(Coverage), Inverse));
+                }
+                else
+                {
+                    sw_u32 Texels = SWGather((uint32_t *)Texture->Pixels, TexX, TexY, Texture->Width);
+
+                    Tint[0] = SWMul(Tint[0], SWMul(SWToF32(SWByte(Texels,  0)), Inverse));
+                    Tint[1] = SWMul(Tint[1], SWMul(SWToF32(SWByte(Texels,  8)), Inverse));
+                    Tint[2] = SWMul(Tint[2], SWMul(SWToF32(SWByte(Texels, 16)), Inverse));
+                    Tint[3] = SWMul(Tint[3], SWMul(SWToF32(SWByte(Texels, 24)), Inverse));
+                }
+            }
+
+            // Blend: SRC_ALPHA/INV_SRC_ALPHA on color, ONE/ZERO on alpha.
+            sw_f32 Alpha    = SWClamp01(SWMul(Tint[3], SWMul(CornerSDF, BorderSDF)));
+            sw_f32 InvAlpha = SWSub(One, Alpha);
+            sw_u32 Dest     = SWLoadU32(Row + X);
+            sw_f32 Scale    = SWSet1(255.f);
+            sw_f32 ToUnit   = SWSet1(1.f / 255.f);
+
+            sw_f32 R = SWAdd(SWMul(SWClamp01(Tint[0]), Alpha), SWMul(SWMul(SWToF32(SWByte(Dest,  0)), ToUnit), InvAlpha));
+            sw_f32 G = SWAdd(SWMul(SWClamp01(Tint[1]), Alpha), SWMul(SWMul(SWToF32(SWByte(Dest,  8)), ToUnit), InvAlpha));
+            sw_f32 B = SWAdd(SWMul(SWClamp01(Tint[2]), Alpha), SWMul(SWMul(SWToF32(SWByte(Dest, 16)), ToUnit), InvAlpha));
+
+            sw_u32 Packed = SWPack(SWToU32(SWMul(SWClamp01(R), Scale)),
+                                   SWToU32(SWMul(SWClamp01(G), Scale)),
+                                   SWToU32(SWMul(SWClamp01(B), Scale)),
+                                   SWToU32(SWMul(Alpha, Scale)));
+
+            SWStoreU32(Row + X, SWSelectU32(Live, Packed, Dest));
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------
+// Tiles
+
+static rect_int
+SoftwareGetTileRect(software_tile_job *Job, uint32_t Tile)
+{
+    software_framebuffer *Framebuffer = &Job->Renderer->Framebuffer;
+
+    rect_int Result;
+    Result.Left   = (int32_t)(Tile % Job->TileCountX) * SoftwareTileSize;
+    Result.Top    = (int32_t)(Tile / Job->TileCountX) * SoftwareTileSize;
+    Result.Right  = Min(Result.Left + SoftwareTileSize, Framebuffer->Width);
+    Result.Bottom = Min(Result.Top  + SoftwareTileSize, Framebuffer->Height);
+
+    return Result;
+}
+
+static void
+SoftwareRasterizeTile(software_tile_job *Job, uint32_t Tile)
+{
+    software_framebuffer *Framebuffer = &Job->Renderer->Framebuffer;
+    rect_int              Area        = SoftwareGetTileRect(Job, Tile);
+
+    // Temporary Clear Screen
+    for (int32_t Y = Area.Top; Y < Area.Bottom; ++Y)
+    {
+        uint32_t *Row = Framebuffer->Pixels + (uint64_t)Y * Framebuffer->Pitch;
+        for (int32_t X = Area.Left; X < Area.Right; ++X)
+        {
+            Row[X] = SoftwareClearColor;
+        }
+    }
+
+    for (uint32_t Idx = Job->BinOffsets[Tile]; Idx < Job->BinOffsets[Tile + 1]; ++Idx)
+    {
+        SoftwareRasterizeRect(Framebuffer, &Job->Rects[Job->Bins[Idx]], Area);
+    }
+}
+
+static void
+SoftwareTileWorker(void *Data)
+{
+    software_tile_job *Job = (software_tile_job *)Data;
+
+    for (;;)
+    {
+        uint32_t Index = OSAtomicIncrement32(&Job->NextTile) - 1;
+        if (Index >= Job->DirtyTileCount)
+        {
+            break;
+        }
+
+        SoftwareRasterizeTile(Job, Job->DirtyTiles[Index]);
+    }
+}
+
+// Damage rects are snapped outward to tile edges, a dirty tile is always redrawn whole.
+
+static void
+SoftwareCollectDirtyTiles(software_renderer *Renderer, render_damage *Damage, software_tile_job *Job)
+{
+    memory_arena *Arena      = Renderer->FrameArena;
+    uint32_t      TileCountY = Job->TileCount / Max(Job->TileCountX, 1u);
+
+    Job->DirtyTiles     = PushArrayNoZero(Arena, uint32_t, Job->TileCount);
+    Job->DirtyTileCount = 0;
+    Job->DirtyAreaCount = 0;
+
+    if (Job->RedrawAll)
+    {
+        for (uint32_t Tile = 0; Tile < Job->TileCount; ++Tile)
+        {
+            Job->DirtyTiles[Job->DirtyTileCount++] = Tile;
+        }
+
+        return;
+    }
+
+    bool *Marked = PushArray(Arena, bool, Job->TileCount);
+
+    for (uint32_t Idx = 0; Idx < Damage->Count; ++Idx)
+    {
+        rect_float Rect = Damage->Rects[Idx];
+
+        int32_t TileX0 = Max((int32_t)floorf(Rect.Left / SoftwareTileSize), 0);
+        int32_t TileY0 = Max((int32_t)floorf(Rect.Top  / SoftwareTileSize), 0);
+        int32_t TileX1 = Min((int32_t)ceilf (Rect.Right  / SoftwareTileSize), (int32_t)Job->TileCountX);
+        int32_t TileY1 = Min((int32_t)ceilf (Rect.Bottom / SoftwareTileSize), (int32_t)TileCountY);
+
+        if (TileX0 >= TileX1 || TileY0 >= TileY1)
+        {
+            continue;
+        }
+
+        Job->DirtyAreas[Job->DirtyAreaCount++] = rect_int(TileX0 * SoftwareTileSize, TileY0 * SoftwareTileSize, TileX1 * SoftwareTileSize, TileY1 * SoftwareTileSize);
+
+        for (int32_t TileY = TileY0; TileY < TileY1; ++TileY)
+        {
+            for (int32_t TileX = TileX0; TileX < TileX1; ++TileX)
+            {
+                uint32_t Tile = (uint32_t)TileY * Job->TileCountX + (uint32_t)TileX;
+                if (!Marked[Tile])
+                {
+                    Marked[Tile] = true;
+                    Job->DirtyTiles[Job->DirtyTileCount++] = Tile;
+                }
+            }
+        }
+    }
+}
+
+static bool
+SoftwareIsInDirtyArea(software_tile_job *Job, rect_int Bounds)
+{
+    bool Result = Job->RedrawAll;
+
+    for (uint32_t Idx = 0; Idx < Job->DirtyAreaCount && !Result; ++Idx)
+    {
+        Result = Job->DirtyAreas[Idx].IsIntersecting(Bounds);
+    }
+
+    return Result;
+}
+
+// Prepares every instance of the pass list and bins them into tiles. Instances keep the
+// order in which they were submitted, which is the painter's order.
+
+static void
+SoftwareExpandGlyph(render_glyph *Glyph, render_glyph_run *Run, software_rect_instance *Result)
+{
+    MemoryZero(Result, sizeof(software_rect_instance));
+
+    float Left = Run->Origin.X + Glyph->OffsetX;
+    float Top  = Run->Origin.Y + Glyph->OffsetY;
+
+    Result->RectBounds[0]    = Left;
+    Result->RectBounds[1]    = Top;
+    Result->RectBounds[2]    = Left + Glyph->SourceWidth  * Run->Scale;
+    Result->RectBounds[3]    = Top  + Glyph->SourceHeight * Run->Scale;
+    Result->TextureSource[0] = Glyph->SourceX;
+    Result->TextureSource[1] = Glyph->SourceY;
+    Result->TextureSource[2] = (float)(Glyph->SourceX + Glyph->SourceWidth);
+    Result->TextureSource[3] = (float)(Glyph->SourceY + Glyph->SourceHeight);
+
+    for (uint32_t Channel = 0; Channel < 4; ++Channel)
+    {
+        float Value = (float)((Run->Color >> (Channel * 8)) & 0xFF) / 255.f;
+        Result->ColorTL[Channel] = Value;
+        Result->ColorBL[Channel] = Value;
+        Result->ColorTR[Channel] = Value;
+        Result->ColorBR[Channel] = Value;
+    }
+
+    Result->SampleTexture = 1.f + Run->Sharpness;
+    Result->ClipIndex     = Run->ClipIndex;
+}
+
+static void
+SoftwareBinPassList(software_renderer *Renderer, render_pass_list *PassList, software_tile_job *Job)
+{
+    memory_arena         *Arena       = Renderer->FrameArena;
+    software_framebuffer *Framebuffer = &Renderer->Framebuffer;
+
+    Job->Renderer   = Renderer;
+    Job->TileCountX = (uint32_t)((Framebuffer->Width  + SoftwareTileSize - 1) / SoftwareTileSize);
+    Job->TileCount  = (uint32_t)((Framebuffer->Height + SoftwareTileSize - 1) / SoftwareTileSize) * Job->TileCountX;
+    Job->RedrawAll  = Renderer->MustRedrawAll || PassList->Damage.Full;
+    Job->NextTile   = 0;
+
+    SoftwareCollectDirtyTiles(Renderer, &PassList->Damage, Job);
+
+    if (!Job->DirtyTileCount)
+    {
+        Renderer->DirtyTileCount = 0;
+        return;
+    }
+
+    uint64_t InstanceCount = 0;
+    for (render_pass_node *PassNode = PassList->First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        if (PassNode->Value.Type == RenderPass_UI)
+        {
+            render_pass_params_ui *Params = &PassNode->Value.Params.UI.Params;
+            for (rect_group_node *Node = Params->First; Node != 0; Node = Node->Next)
+            {
+                InstanceCount += Node->BatchList.ByteCount / Node->BatchList.BytesPerInstance;
+            }
+        }
+    }
+
+    Job->Rects      = PushArrayNoZero(Arena, software_prepared_rect, InstanceCount);
+    Job->BinOffsets = PushArray(Arena, uint32_t, Job->TileCount + 1);
+
+    // Prepare
+    uint32_t         RectCount   = 0;
+    rect_clip_params DefaultClip = {.Transform = Mat3x3Identity(), .Clip = {}};
+
+    for (render_pass_node *PassNode = PassList->First; PassNode != 0; PassNode = PassNode->Next)
+    {
+        if (PassNode->Value.Type != RenderPass_UI)
+        {
+            continue;
+        }
+
+        render_pass_params_ui *Params = &PassNode->Value.Params.UI.Params;
+        for (rect_group_node *Node = Params->First; Node != 0; Node = Node->Next)
+        {
+            software_texture *Texture = SoftwareGetTexture(Node->Params.Texture);
+            uint64_t          Stride  = Node->BatchList.BytesPerInstance;
+
+            // Glyph groups are expanded into rects here, the rasterizer only knows rects.
+            // Prepared rects point at their instance, expanded glyphs live in the frame arena.
+            render_glyph_run       *Runs     = 0;
+            uint32_t                RunCount = 0;
+            software_rect_instance *Expanded = 0;
+            if (Node->Params.Type == RectGroup_Glyphs)
+            {
+                RunCount = GetGlyphRunCount(Node);
+                Runs     = PushArrayNoZero(Arena, render_glyph_run, RunCount);
+                Expanded = PushArrayNoZero(Arena, software_rect_instance, Node->BatchList.ByteCount / Stride);
+                GatherGlyphRuns(Node, Runs);
+            }
+
+            for (render_batch_node *Batch = Node->BatchList.First; Batch != 0; Batch = Batch->Next)
+            {
+                for (uint64_t Offset = 0; Offset < Batch->Value.ByteCount; Offset += Stride)
+                {
+                    software_rect_instance *Rect = (software_rect_instance *)(Batch->Value.Memory + Offset);
+                    rect_clip_params       *Clip = &DefaultClip;
+
+                    if (Node->Params.Type == RectGroup_Glyphs)
+                    {
+                        render_glyph *Glyph = (render_glyph *)(Batch->Value.Memory + Offset);
+                        if (Glyph->RunIndex >= RunCount)
+                        {
+                            continue;
+                        }
+
+                        Rect = Expanded++;
+                        SoftwareExpandGlyph(Glyph, &Runs[Glyph->RunIndex], Rect);
+                    }
+
+                    if (Rect->ClipIndex < Params->ClipTable.Count)
+                    {
+                        Clip = &Params->ClipTable.Entries[Rect->ClipIndex];
+                    }
+
+                    if (SoftwarePrepareRect(Framebuffer, Rect, Clip, Texture, &Job->Rects[RectCount]) &&
+                        SoftwareIsInDirtyArea(Job, Job->Rects[RectCount].Bounds))
+                    {
+                        RectCount += 1;
+                    }
+                }
+            }
+        }
+    }
+
+    // Count entries per tile, then turn the counts into offsets.
+    for (uint32_t Idx = 0; Idx < RectCount; ++Idx)
+    {
+        rect_int Bounds = Job->Rects[Idx].Bounds;
+        for (int32_t TileY = Bounds.Top / SoftwareTileSize; TileY <= (Bounds.Bottom - 1) / SoftwareTileSize; ++TileY)
+        {
+            for (int32_t TileX = Bounds.Left / SoftwareTileSize; TileX <= (Bounds.Right - 1) / SoftwareTileSize; ++TileX)
+            {
+                Job->BinOffsets[TileY * Job->TileCountX + TileX + 1] += 1;
+            }
+        }
+    }
+
+    for (uint32_t Tile = 0; Tile < Job->TileCount; ++Tile)
+    {
+        Job->BinOffsets[Tile + 1] += Job->BinOffsets[Tile];
+    }
+
+    // Fill the bins, tile cursors start at each tile offset.
+    uint32_t *Cursors = PushArrayNoZero(Arena, uint32_t, Job->TileCount);
+    MemoryCopy(Cursors, Job->BinOffsets, Job->TileCount * sizeof(uint32_t));
+
+    Job->Bins = PushArrayNoZero(Arena, uint32_t, Job->BinOffsets[Job->TileCount]);
+    for (uint32_t Idx = 0; Idx < RectCount; ++Idx)
+    {
+        rect_int Bounds = Job->Rects[Idx].Bounds;
+        for (int32_t TileY = Bounds.Top / SoftwareTileSize; TileY <= (Bounds.Bottom - 1) / SoftwareTileSize; ++TileY)
+        {
+            for (int32_t TileX = Bounds.Left / SoftwareTileSize; TileX <= (Bounds.Right - 1) / SoftwareTileSize; ++TileX)
+            {
+                Job->Bins[Cursors[TileY * Job->TileCountX + TileX]++] = Idx;
+            }
+        }
+    }
+
+    Renderer->RasterizedInstanceCount += RectCount;
+    Renderer->BinnedEntryCount        += Job->BinOffsets[Job->TileCount];
+    Renderer->TileCount                = Job->TileCount;
+    Renderer->DirtyTileCount           = Job->DirtyTileCount;
+}
+
+// [PER-RENDERER API]
+
+static render_handle
+InitializeRenderer(void *HWindow, vec2_int Resolution, memory_arena *Arena)
+{
+    VOID_UNUSED(HWindow);
+
+    render_handle      Result   = { 0 };
+    software_renderer *Renderer = PushArray(Arena, software_renderer, 1);
+
+    memory_arena_params Params = {};
+    Params.ReserveSize       = VOID_MEGABYTE(64);
+    Params.CommitSize        = VOID_MEGABYTE(1);
+    Params.AllocatedFromFile = __FILE__;
+    Params.AllocatedFromLine = __LINE__;
+
+    Renderer->Arena            = Arena;
+    Renderer->FramebufferArena = AllocateArena(Params);
+    Renderer->FrameArena       = AllocateArena({});
+    if (!Renderer->FramebufferArena || !Renderer->FrameArena)
+    {
+        return Result;
+    }
+
+    // The submitting thread also drains the queue, so it only needs one worker less.
+    {
+        uint32_t ProcessorCount = OSGetSystemInfo()->ProcessorCount;
+        uint32_t WorkerCount    = ProcessorCount > 1 ? ProcessorCount - 1 : 0;
+
+        Renderer->WorkQueue = PushStruct(Arena, os_work_queue);
+        if (!InitializeWorkQueue(Renderer->WorkQueue, WorkerCount))
+        {
+            return Result;
+        }
+    }
+
+    SoftwareResizeFramebuffer(Renderer, Resolution);
+
+    Result.Value[0] = (uint64_t)Renderer;
+    return Result;
+}
+
+static void
+SubmitRenderCommands(render_handle HRenderer, vec2_int Resolution, render_pass_list *RenderPassList)
+{
+    software_renderer *Renderer = SoftwareGetRenderer(HRenderer);
+
+    if(!Renderer || !RenderPassList)
+    {
+        return;
+    }
+
+    // Update State
+    if (!(Resolution == Renderer->LastResolution))
+    {
+        SoftwareResizeFramebuffer(Renderer, Resolution);
+    }
+
+    // Texture Updates
+    for (render_texture_update_node *Node = RenderPassList->FirstUpdate; Node != 0; Node = Node->Next)
+    {
+        SoftwareApplyTextureUpdate(&Node->Value);
+    }
+
+    // Binning
+    software_tile_job Job = {};
+    {
+        PopArenaTo(Renderer->FrameArena, 0);
+        SoftwareBinPassList(Renderer, RenderPassList, &Job);
+    }
+
+    // Rasterize (Tiles are cleared by whoever rasterizes them)
+    {
+        os_work_queue *Queue      = Renderer->WorkQueue;
+        uint32_t       EntryCount = Min(Queue->ThreadCount + 1, Job.DirtyTileCount);
+
+        for (uint32_t Idx = 0; Idx < EntryCount; ++Idx)
+        {
+            PushWorkEntry(Queue, SoftwareTileWorker, &Job);
+        }
+
+        CompleteAllWork(Queue);
+
+        Renderer->MustRedrawAll = false;
+    }
+
+    // Clear
+    ClearRenderPassList(RenderPassList);
+}
+
+// -----------------------------------------------------------------------------------
+// @Public: Texture API
+
+static render_handle
+CreateRenderTexture(uint16_t SizeX, uint16_t SizeY, RenderTexture Type)
+{
+    VOID_ASSERT(SizeX > 0 && SizeY > 0);
+    VOID_ASSERT(Type == RenderTexture::RGBA || Type == RenderTexture::GreyScale);
+
+    render_handle Result = RenderHandle(0);
+
+    software_renderer *Backend = SoftwareGetRenderer(RenderState.Renderer);
+    VOID_ASSERT(Backend);
+
+    if(Backend)
+    {
+        // GreyScale gathers load 4 bytes per texel, the padding keeps the last texel readable.
+        uint64_t ByteCount = (uint64_t)SizeX * SizeY * SoftwareGetBytesPerPixel(Type) + sizeof(uint32_t);
+
+        software_texture *Texture = PushStruct(Backend->Arena, software_texture);
+        Texture->Pixels = PushArrayAligned(Backend->Arena, uint8_t, ByteCount, 64);
+        Texture->Width  = SizeX;
+        Texture->Height = SizeY;
+        Texture->Format = Type;
+
+        Result = RenderHandle((uint64_t)Texture);
+    }
+
+    return Result;
+}
+
+static render_handle
+CreateRenderTextureView(render_handle TextureHandle, RenderTexture Type)
+{
+    VOID_UNUSED(Type);
+
+    render_handle Result = TextureHandle;
+    return Result;
+}
+
+// -----------------------------------------------------------------------------------
+// @Public: Software API
+
+static software_framebuffer *
+SoftwareGetFramebuffer(render_handle HRenderer)
+{
+    software_framebuffer *Result   = 0;
+    software_renderer    *Renderer = SoftwareGetRenderer(HRenderer);
+
+    if (Renderer)
+    {
+        Result = &Renderer->Framebuffer;
+    }
+
+    return Result;
+}
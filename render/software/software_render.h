@@ -0,0 +1,105 @@
+#pragma once
+
+// [Macros and linking]
+
+#include <immintrin.h>
+
+// [Core Types]
+
+// The software renderer rasterizes the UI pass on the CPU into an RGBA8 framebuffer with
+// the same layout as the D3D11 swap chain (R in the low byte). Coverage, blending and
+// sampling follow the D3D11 rect shader such that both outputs can be compared.
+
+// Mirrors ui_rect (the render layer is compiled before the UI layer).
+
+typedef struct software_rect_instance
+{
+    float    RectBounds[4];     // Left, Top, Right, Bottom
+    float    TextureSource[4];  // Left, Top, Right, Bottom
+    float    ColorTL[4];
+    float    ColorBL[4];
+    float    ColorTR[4];
+    float    ColorBR[4];
+    float    CornerRadii[4];    // TL, TR, BR, BL
+    float    BorderWidth;
+    float    Softness;
+    float    SampleTexture;     // Above 1 the texture is a distance field, with a sharpness of SampleTexture - 1
+    uint32_t ClipIndex;
+} software_rect_instance;
+
+typedef struct software_texture
+{
+    uint8_t      *Pixels;           // RGBA8 or R8 texels, see Format
+    uint16_t      Width;
+    uint16_t      Height;
+    RenderTexture Format;
+} software_texture;
+
+typedef struct software_framebuffer
+{
+    uint32_t *Pixels;
+    int32_t   Width;
+    int32_t   Height;
+    int32_t   Pitch;    // In pixels, always a multiple of SoftwareLaneWidth
+} software_framebuffer;
+
+// Instances are prepared once per frame (inverse transform, pixel bounds) and binned in
+// painter's order into square tiles. Tiles are rasterized independently on the work queue.
+// The framebuffer is kept between frames, only tiles touched by the pass list damage are
+// redrawn (and only instances overlapping those tiles are binned).
+
+typedef struct software_prepared_rect
+{
+    software_rect_instance *Rect;
+    software_texture       *Texture;
+    rect_float              Clip;
+    bool                    HasClip;
+    float                   Inverse[4];    // Inverse of the affine part, row major
+    float                   Translation[2];
+    rect_int                Bounds;        // In pixels, exclusive
+} software_prepared_rect;
+
+typedef struct software_renderer software_renderer;
+
+typedef struct software_tile_job
+{
+    software_renderer      *Renderer;
+    software_prepared_rect *Rects;
+    uint32_t               *BinOffsets;    // TileCount + 1 entries
+    uint32_t               *Bins;          // Indices in Rects, painter's order within a tile
+    uint32_t                TileCountX;
+    uint32_t                TileCount;
+    uint32_t               *DirtyTiles;
+    uint32_t                DirtyTileCount;
+    rect_int                DirtyAreas[RenderConstant_DamageCapacity];    // Snapped to tiles
+    uint32_t                DirtyAreaCount;
+    bool                    RedrawAll;
+    uint32_t volatile       NextTile;     // Index in DirtyTiles
+} software_tile_job;
+
+struct software_renderer
+{
+    memory_arena        *Arena;
+    memory_arena        *FramebufferArena;
+    memory_arena        *FrameArena;
+    os_work_queue       *WorkQueue;
+    software_framebuffer Framebuffer;
+    vec2_int             LastResolution;
+    bool                 MustRedrawAll;    // Framebuffer content is undefined (init, resize)
+
+    // Stats
+    uint64_t RasterizedInstanceCount;
+    uint64_t BinnedEntryCount;
+    uint32_t TileCount;
+    uint32_t DirtyTileCount;
+};
+
+// [Globals]
+
+const static int32_t  SoftwareLaneWidth  = 8;
+const static int32_t  SoftwareTileSize   = 64;    // Multiple of SoftwareLaneWidth
+const static uint32_t SoftwareClearColor = 0xFF000000; // Opaque black
+
+// [API]
+
+static software_framebuffer * SoftwareGetFramebuffer  (render_handle HRenderer);
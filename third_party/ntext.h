@@ -5,14 +5,22 @@
 
 #include <immintrin.h>
 #include <stdint.h>
-
-#define NTEXT_ASSERT(Cond) do {if (!(Cond)) __debugbreak();} while (0)
-#define NTEXT_ALIGNPOW2(x,b) (((x) + (b) - 1)&(~((b) - 1)))
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
 
 #ifdef _WIN32
 #define NTEXT_WIN32 1
 #endif
 
+#if NTEXT_WIN32
+#define NTEXT_ASSERT(Cond) do {if (!(Cond)) __debugbreak();} while (0)
+#else
+#define NTEXT_ASSERT(Cond) do {if (!(Cond)) __builtin_trap();} while (0)
+#endif
+#define NTEXT_ALIGNPOW2(x,b) (((x) + (b) - 1)&(~((b) - 1)))
+
 #if defined(_MSV_VER)
     #define NTEXT_MSVC 1
 #elif defined(__clang__)
@@ -49,7 +57,7 @@ static inline unsigned FindFirstBit(uint32_t Mask)
 #if NTEXT_MSVC || NTEXT_CLANG
     #define AlignOf(T) __alignof(T)
 #elif NTEXT_GNU
-    #define AlignOf(T) __alignof(T)__
+    #define AlignOf(T) __alignof__(T)
 #else
     #error "AlignOf not supported for this compiler"
 #endif
@@ -66,6 +74,9 @@ static inline unsigned FindFirstBit(uint32_t Mask)
 #include <iostream>
 
 #pragma comment(lib, "dwrite")
+#else
+#include <stdio.h>
+#include <stdlib.h>
 #endif
 
 namespace ntext
@@ -173,7 +184,7 @@ constexpr T* PushArrayAligned(memory_arena* Arena, uint64_t Count, uint64_t Alig
 template <typename T>
 constexpr T* PushArray(memory_arena* Arena, uint64_t Count)
 {
-    return PushArrayAligned<T>(Arena, Count, max(8, alignof(T)));
+    return PushArrayAligned<T>(Arena, Count, alignof(T) > 8 ? alignof(T) : 8);
 }
 
 template <typename T>
@@ -182,6 +193,83 @@ constexpr T* PushStruct(memory_arena* Arena)
     return PushArray<T>(Arena, 1);
 }
 
+// ==================================================================================
+// @Internal : Backend Types
+// Shared by every backend. Metrics are in pixels, OffsetX is relative to the pen and
+// OffsetY to the top of the line. The rasterized buffer is SizeX by SizeY coverage.
+// ==================================================================================
+
+struct os_glyph_info
+{
+    uint16_t GlyphIndex;
+
+    float Advance;
+    float OffsetX;
+    float OffsetY;
+
+    float SizeX;
+    float SizeY;
+};
+
+struct rasterized_buffer
+{
+    void    *Data;
+    uint32_t Stride;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t BytesPerPixel;
+};
+
+
+// Identifies the font file a backend loaded, glyph cache files built from another file are
+// rejected. Made from the 'head' table (big endian): checkSumAdjustment at 8 covers every
+// byte of the file and modified at 28 its date.
+
+static uint64_t
+MakeFontStamp(const uint8_t *Head, uint64_t HeadSize)
+{
+    uint64_t Result = 0;
+
+    if(Head && HeadSize >= 36)
+    {
+        uint64_t Checksum = ((uint64_t)Head[ 8] << 24) | ((uint64_t)Head[ 9] << 16) | ((uint64_t)Head[10] << 8) | Head[11];
+        uint64_t Modified = 0;
+
+        for(uint32_t Idx = 28; Idx < 36; ++Idx)
+        {
+            Modified = (Modified << 8) | Head[Idx];
+        }
+
+        Result = (Checksum << 32) ^ (Modified * 0x9E3779B97F4A7C15ull);
+    }
+
+    return Result;
+}
+
+
+// Fixed pitch fonts advance every glyph by the same amount. Tables are big endian: 'post'
+// flags them with isFixedPitch at 12, which many fonts leave unset. The PANOSE bytes of
+// 'OS/2' at 32 then say Latin Text (2) with a Monospaced (9) proportion.
+
+static bool
+IsFixedPitchFont(const uint8_t *Post, uint64_t PostSize, const uint8_t *OS2, uint64_t OS2Size)
+{
+    bool Result = false;
+
+    if(Post && PostSize >= 16)
+    {
+        Result = (Post[12] | Post[13] | Post[14] | Post[15]) != 0;
+    }
+
+    if(OS2 && OS2Size >= 36)
+    {
+        Result = Result || (OS2[32] == 2 && OS2[35] == 9);
+    }
+
+    return Result;
+}
+
+
 // ==================================================================================
 // @Internal : Win32 Implementation
 // Placeholder: DirectWrite integration & rasterization helpers
@@ -189,6 +277,10 @@ constexpr T* PushStruct(memory_arena* Arena)
 
 #ifdef NTEXT_WIN32
 
+// Define NTEXT_DEBUG_DUMP_GLYPHS to write every rasterized glyph to glyph_alpha_N.bmp in the
+// working directory. Debug only: it writes a file per glyph.
+
+#if NTEXT_DEBUG_DUMP_GLYPHS
 static bool WriteGrayscaleBMP(const wchar_t *path, int w, int h, BYTE *Pixels)
 {
     if (w <= 0 || h <= 0) return false;
@@ -247,28 +339,7 @@ static bool WriteGrayscaleBMP(const wchar_t *path, int w, int h, BYTE *Pixels)
     f.close();
     return true;
 }
-
-
-struct os_glyph_info
-{
-    uint16_t GlyphIndex;
-
-    float Advance;
-    float OffsetX;
-    float OffsetY;
-
-    float SizeX;
-    float SizeY;
-};
-
-struct rasterized_buffer
-{
-    void    *Data;
-    uint32_t Stride;
-    uint32_t Width;
-    uint32_t Height;
-    uint32_t BytesPerPixel;
-};
+#endif
 
 
 struct backend_context
@@ -280,10 +351,14 @@ struct backend_context
 
     IDWriteFactory  *DirectWrite;
     IDWriteFontFace *Font;
+    uint64_t         FontStamp;
+    bool             IsFixedPitch;
 };
 
 
-static backend_context CreateBackendContext(void)
+// FamilyName is a UTF-8 system family name, Segoe UI is used when it is null or not found.
+
+static backend_context CreateBackendContext(const char *FamilyName)
 {
     backend_context Context = {};
 
@@ -296,10 +371,19 @@ static backend_context CreateBackendContext(void)
     DirectWrite->GetSystemFontCollection(&Fonts);
     NTEXT_ASSERT(Fonts);
 
-    UINT32 FamilyIndex = 0;
-    BOOL   Exists      = FALSE;
-    const wchar_t *FamilyToFind = L"Segoe UI";
-    Fonts->FindFamilyName(FamilyToFind, &FamilyIndex, &Exists);
+    UINT32  FamilyIndex = 0;
+    BOOL    Exists      = FALSE;
+    wchar_t FamilyToFind[128] = {};
+
+    if(FamilyName && MultiByteToWideChar(CP_UTF8, 0, FamilyName, -1, FamilyToFind, 128))
+    {
+        Fonts->FindFamilyName(FamilyToFind, &FamilyIndex, &Exists);
+    }
+
+    if(!Exists)
+    {
+        Fonts->FindFamilyName(L"Segoe UI", &FamilyIndex, &Exists);
+    }
     NTEXT_ASSERT(Exists);
 
     IDWriteFontFamily *Family;
@@ -320,6 +404,35 @@ static backend_context CreateBackendContext(void)
     Context.DirectWrite = DirectWrite;
     Context.Font        = FontFace;
 
+    const void *HeadData    = 0;
+    UINT32      HeadSize    = 0;
+    void       *HeadContext = 0;
+    BOOL        HeadExists  = FALSE;
+
+    if(SUCCEEDED(FontFace->TryGetFontTable(DWRITE_MAKE_OPENTYPE_TAG('h', 'e', 'a', 'd'), &HeadData, &HeadSize, &HeadContext, &HeadExists)) && HeadExists)
+    {
+        Context.FontStamp = MakeFontStamp(static_cast<const uint8_t *>(HeadData), HeadSize);
+        FontFace->ReleaseFontTable(HeadContext);
+    }
+
+    const void *PostData    = 0;
+    UINT32      PostSize    = 0;
+    void       *PostContext = 0;
+    BOOL        PostExists  = FALSE;
+    const void *OS2Data     = 0;
+    UINT32      OS2Size     = 0;
+    void       *OS2Context  = 0;
+    BOOL        OS2Exists   = FALSE;
+
+    FontFace->TryGetFontTable(DWRITE_MAKE_OPENTYPE_TAG('p', 'o', 's', 't'), &PostData, &PostSize, &PostContext, &PostExists);
+    FontFace->TryGetFontTable(DWRITE_MAKE_OPENTYPE_TAG('O', 'S', '/', '2'), &OS2Data , &OS2Size , &OS2Context , &OS2Exists );
+
+    Context.IsFixedPitch = IsFixedPitchFont(PostExists ? static_cast<const uint8_t *>(PostData) : 0, PostSize,
+                                            OS2Exists  ? static_cast<const uint8_t *>(OS2Data)  : 0, OS2Size);
+
+    if(PostExists) FontFace->ReleaseFontTable(PostContext);
+    if(OS2Exists)  FontFace->ReleaseFontTable(OS2Context);
+
     return Context;
 }
 
@@ -429,10 +542,16 @@ backend_context::RasterizeGlyphToAlphaTexture(uint16_t GlyphIndex, float Advance
                 }
             }
 
-             static int Counter = 0;
-             wchar_t OutPath[64];
-             swprintf(OutPath, 64, L"glyph_alpha_%d.bmp", Counter++);
-             WriteGrayscaleBMP(OutPath, TextureWidth, TextureHeight, Buffer);
+#if NTEXT_DEBUG_DUMP_GLYPHS
+            if(Result.Data)
+            {
+                static volatile LONG Counter = 0;
+
+                wchar_t OutPath[64];
+                swprintf(OutPath, 64, L"glyph_alpha_%ld.bmp", InterlockedIncrement(&Counter));
+                WriteGrayscaleBMP(OutPath, TextureWidth, TextureHeight, Buffer);
+            }
+#endif
         }
 
         RunAnalysis->Release();
@@ -446,928 +565,3206 @@ backend_context::RasterizeGlyphToAlphaTexture(uint16_t GlyphIndex, float Advance
 
 
 // ==================================================================================
-// @Internal : Rectangle Packing
-// Placeholder: rectangle packing utilities
+// @Internal : Portable Implementation
+// Reads TrueType outlines (glyf) from a font file and rasterizes them with an analytic
+// coverage rasterizer: every edge adds its signed area to an accumulation buffer which
+// is then prefix summed. CFF outlines are not supported, such fonts are invalid.
+//
+// The font is the file named by the family name when it is a path, otherwise NTEXT_FONT_PATH
+// if set, otherwise the first default path which exists.
 // ==================================================================================
 
-struct point
-{
-    uint16_t X;
-    uint16_t Y;
-};
-
+#ifndef NTEXT_WIN32
 
-struct rectangle_packer
+static const char *DefaultFontPaths[] =
 {
-    point    *Skyline;
-    uint16_t  SkylineCount;
-    uint16_t  Width;
-    uint16_t  Height;
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",
+    "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+    "/usr/share/fonts/truetype/noto/NotoSans-Regular.ttf",
+    "/System/Library/Fonts/Supplemental/Arial.ttf",
 };
 
 
-struct packed_rectangle
+struct backend_context
 {
-    uint16_t Width;
-    uint16_t Height;
-
-    uint16_t X;
-    uint16_t Y;
-    bool     WasPacked;
-};
+    bool              IsValid                       ();
 
+    os_glyph_info     FindGlyphInformation          (uint32_t CodePointer, float FontSize);
+    rasterized_buffer RasterizeGlyphToAlphaTexture  (uint16_t GlyphIndex, float Advance, float EmSize, memory_arena *Arena);
 
-struct rectangle
-{
-    float Left;
-    float Top;
-    float Right;
-    float Bottom;
+    uint8_t *Data;
+    uint32_t Size;
+
+    // Table offsets in Data
+    uint32_t CMap;            // Unicode subtable, format 4 or 12
+    uint32_t Glyf;
+    uint32_t Loca;
+    uint32_t HMtx;
+
+    uint16_t CMapFormat;
+    uint16_t LongLoca;
+    uint16_t MetricCount;
+    uint16_t GlyphCount;
+    uint16_t UnitsPerEm;
+    int16_t  Ascender;
+    uint64_t FontStamp;
+    bool     IsFixedPitch;
 };
 
 
-static uint64_t
-GetRectanglePackerFootprint(uint16_t Width)
+// Big endian reads, out of bounds reads return 0 such that broken fonts draw nothing.
+
+static uint32_t
+ReadFontU32(backend_context &Context, uint32_t Offset)
 {
-    uint64_t SkylineSize = Width * sizeof(point);
-    uint64_t Result      = sizeof(rectangle_packer) + SkylineSize;
+    uint32_t Result = 0;
+
+    if((uint64_t)Offset + 4 <= Context.Size)
+    {
+        uint8_t *At = Context.Data + Offset;
+        Result = ((uint32_t)At[0] << 24) | ((uint32_t)At[1] << 16) | ((uint32_t)At[2] << 8) | At[3];
+    }
 
     return Result;
 }
 
 
-static rectangle_packer *
-PlaceRectanglePackerInMemory(uint16_t Width, uint16_t Height, void *Memory)
+static uint16_t
+ReadFontU16(backend_context &Context, uint32_t Offset)
 {
-    rectangle_packer *Result = 0;
+    uint16_t Result = 0;
 
-    if(Memory)
+    if((uint64_t)Offset + 2 <= Context.Size)
     {
-        point *Skyline = (point *)Memory;
-
-        Result = (rectangle_packer *)(Skyline + Width);
-        Result->Width        = Width;
-        Result->Height       = Height;
-        Result->Skyline      = Skyline;
-        Result->SkylineCount = 1;
-        Result->Skyline[0].X = 0;
-        Result->Skyline[0].Y = 0;
+        uint8_t *At = Context.Data + Offset;
+        Result = (uint16_t)((At[0] << 8) | At[1]);
     }
 
     return Result;
 }
 
 
-static void
-PackRectangle(packed_rectangle &Rectangle, rectangle_packer *Packer)
+static int16_t
+ReadFontI16(backend_context &Context, uint32_t Offset)
 {
-    NTEXT_ASSERT(Packer);
+    int16_t Result = (int16_t)ReadFontU16(Context, Offset);
+    return Result;
+}
 
-    uint16_t Width  = Rectangle.Width;
-    uint16_t Height = Rectangle.Height;
 
-    if(Width == 0 || Height == 0)
+static uint32_t
+FindFontTable(backend_context &Context, uint32_t FontOffset, const char *Tag)
+{
+    uint32_t Result     = 0;
+    uint32_t TagValue   = ((uint32_t)Tag[0] << 24) | ((uint32_t)Tag[1] << 16) | ((uint32_t)Tag[2] << 8) | (uint32_t)Tag[3];
+    uint16_t TableCount = ReadFontU16(Context, FontOffset + 4);
+
+    for(uint32_t Idx = 0; Idx < TableCount; ++Idx)
     {
-        return;
+        uint32_t Record = FontOffset + 12 + Idx * 16;
+        if(ReadFontU32(Context, Record) == TagValue)
+        {
+            Result = ReadFontU32(Context, Record + 8);
+            break;
+        }
     }
 
-    uint16_t BestIndexInclusive = UINT16_MAX;
-    uint16_t BestIndexExclusive = UINT16_MAX;
-    point    BestPoint          = {UINT16_MAX, UINT16_MAX};
+    return Result;
+}
 
-    NTEXT_ASSERT(Packer->SkylineCount);
 
-    for(uint16_t Idx = 0; Idx < Packer->SkylineCount; ++Idx)
+// Prefers the full repertoire subtable (format 12) over the BMP one (format 4).
+
+static void
+FindUnicodeCMap(backend_context &Context, uint32_t CMap)
+{
+    uint16_t SubtableCount = ReadFontU16(Context, CMap + 2);
+
+    for(uint32_t Idx = 0; Idx < SubtableCount; ++Idx)
     {
-        point Point = Packer->Skyline[Idx];
+        uint32_t Record   = CMap + 4 + Idx * 8;
+        uint16_t Platform = ReadFontU16(Context, Record + 0);
+        uint16_t Encoding = ReadFontU16(Context, Record + 2);
+        uint32_t Subtable = CMap + ReadFontU32(Context, Record + 4);
+        uint16_t Format   = ReadFontU16(Context, Subtable);
 
-        // If on the current skyline we do not have horizontal space, then we can break since the array is sorted left to right.
-        if(Width > Packer->Width - Point.X)
+        bool IsUnicode = (Platform == 0) || (Platform == 3 && (Encoding == 1 || Encoding == 10));
+
+        if(IsUnicode && Format == 12)
         {
-            break;
+            Context.CMap       = Subtable;
+            Context.CMapFormat = 12;
         }
-
-        // If the current skyline is taller than our BestY, then we simply continue since we are trying to place bottom->top
-        if(Point.Y >= BestPoint.Y)
+        else if(IsUnicode && Format == 4 && Context.CMapFormat != 12)
         {
-            continue;
+            Context.CMap       = Subtable;
+            Context.CMapFormat = 4;
         }
+    }
+}
 
-        uint16_t XMax           = Point.X + Width;
-        uint16_t IndexExclusive = 0;
-        for(IndexExclusive = Idx + 1; IndexExclusive < Packer->SkylineCount; ++IndexExclusive)
-        {
-            // XMax is the right edge of the current rectangle. If it is smaller or equal then we know that
-            // there is no way to intersect on the X axis anymore, because the skylines are sorted from left to right.
-            if(XMax <= Packer->Skyline[IndexExclusive].X)
-            {
-                break;
-            }
 
-            // At this point, we know we are intersecting on the X axis, thus we need to raise the skyline,
-            // which is what creates dead space. As long as we intersect on the X axis, we have to continue raising the
-            // point.
-            if(Point.Y < Packer->Skyline[IndexExclusive].Y)
-            {
-                Point.Y = Packer->Skyline[IndexExclusive].Y;
-            }
-        }
+static backend_context CreateBackendContext(const char *FamilyName)
+{
+    backend_context Context = {};
 
-        // Then it's a worse point than our current best.
-        if(Point.Y >= BestPoint.Y)
-        {
-            continue;
-        }
+    // There is no font discovery: only names which look like a path are opened.
 
-        // Not enough vertical space to store this rectangle.
-        if(Height > Packer->Height - Point.Y)
-        {
-            continue;
-        }
+    bool  IsPath = FamilyName && (strchr(FamilyName, '/') || strchr(FamilyName, '\\') || strchr(FamilyName, '.'));
+    FILE *File   = IsPath ? fopen(FamilyName, "rb") : 0;
 
-        BestIndexInclusive = Idx;
-        BestIndexExclusive = IndexExclusive;
-        BestPoint          = Point;
+    if(!File)
+    {
+        const char *Path = getenv("NTEXT_FONT_PATH");
+        File = Path ? fopen(Path, "rb") : 0;
     }
 
-    // Could not pack the rectangle.
-    if(BestIndexInclusive == UINT16_MAX)
+    for(uint32_t Idx = 0; !File && Idx < sizeof(DefaultFontPaths) / sizeof(DefaultFontPaths[0]); ++Idx)
     {
-        return;
+        File = fopen(DefaultFontPaths[Idx], "rb");
     }
 
-    NTEXT_ASSERT(BestIndexInclusive < BestIndexExclusive);
-    NTEXT_ASSERT(BestIndexExclusive > 0);
-
-    uint16_t RemovedCount = BestIndexExclusive - BestIndexInclusive;
-    NTEXT_ASSERT(RemovedCount > 0);
-
-    // To create the top left point, we use the best point we found and raise it by the height of the rectangle.
-    // To create the bot right point, we use the right edge of the triangle we are placing and the last overlapping skyline y
-    // coordinate. This ensures that the skyline goes from left to right.
+    if(!File)
+    {
+        return Context;
+    }
 
-    point NewTopLeft  = {BestPoint.X                               , static_cast<uint16_t>(BestPoint.Y + Height)};
-    point NewBotRight = {static_cast<uint16_t>(BestPoint.X + Width), Packer->Skyline[BestIndexExclusive - 1].Y};
+    fseek(File, 0, SEEK_END);
+    long Size = ftell(File);
+    fseek(File, 0, SEEK_SET);
 
-    // To know if we are creating a new skyline from the bottom right point, we need to check multiple cases.
-    // If the first exclusive point is a valid index, then we simply check: if (smaller) new point else no.
-    // If the first exclusive point is not a valid index, then we simply check: if(not_on_boundary) new point
+    if(Size > 12)
+    {
+        Context.Data = static_cast<uint8_t *>(malloc((size_t)Size));
+        Context.Size = (uint32_t)Size;
 
-    bool HasBottomRightPoint = BestIndexExclusive < Packer->SkylineCount ?
-        NewBotRight.X < Packer->Skyline[BestIndexExclusive].X :
-        NewBotRight.X < Packer->Width;
+        if(Context.Data && fread(Context.Data, 1, (size_t)Size, File) != (size_t)Size)
+        {
+            free(Context.Data);
+            Context.Data = 0;
+        }
+    }
 
-    uint16_t InsertedCount = 1 + HasBottomRightPoint;
-    NTEXT_ASSERT(Packer->SkylineCount + InsertedCount - RemovedCount <= Packer->Width);
+    fclose(File);
 
-    if(InsertedCount > RemovedCount)
+    if(Context.Data)
     {
-        // Copy from the last element to the exclusive index.
-        // Make space for the new elements by shifting end by (InsertedCount - RemovedCount)
-        // This grows the array.
+        // Collections use their first font.
 
-        uint16_t Start = Packer->SkylineCount - 1;
+        uint32_t FontOffset = 0;
+        if(ReadFontU32(Context, 0) == 0x74746366) // 'ttcf'
+        {
+            FontOffset = ReadFontU32(Context, 12);
+        }
+
+        uint32_t Head = FindFontTable(Context, FontOffset, "head");
+        uint32_t HHea = FindFontTable(Context, FontOffset, "hhea");
+        uint32_t MaxP = FindFontTable(Context, FontOffset, "maxp");
+        uint32_t CMap = FindFontTable(Context, FontOffset, "cmap");
+        uint32_t Post = FindFontTable(Context, FontOffset, "post");
+        uint32_t OS2  = FindFontTable(Context, FontOffset, "OS/2");
+
+        Context.Glyf        = FindFontTable(Context, FontOffset, "glyf");
+        Context.Loca        = FindFontTable(Context, FontOffset, "loca");
+        Context.HMtx        = FindFontTable(Context, FontOffset, "hmtx");
+        Context.UnitsPerEm  = ReadFontU16(Context, Head + 18);
+        Context.LongLoca    = ReadFontU16(Context, Head + 50);
+        Context.Ascender    = ReadFontI16(Context, HHea + 4);
+        Context.MetricCount = ReadFontU16(Context, HHea + 34);
+        Context.GlyphCount  = ReadFontU16(Context, MaxP + 4);
+        Context.FontStamp   = (Head && Head < Context.Size) ? MakeFontStamp(Context.Data + Head, Context.Size - Head) : 0;
+
+        const uint8_t *PostData = (Post && Post < Context.Size) ? Context.Data + Post : 0;
+        const uint8_t *OS2Data  = (OS2  && OS2  < Context.Size) ? Context.Data + OS2  : 0;
+
+        Context.IsFixedPitch = IsFixedPitchFont(PostData, PostData ? Context.Size - Post : 0, OS2Data, OS2Data ? Context.Size - OS2 : 0);
+
+        if(Head && HHea && MaxP && CMap)
+        {
+            FindUnicodeCMap(Context, CMap);
+        }
+    }
+
+    return Context;
+}
+
+
+bool backend_context::IsValid()
+{
+    bool Result = (this->Data) && (this->CMap) && (this->Glyf) && (this->Loca) && (this->HMtx) && (this->UnitsPerEm) && (this->MetricCount);
+    return Result;
+}
+
+
+static uint16_t
+FindGlyphIndex(backend_context &Context, uint32_t CodePoint)
+{
+    uint16_t Result = 0;
+    uint32_t CMap   = Context.CMap;
+
+    if(Context.CMapFormat == 12)
+    {
+        uint32_t GroupCount = ReadFontU32(Context, CMap + 12);
+        uint32_t Low        = 0;
+        uint32_t High       = GroupCount;
+
+        while(Low < High)
+        {
+            uint32_t Mid   = (Low + High) / 2;
+            uint32_t Group = CMap + 16 + Mid * 12;
+            uint32_t Start = ReadFontU32(Context, Group + 0);
+            uint32_t End   = ReadFontU32(Context, Group + 4);
+
+            if(CodePoint < Start)
+            {
+                High = Mid;
+            }
+            else if(CodePoint > End)
+            {
+                Low = Mid + 1;
+            }
+            else
+            {
+                Result = (uint16_t)(ReadFontU32(Context, Group + 8) + (CodePoint - Start));
+                break;
+            }
+        }
+    }
+    else if(Context.CMapFormat == 4 && CodePoint <= 0xFFFF)
+    {
+        uint32_t SegmentCount = ReadFontU16(Context, CMap + 6) / 2;
+        uint32_t EndCodes     = CMap + 14;
+        uint32_t StartCodes   = EndCodes   + SegmentCount * 2 + 2;
+        uint32_t Deltas       = StartCodes + SegmentCount * 2;
+        uint32_t RangeOffsets = Deltas     + SegmentCount * 2;
+
+        // Segments are sorted by end code, find the first one which ends after CodePoint.
+
+        uint32_t Low  = 0;
+        uint32_t High = SegmentCount;
+        while(Low < High)
+        {
+            uint32_t Mid = (Low + High) / 2;
+            if(ReadFontU16(Context, EndCodes + Mid * 2) < CodePoint)
+            {
+                Low = Mid + 1;
+            }
+            else
+            {
+                High = Mid;
+            }
+        }
+
+        if(Low < SegmentCount && ReadFontU16(Context, StartCodes + Low * 2) <= CodePoint)
+        {
+            uint16_t Start       = ReadFontU16(Context, StartCodes   + Low * 2);
+            uint16_t Delta       = ReadFontU16(Context, Deltas       + Low * 2);
+            uint16_t RangeOffset = ReadFontU16(Context, RangeOffsets + Low * 2);
+
+            if(RangeOffset == 0)
+            {
+                Result = (uint16_t)(CodePoint + Delta);
+            }
+            else
+            {
+                uint16_t Glyph = ReadFontU16(Context, RangeOffsets + Low * 2 + RangeOffset + (CodePoint - Start) * 2);
+                Result = Glyph ? (uint16_t)(Glyph + Delta) : 0;
+            }
+        }
+    }
+
+    return Result;
+}
+
+
+// Returns the offset of the glyph in glyf, 0 for glyphs without an outline.
+
+static uint32_t
+FindGlyphOutline(backend_context &Context, uint16_t GlyphIndex)
+{
+    uint32_t Result = 0;
+
+    if(GlyphIndex < Context.GlyphCount)
+    {
+        uint32_t Start = 0;
+        uint32_t End   = 0;
+
+        if(Context.LongLoca)
+        {
+            Start = ReadFontU32(Context, Context.Loca + GlyphIndex * 4);
+            End   = ReadFontU32(Context, Context.Loca + GlyphIndex * 4 + 4);
+        }
+        else
+        {
+            Start = ReadFontU16(Context, Context.Loca + GlyphIndex * 2) * 2;
+            End   = ReadFontU16(Context, Context.Loca + GlyphIndex * 2 + 2) * 2;
+        }
+
+        if(End > Start)
+        {
+            Result = Context.Glyf + Start;
+        }
+    }
+
+    return Result;
+}
+
+
+// The pixel box of a glyph. Both FindGlyphInformation and the rasterizer derive it from
+// the glyph header such that the packed rectangle always matches the rasterized buffer.
+
+struct glyph_pixel_box
+{
+    int32_t X0;
+    int32_t Y0;
+    int32_t X1;
+    int32_t Y1;
+};
+
+
+static glyph_pixel_box
+GetGlyphPixelBox(backend_context &Context, uint32_t Outline, float Scale)
+{
+    glyph_pixel_box Result = {};
+
+    if(Outline)
+    {
+        Result.X0 = (int32_t)floorf( ReadFontI16(Context, Outline + 2) * Scale);
+        Result.Y0 = (int32_t)floorf(-ReadFontI16(Context, Outline + 8) * Scale);
+        Result.X1 = (int32_t)ceilf ( ReadFontI16(Context, Outline + 6) * Scale);
+        Result.Y1 = (int32_t)ceilf (-ReadFontI16(Context, Outline + 4) * Scale);
+
+        if(Result.X1 <= Result.X0 || Result.Y1 <= Result.Y0)
+        {
+            Result = {};
+        }
+    }
+
+    return Result;
+}
+
+
+os_glyph_info
+backend_context::FindGlyphInformation(uint32_t CodePoint, float EmSize)
+{
+    os_glyph_info Result = {};
+
+    if(!this->IsValid())
+    {
+        return Result;
+    }
+
+    uint16_t GlyphIndex  = FindGlyphIndex(*this, CodePoint);
+    uint16_t MetricIndex = GlyphIndex < this->MetricCount ? GlyphIndex : this->MetricCount - 1;
+    float    Scale       = EmSize / (float)this->UnitsPerEm;
+
+    glyph_pixel_box Box = GetGlyphPixelBox(*this, FindGlyphOutline(*this, GlyphIndex), Scale);
+
+    Result.GlyphIndex = GlyphIndex;
+    Result.Advance    = ReadFontU16(*this, this->HMtx + MetricIndex * 4) * Scale;
+    Result.OffsetX    = (float)Box.X0;
+    Result.OffsetY    = this->Ascender * Scale + (float)Box.Y0;
+    Result.SizeX      = (float)(Box.X1 - Box.X0);
+    Result.SizeY      = (float)(Box.Y1 - Box.Y0);
+
+    return Result;
+}
+
+
+// Outline transform from font units to the pixel space of the buffer.
+
+struct outline_transform
+{
+    float XX, XY;
+    float YX, YY;
+    float DX, DY;
+};
+
+
+struct coverage_buffer
+{
+    float  *Accumulation;    // Width * Height + 2 entries, edges on the right border touch the next row
+    int32_t Width;
+    int32_t Height;
+};
+
+
+// Adds the signed area covered by the edge to the cells it crosses, the area to the right
+// of the edge is carried by the next cell and resolved by the prefix sum.
+
+static void
+AccumulateEdge(coverage_buffer &Buffer, float X0, float Y0, float X1, float Y1)
+{
+    if(Y0 == Y1)
+    {
+        return;
+    }
+
+    float Direction = 1.f;
+    if(Y0 > Y1)
+    {
+        float T;
+        T = X0; X0 = X1; X1 = T;
+        T = Y0; Y0 = Y1; Y1 = T;
+        Direction = -1.f;
+    }
+
+    float   Slope = (X1 - X0) / (Y1 - Y0);
+    float   X     = X0;
+    int32_t Row   = (int32_t)Y0;
+    int32_t Last  = (int32_t)ceilf(Y1);
+
+    if(Last > Buffer.Height)
+    {
+        Last = Buffer.Height;
+    }
+
+    for(; Row < Last; ++Row)
+    {
+        float *Cells = Buffer.Accumulation + Row * Buffer.Width;
+        float  Top   = (float)Row     > Y0 ? (float)Row     : Y0;
+        float  Bot   = (float)Row + 1 < Y1 ? (float)Row + 1 : Y1;
+        float  Cover = (Bot - Top) * Direction;
+        float  XNext = X + Slope * (Bot - Top);
+
+        float Left  = X < XNext ? X : XNext;
+        float Right = X < XNext ? XNext : X;
+
+        float   LeftFloor = floorf(Left);
+        int32_t LeftCell  = (int32_t)LeftFloor;
+        int32_t RightCell = (int32_t)ceilf(Right);
+
+        if(RightCell <= LeftCell + 1)
+        {
+            // The edge stays in one cell: split the cover at its mean position.
+            float Mid = 0.5f * (X + XNext) - LeftFloor;
+
+            Cells[LeftCell    ] += Cover * (1.f - Mid);
+            Cells[LeftCell + 1] += Cover * Mid;
+        }
+        else
+        {
+            float InvWidth  = 1.f / (Right - Left);
+            float LeftFrac  = Left - LeftFloor;
+            float RightFrac = Right - (float)RightCell + 1.f;
+            float AreaFirst = 0.5f * InvWidth * (1.f - LeftFrac) * (1.f - LeftFrac);
+            float AreaLast  = 0.5f * InvWidth * RightFrac * RightFrac;
+
+            Cells[LeftCell] += Cover * AreaFirst;
+
+            if(RightCell == LeftCell + 2)
+            {
+                Cells[LeftCell + 1] += Cover * (1.f - AreaFirst - AreaLast);
+            }
+            else
+            {
+                float AreaSecond = InvWidth * (1.5f - LeftFrac);
+                Cells[LeftCell + 1] += Cover * (AreaSecond - AreaFirst);
+
+                for(int32_t Cell = LeftCell + 2; Cell < RightCell - 1; ++Cell)
+                {
+                    Cells[Cell] += Cover * InvWidth;
+                }
+
+                float AreaBeforeLast = AreaSecond + (float)(RightCell - LeftCell - 3) * InvWidth;
+                Cells[RightCell - 1] += Cover * (1.f - AreaBeforeLast - AreaLast);
+            }
+
+            Cells[RightCell] += Cover * AreaLast;
+        }
+
+        X = XNext;
+    }
+}
+
+
+static void
+AccumulateLine(coverage_buffer &Buffer, float X0, float Y0, float X1, float Y1)
+{
+    // Rounding may push points slightly outside of the box.
+    float Width  = (float)Buffer.Width;
+    float Height = (float)Buffer.Height;
+
+    X0 = X0 < 0.f ? 0.f : (X0 > Width  ? Width  : X0);
+    X1 = X1 < 0.f ? 0.f : (X1 > Width  ? Width  : X1);
+    Y0 = Y0 < 0.f ? 0.f : (Y0 > Height ? Height : Y0);
+    Y1 = Y1 < 0.f ? 0.f : (Y1 > Height ? Height : Y1);
+
+    AccumulateEdge(Buffer, X0, Y0, X1, Y1);
+}
+
+
+// Quadratic curves are flattened, the segment count grows with the curvature.
+
+static void
+AccumulateCurve(coverage_buffer &Buffer, float X0, float Y0, float CX, float CY, float X1, float Y1)
+{
+    float DX       = X0 - 2.f * CX + X1;
+    float DY       = Y0 - 2.f * CY + Y1;
+    int   Segments = 1 + (int)sqrtf(sqrtf(DX * DX + DY * DY) * 4.f);
+
+    if(Segments > 16)
+    {
+        Segments = 16;
+    }
+
+    float PrevX = X0;
+    float PrevY = Y0;
+    for(int Idx = 1; Idx <= Segments; ++Idx)
+    {
+        float T    = (float)Idx / (float)Segments;
+        float U    = 1.f - T;
+        float NewX = U * U * X0 + 2.f * U * T * CX + T * T * X1;
+        float NewY = U * U * Y0 + 2.f * U * T * CY + T * T * Y1;
+
+        AccumulateLine(Buffer, PrevX, PrevY, NewX, NewY);
+
+        PrevX = NewX;
+        PrevY = NewY;
+    }
+}
+
+
+enum GlyphPoint_Flag
+{
+    GlyphPoint_OnCurve = 1 << 0,
+    GlyphPoint_XShort  = 1 << 1,
+    GlyphPoint_YShort  = 1 << 2,
+    GlyphPoint_Repeat  = 1 << 3,
+    GlyphPoint_XSame   = 1 << 4,
+    GlyphPoint_YSame   = 1 << 5,
+};
+
+
+static void
+AccumulateSimpleGlyph(backend_context &Context, uint32_t Outline, outline_transform Transform, coverage_buffer &Buffer, memory_arena *Arena)
+{
+    int16_t ContourCount = ReadFontI16(Context, Outline);
+    if(ContourCount <= 0)
+    {
+        return;
+    }
+
+    uint32_t EndPoints   = Outline + 10;
+    uint32_t PointCount  = (uint32_t)ReadFontU16(Context, EndPoints + (ContourCount - 1) * 2) + 1;
+    uint32_t Instruction = EndPoints + ContourCount * 2;
+    uint32_t At          = Instruction + 2 + ReadFontU16(Context, Instruction);
+
+    memory_region Region = EnterMemoryRegion(Arena);
+
+    uint8_t *Flags  = PushArrayNoZeroAligned<uint8_t>(Arena, PointCount, 1);
+    float   *PointX = PushArrayNoZeroAligned<float  >(Arena, PointCount, alignof(float));
+    float   *PointY = PushArrayNoZeroAligned<float  >(Arena, PointCount, alignof(float));
+
+    if(Flags && PointX && PointY)
+    {
+        for(uint32_t Idx = 0; Idx < PointCount;)
+        {
+            uint8_t Flag   = At < Context.Size ? Context.Data[At] : 0;
+            uint8_t Repeat = 0;
+            At += 1;
+
+            if(Flag & GlyphPoint_Repeat)
+            {
+                Repeat = At < Context.Size ? Context.Data[At] : 0;
+                At += 1;
+            }
+
+            for(uint32_t Count = 0; Count <= Repeat && Idx < PointCount; ++Count)
+            {
+                Flags[Idx++] = Flag;
+            }
+        }
+
+        // Coordinates are deltas, X for every point then Y for every point.
+
+        int32_t Value = 0;
+        for(uint32_t Idx = 0; Idx < PointCount; ++Idx)
+        {
+            uint8_t Flag = Flags[Idx];
+            if(Flag & GlyphPoint_XShort)
+            {
+                int32_t Delta = At < Context.Size ? Context.Data[At] : 0;
+                Value += (Flag & GlyphPoint_XSame) ? Delta : -Delta;
+                At    += 1;
+            }
+            else if(!(Flag & GlyphPoint_XSame))
+            {
+                Value += ReadFontI16(Context, At);
+                At    += 2;
+            }
+            PointX[Idx] = (float)Value;
+        }
+
+        Value = 0;
+        for(uint32_t Idx = 0; Idx < PointCount; ++Idx)
+        {
+            uint8_t Flag = Flags[Idx];
+            if(Flag & GlyphPoint_YShort)
+            {
+                int32_t Delta = At < Context.Size ? Context.Data[At] : 0;
+                Value += (Flag & GlyphPoint_YSame) ? Delta : -Delta;
+                At    += 1;
+            }
+            else if(!(Flag & GlyphPoint_YSame))
+            {
+                Value += ReadFontI16(Context, At);
+                At    += 2;
+            }
+            PointY[Idx] = (float)Value;
+        }
+
+        for(uint32_t Idx = 0; Idx < PointCount; ++Idx)
+        {
+            float X = PointX[Idx];
+            float Y = PointY[Idx];
+
+            PointX[Idx] = Transform.XX * X + Transform.YX * Y + Transform.DX;
+            PointY[Idx] = Transform.XY * X + Transform.YY * Y + Transform.DY;
+        }
+
+        // Walk every contour. Two consecutive off curve points imply an on curve point
+        // half way, the walk starts on an on curve point (or the implied one).
+
+        uint32_t First = 0;
+        for(int32_t Contour = 0; Contour < ContourCount; ++Contour)
+        {
+            uint32_t Last = ReadFontU16(Context, EndPoints + Contour * 2);
+            if(Last >= PointCount || Last < First)
+            {
+                break;
+            }
+
+            uint32_t Count = Last - First + 1;
+            float    StartX, StartY;
+            uint32_t Offset = 0;
+
+            if(Flags[First] & GlyphPoint_OnCurve)
+            {
+                StartX = PointX[First];
+                StartY = PointY[First];
+                Offset = 1;
+            }
+            else if(Flags[Last] & GlyphPoint_OnCurve)
+            {
+                StartX = PointX[Last];
+                StartY = PointY[Last];
+            }
+            else
+            {
+                StartX = 0.5f * (PointX[First] + PointX[Last]);
+                StartY = 0.5f * (PointY[First] + PointY[Last]);
+            }
+
+            float PenX       = StartX;
+            float PenY       = StartY;
+            bool  HasControl = false;
+            float ControlX   = 0.f;
+            float ControlY   = 0.f;
+
+            for(uint32_t Step = 0; Step < Count; ++Step)
+            {
+                uint32_t Idx = First + (Offset + Step) % Count;
+                float    X   = PointX[Idx];
+                float    Y   = PointY[Idx];
+
+                if(Flags[Idx] & GlyphPoint_OnCurve)
+                {
+                    if(HasControl)
+                    {
+                        AccumulateCurve(Buffer, PenX, PenY, ControlX, ControlY, X, Y);
+                    }
+                    else
+                    {
+                        AccumulateLine(Buffer, PenX, PenY, X, Y);
+                    }
+
+                    PenX       = X;
+                    PenY       = Y;
+                    HasControl = false;
+                }
+                else
+                {
+                    if(HasControl)
+                    {
+                        float MidX = 0.5f * (ControlX + X);
+                        float MidY = 0.5f * (ControlY + Y);
+
+                        AccumulateCurve(Buffer, PenX, PenY, ControlX, ControlY, MidX, MidY);
+
+                        PenX = MidX;
+                        PenY = MidY;
+                    }
+
+                    ControlX   = X;
+                    ControlY   = Y;
+                    HasControl = true;
+                }
+            }
+
+            if(HasControl)
+            {
+                AccumulateCurve(Buffer, PenX, PenY, ControlX, ControlY, StartX, StartY);
+            }
+            else
+            {
+                AccumulateLine(Buffer, PenX, PenY, StartX, StartY);
+            }
+
+            First = Last + 1;
+        }
+    }
+
+    LeaveMemoryRegion(Region);
+}
+
+
+enum GlyphComponent_Flag
+{
+    GlyphComponent_WordArguments = 1 << 0,
+    GlyphComponent_XYValues      = 1 << 1,
+    GlyphComponent_Scale         = 1 << 3,
+    GlyphComponent_MoreFollow    = 1 << 5,
+    GlyphComponent_XYScale       = 1 << 6,
+    GlyphComponent_TwoByTwo      = 1 << 7,
+};
+
+
+// Composite glyphs reference other glyphs with a transform. Point matched components
+// are drawn without an offset.
+
+static void
+AccumulateGlyph(backend_context &Context, uint16_t GlyphIndex, outline_transform Transform, coverage_buffer &Buffer, memory_arena *Arena, uint32_t Depth)
+{
+    uint32_t Outline = FindGlyphOutline(Context, GlyphIndex);
+    if(!Outline || Depth > 8)
+    {
+        return;
+    }
+
+    if(ReadFontI16(Context, Outline) >= 0)
+    {
+        AccumulateSimpleGlyph(Context, Outline, Transform, Buffer, Arena);
+        return;
+    }
+
+    uint32_t At    = Outline + 10;
+    uint16_t Flags = GlyphComponent_MoreFollow;
+
+    while(Flags & GlyphComponent_MoreFollow)
+    {
+        Flags = ReadFontU16(Context, At);
+
+        uint16_t Component = ReadFontU16(Context, At + 2);
+        float    OffsetX   = 0.f;
+        float    OffsetY   = 0.f;
+        At += 4;
+
+        if(Flags & GlyphComponent_WordArguments)
+        {
+            OffsetX = (float)ReadFontI16(Context, At);
+            OffsetY = (float)ReadFontI16(Context, At + 2);
+            At += 4;
+        }
+        else
+        {
+            OffsetX = (float)(int8_t)(At     < Context.Size ? Context.Data[At    ] : 0);
+            OffsetY = (float)(int8_t)(At + 1 < Context.Size ? Context.Data[At + 1] : 0);
+            At += 2;
+        }
+
+        if(!(Flags & GlyphComponent_XYValues))
+        {
+            OffsetX = 0.f;
+            OffsetY = 0.f;
+        }
+
+        // F2Dot14 matrix, identity unless specified.
+        float XX = 1.f, XY = 0.f, YX = 0.f, YY = 1.f;
+        if(Flags & GlyphComponent_Scale)
+        {
+            XX = YY = ReadFontI16(Context, At) / 16384.f;
+            At += 2;
+        }
+        else if(Flags & GlyphComponent_XYScale)
+        {
+            XX = ReadFontI16(Context, At    ) / 16384.f;
+            YY = ReadFontI16(Context, At + 2) / 16384.f;
+            At += 4;
+        }
+        else if(Flags & GlyphComponent_TwoByTwo)
+        {
+            XX = ReadFontI16(Context, At    ) / 16384.f;
+            XY = ReadFontI16(Context, At + 2) / 16384.f;
+            YX = ReadFontI16(Context, At + 4) / 16384.f;
+            YY = ReadFontI16(Context, At + 6) / 16384.f;
+            At += 8;
+        }
+
+        outline_transform Child =
+        {
+            .XX = Transform.XX * XX + Transform.YX * XY,
+            .XY = Transform.XY * XX + Transform.YY * XY,
+            .YX = Transform.XX * YX + Transform.YX * YY,
+            .YY = Transform.XY * YX + Transform.YY * YY,
+            .DX = Transform.XX * OffsetX + Transform.YX * OffsetY + Transform.DX,
+            .DY = Transform.XY * OffsetX + Transform.YY * OffsetY + Transform.DY,
+        };
+
+        AccumulateGlyph(Context, Component, Child, Buffer, Arena, Depth + 1);
+    }
+}
+
+
+rasterized_buffer
+backend_context::RasterizeGlyphToAlphaTexture(uint16_t GlyphIndex, float Advance, float EmSize, memory_arena *Arena)
+{
+    (void)Advance;
+
+    rasterized_buffer Result = {};
+
+    if(!this->IsValid())
+    {
+        return Result;
+    }
+
+    float           Scale = EmSize / (float)this->UnitsPerEm;
+    glyph_pixel_box Box   = GetGlyphPixelBox(*this, FindGlyphOutline(*this, GlyphIndex), Scale);
+
+    int32_t Width  = Box.X1 - Box.X0;
+    int32_t Height = Box.Y1 - Box.Y0;
+
+    if(Width <= 0 || Height <= 0)
+    {
+        return Result;
+    }
+
+    uint8_t *Pixels = PushArrayNoZeroAligned<uint8_t>(Arena, (uint64_t)Width * Height, 1);
+    if(!Pixels)
+    {
+        return Result;
+    }
+
+    // The accumulation buffer is only needed until coverage is resolved.
+    memory_region Region = EnterMemoryRegion(Arena);
+
+    coverage_buffer Buffer =
+    {
+        .Accumulation = PushArrayNoZeroAligned<float>(Arena, (uint64_t)Width * Height + 2, alignof(float)),
+        .Width        = Width,
+        .Height       = Height,
+    };
+
+    if(Buffer.Accumulation)
+    {
+        memset(Buffer.Accumulation, 0, ((uint64_t)Width * Height + 2) * sizeof(float));
+
+        // Font units are Y up, the buffer is Y down.
+        outline_transform Transform =
+        {
+            .XX =  Scale, .XY =  0.f,
+            .YX =  0.f  , .YY = -Scale,
+            .DX = -(float)Box.X0,
+            .DY = -(float)Box.Y0,
+        };
+
+        AccumulateGlyph(*this, GlyphIndex, Transform, Buffer, Arena, 0);
+
+        float Sum = 0.f;
+        for(int32_t Idx = 0; Idx < Width * Height; ++Idx)
+        {
+            Sum += Buffer.Accumulation[Idx];
+
+            float Coverage = fabsf(Sum);
+            Pixels[Idx] = (uint8_t)((Coverage < 1.f ? Coverage : 1.f) * 255.f + 0.5f);
+        }
+
+        Result.Data          = Pixels;
+        Result.Stride        = (uint32_t)Width;
+        Result.Width         = (uint32_t)Width;
+        Result.Height        = (uint32_t)Height;
+        Result.BytesPerPixel = 1;
+    }
+
+    LeaveMemoryRegion(Region);
+
+    return Result;
+}
+
+#endif // !NTEXT_WIN32
+
+
+// ==================================================================================
+// @Internal : Rectangle Packing
+// Placeholder: rectangle packing utilities
+// ==================================================================================
+
+struct point
+{
+    uint16_t X;
+    uint16_t Y;
+};
+
+
+// BottomLeft places a rectangle where its top edge is the lowest, then leftmost. BestFit
+// breaks ties of the lowest top edge by the least area left empty under the rectangle
+// (between its bottom edge and the skylines it spans). MinWaste places it where the least
+// area is left empty, then where its top edge is the lowest.
+//
+// Measured on the glyph boxes of proportional and monospace fonts at 12 to 48 px, packed
+// until the first failure: BottomLeft fills the most of a page with glyphs in arrival
+// order (88%, BestFit 86%, MinWaste 74%). With sorted heights BestFit and BottomLeft are
+// within a point of each other (94-95%). Default is BottomLeft.
+
+enum class PackingHeuristic
+{
+    Default    = 0,
+    BottomLeft = 1,
+    BestFit    = 2,
+    MinWaste   = 3,
+};
+
+
+struct rectangle_packer
+{
+    point            *Skyline;
+    uint16_t          SkylineCount;
+    uint16_t          Width;
+    uint16_t          Height;
+    PackingHeuristic  Heuristic;
+};
+
+
+struct packed_rectangle
+{
+    uint16_t Width;
+    uint16_t Height;
+
+    uint16_t X;
+    uint16_t Y;
+    bool     WasPacked;
+};
+
+
+struct rectangle
+{
+    float Left;
+    float Top;
+    float Right;
+    float Bottom;
+};
+
+
+static uint64_t
+GetRectanglePackerFootprint(uint16_t Width)
+{
+    uint64_t SkylineSize = Width * sizeof(point);
+    uint64_t Result      = sizeof(rectangle_packer) + SkylineSize;
+
+    return Result;
+}
+
+
+static rectangle_packer *
+PlaceRectanglePackerInMemory(uint16_t Width, uint16_t Height, PackingHeuristic Heuristic, void *Memory)
+{
+    rectangle_packer *Result = 0;
+
+    if(Memory)
+    {
+        point *Skyline = (point *)Memory;
+
+        Result = (rectangle_packer *)(Skyline + Width);
+        Result->Width        = Width;
+        Result->Height       = Height;
+        Result->Heuristic    = Heuristic == PackingHeuristic::Default ? PackingHeuristic::BottomLeft : Heuristic;
+        Result->Skyline      = Skyline;
+        Result->SkylineCount = 1;
+        Result->Skyline[0].X = 0;
+        Result->Skyline[0].Y = 0;
+    }
+
+    return Result;
+}
+
+
+static void
+ClearRectanglePacker(rectangle_packer *Packer)
+{
+    NTEXT_ASSERT(Packer);
+
+    Packer->SkylineCount = 1;
+    Packer->Skyline[0].X = 0;
+    Packer->Skyline[0].Y = 0;
+}
+
+
+static void
+PackRectangle(packed_rectangle &Rectangle, rectangle_packer *Packer)
+{
+    NTEXT_ASSERT(Packer);
+
+    uint16_t Width  = Rectangle.Width;
+    uint16_t Height = Rectangle.Height;
+
+    if(Width == 0 || Height == 0)
+    {
+        return;
+    }
+
+    uint16_t BestIndexInclusive = UINT16_MAX;
+    uint16_t BestIndexExclusive = UINT16_MAX;
+    point    BestPoint          = {UINT16_MAX, UINT16_MAX};
+    uint32_t BestWaste          = UINT32_MAX;
+    bool     BestFit            = Packer->Heuristic == PackingHeuristic::BestFit;
+    bool     MinWaste           = Packer->Heuristic == PackingHeuristic::MinWaste;
+
+    NTEXT_ASSERT(Packer->SkylineCount);
+
+    for(uint16_t Idx = 0; Idx < Packer->SkylineCount; ++Idx)
+    {
+        point Point = Packer->Skyline[Idx];
+
+        // If on the current skyline we do not have horizontal space, then we can break since the array is sorted left to right.
+        if(Width > Packer->Width - Point.X)
+        {
+            break;
+        }
+
+        // If the current skyline is taller than our BestY, then we simply continue since we are trying to place bottom->top.
+        // BestFit still compares the waste at the same height, MinWaste looks at every position.
+        if(!MinWaste && (Point.Y > BestPoint.Y || (!BestFit && Point.Y == BestPoint.Y)))
+        {
+            continue;
+        }
+
+        uint16_t XMax           = Point.X + Width;
+        uint16_t IndexExclusive = 0;
+        for(IndexExclusive = Idx + 1; IndexExclusive < Packer->SkylineCount; ++IndexExclusive)
+        {
+            // XMax is the right edge of the current rectangle. If it is smaller or equal then we know that
+            // there is no way to intersect on the X axis anymore, because the skylines are sorted from left to right.
+            if(XMax <= Packer->Skyline[IndexExclusive].X)
+            {
+                break;
+            }
+
+            // At this point, we know we are intersecting on the X axis, thus we need to raise the skyline,
+            // which is what creates dead space. As long as we intersect on the X axis, we have to continue raising the
+            // point.
+            if(Point.Y < Packer->Skyline[IndexExclusive].Y)
+            {
+                Point.Y = Packer->Skyline[IndexExclusive].Y;
+            }
+        }
+
+        // Not enough vertical space to store this rectangle.
+        if(Height > Packer->Height - Point.Y)
+        {
+            continue;
+        }
+
+        // The area between the raised point and each spanned skyline is lost.
+        uint32_t Waste = 0;
+
+        if(BestFit || MinWaste)
+        {
+            for(uint16_t Span = Idx; Span < IndexExclusive; ++Span)
+            {
+                uint16_t Left  = Packer->Skyline[Span].X;
+                uint16_t Right = Span + 1 < Packer->SkylineCount ? Packer->Skyline[Span + 1].X : Packer->Width;
+
+                Right  = Right < XMax ? Right : XMax;
+                Waste += static_cast<uint32_t>(Right - Left) * (Point.Y - Packer->Skyline[Span].Y);
+            }
+        }
+
+        // Then it's a worse point than our current best.
+        bool IsLower  = Point.Y < BestPoint.Y;
+        bool IsBetter = IsLower;
+
+        if(BestFit)  IsBetter = IsLower || (Point.Y == BestPoint.Y && Waste < BestWaste);
+        if(MinWaste) IsBetter = Waste < BestWaste || (Waste == BestWaste && IsLower);
+
+        if(!IsBetter)
+        {
+            continue;
+        }
+
+        BestIndexInclusive = Idx;
+        BestIndexExclusive = IndexExclusive;
+        BestPoint          = Point;
+        BestWaste          = Waste;
+    }
+
+    // Could not pack the rectangle.
+    if(BestIndexInclusive == UINT16_MAX)
+    {
+        return;
+    }
+
+    NTEXT_ASSERT(BestIndexInclusive < BestIndexExclusive);
+    NTEXT_ASSERT(BestIndexExclusive > 0);
+
+    uint16_t RemovedCount = BestIndexExclusive - BestIndexInclusive;
+    NTEXT_ASSERT(RemovedCount > 0);
+
+    // To create the top left point, we use the best point we found and raise it by the height of the rectangle.
+    // To create the bot right point, we use the right edge of the triangle we are placing and the last overlapping skyline y
+    // coordinate. This ensures that the skyline goes from left to right.
+
+    point NewTopLeft  = {BestPoint.X                               , static_cast<uint16_t>(BestPoint.Y + Height)};
+    point NewBotRight = {static_cast<uint16_t>(BestPoint.X + Width), Packer->Skyline[BestIndexExclusive - 1].Y};
+
+    // To know if we are creating a new skyline from the bottom right point, we need to check multiple cases.
+    // If the first exclusive point is a valid index, then we simply check: if (smaller) new point else no.
+    // If the first exclusive point is not a valid index, then we simply check: if(not_on_boundary) new point
+
+    bool HasBottomRightPoint = BestIndexExclusive < Packer->SkylineCount ?
+        NewBotRight.X < Packer->Skyline[BestIndexExclusive].X :
+        NewBotRight.X < Packer->Width;
+
+    uint16_t InsertedCount = 1 + HasBottomRightPoint;
+    NTEXT_ASSERT(Packer->SkylineCount + InsertedCount - RemovedCount <= Packer->Width);
+
+    if(InsertedCount > RemovedCount)
+    {
+        // Copy from the last element to the exclusive index.
+        // Make space for the new elements by shifting end by (InsertedCount - RemovedCount)
+        // This grows the array.
+
+        uint16_t Start = Packer->SkylineCount - 1;
         uint16_t End   = Start + (InsertedCount - RemovedCount);
 
-        for(; Start >= BestIndexExclusive; --Start, --End)
+        for(; Start >= BestIndexExclusive; --Start, --End)
+        {
+            Packer->Skyline[End] = Packer->Skyline[Start];
+        }
+
+        Packer->SkylineCount += (InsertedCount - RemovedCount);
+    } else
+    if(InsertedCount < RemovedCount)
+    {
+        // Copy from the first exclusive element to (Start - ElementsToRemoveCount)
+        // We basically start copying behind us and iterate until the end of the array.
+
+        uint16_t Start = BestIndexExclusive;
+        uint16_t End   = Start - (RemovedCount - InsertedCount);
+
+        for(; Start < Packer->SkylineCount; ++Start, ++End)
+        {
+            Packer->Skyline[End] = Packer->Skyline[Start];
+        }
+
+        Packer->SkylineCount -= (RemovedCount - InsertedCount);
+    }
+
+    Packer->Skyline[BestIndexInclusive] = NewTopLeft;
+    if(HasBottomRightPoint)
+    {
+        Packer->Skyline[BestIndexInclusive + 1] = NewBotRight;
+    }
+
+    // The rectangle sits on the highest skyline it spans, which is BestPoint.Y. NewBotRight.Y is
+    // the height of the last spanned skyline and only matches when that skyline is the highest.
+
+    Rectangle.WasPacked = 1;
+    Rectangle.X         = BestPoint.X;
+    Rectangle.Y         = BestPoint.Y;
+}
+
+
+// ==================================================================================
+// @Public : NText Glyph Table Implementation
+// Placeholder: glyph table types and hash utilities
+// ==================================================================================
+
+enum class GlyphTableWidth : uint64_t
+{
+    None     = 0,
+    _128Bits = 16,
+};
+
+
+struct glyph_table_params
+{
+    GlyphTableWidth GroupWidth;
+    uint64_t        GroupCount;
+};
+
+
+struct glyph_hash
+{
+    __m128i Value;
+};
+
+
+struct glyph_tag
+{
+    uint8_t Value;
+};
+
+
+struct glyph_layout_info
+{
+    float Advance;
+    float OffsetX;
+    float OffsetY;
+};
+
+
+struct glyph_entry
+{
+    glyph_hash        Hash;
+
+    uint32_t          PrevLRU;
+    uint32_t          NextLRU;
+
+    uint16_t          GlyphIndex;
+    rectangle         Source;
+    glyph_layout_info LayoutInfo;
+    bool              IsRasterized;
+};
+
+
+struct glyph_table
+{
+    uint8_t     *Metadata;
+    glyph_entry *Buckets;
+
+    uint64_t     GroupWidth;
+    uint64_t     GroupCount;
+    uint64_t     HashMask;
+
+    uint32_t     SentinelIndex;
+    uint32_t     Count;            // Live entries, evicted by EvictGlyphTableEntries
+};
+
+
+struct glyph_state
+{
+    uint32_t          Id;
+    uint16_t          GlyphIndex;
+    glyph_layout_info LayoutInfo;
+    rectangle         Source;
+    bool              IsRasterized;
+};
+
+
+// ASCII codepoints are looked up in a direct-mapped array indexed by the codepoint
+// instead of going through the hash table.
+
+struct cached_glyph
+{
+    uint16_t          GlyphIndex;
+    rectangle         Source;
+    glyph_layout_info LayoutInfo;
+    bool              IsRasterized;
+};
+
+
+constexpr uint32_t GlyphTableInvalidEntry = 0xFFFFFFFFu;
+constexpr uint8_t  GlyphTableEmptyMask    = 1 << 6; 
+constexpr uint8_t  GlyphTableDeadMask     = 1 << 7;
+constexpr uint8_t  GlyphTableTagMask      = 0xFF & ~0x03;
+constexpr uint32_t DirectGlyphCount       = 128;
+
+
+static bool
+IsValidGlyphTable(glyph_table *Table)
+{
+    bool Result = Table && Table->Metadata && Table->Buckets;
+    return Result;
+}
+
+
+static glyph_entry *
+GetGlyphEntry(uint64_t Index, glyph_table *Table)
+{
+    NTEXT_ASSERT(Table);
+    NTEXT_ASSERT(Index <= (Table->GroupCount * Table->GroupWidth)); // Could be sentinel.
+
+    glyph_entry *Result = Table->Buckets + Index;
+    return Result;
+}
+
+static glyph_entry *
+GetGlyphTableSentinel(glyph_table *Table)
+{
+    NTEXT_ASSERT(Table->SentinelIndex == Table->GroupCount * Table->GroupWidth);
+
+    glyph_entry *Result = Table->Buckets + Table->SentinelIndex;
+    return Result;
+}
+
+
+static uint32_t
+GetGlyphGroupIndexFromHash(glyph_hash Hash, glyph_table *Table)
+{
+    uint64_t Low64  = _mm_cvtsi128_si64(Hash.Value);
+    uint32_t Result = (uint32_t)(Low64 & Table->HashMask);
+
+    return Result;
+}
+
+
+static char unsigned OverhangMask[32] =
+{
+    255, 255, 255, 255,  255, 255, 255, 255,  255, 255, 255, 255,  255, 255, 255, 255,
+    0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0
+};
+
+
+static char unsigned DefaultSeed[16] =
+{
+    178, 201, 95, 240, 40, 41, 143, 216,
+    2, 209, 178, 114, 232, 4, 176, 188
+};
+
+
+static glyph_hash
+ComputeGlyphHash(size_t Count, char unsigned *At, char unsigned *Seedx16)
+{
+    glyph_hash Result = {0};
+
+    __m128i HashValue = _mm_cvtsi64_si128(Count);
+    HashValue = _mm_xor_si128(HashValue, _mm_loadu_si128((__m128i *)Seedx16));
+
+    size_t ChunkCount = Count / 16;
+    while(ChunkCount--)
+    {
+        __m128i In = _mm_loadu_si128((__m128i *)At);
+        At += 16;
+
+        HashValue = _mm_xor_si128(HashValue, In);
+        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    }
+
+    size_t Overhang = Count % 16;
+
+    // Think there is a fix for that on the refterm issues tab.
+
+#if 0
+    __m128i In = _mm_loadu_si128((__m128i *)At);
+#else
+    char Temp[16];
+    memcpy(Temp, At, Overhang);
+    __m128i In = _mm_loadu_si128((__m128i *)Temp);
+#endif
+    In = _mm_and_si128(In, _mm_loadu_si128((__m128i *)(OverhangMask + 16 - Overhang)));
+
+    HashValue = _mm_xor_si128(HashValue, In);
+    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+
+    Result.Value = HashValue;
+
+    return Result;
+}
+
+
+static glyph_tag
+GetGlyphTagFromHash(glyph_hash Hash)
+{
+    uint64_t  Low64  = _mm_cvtsi128_si64(Hash.Value);
+    glyph_tag Result = {.Value = (uint8_t)(Low64 & 0x3F)};
+
+    return Result;
+}
+
+
+static bool
+GlyphHashesAreEqual(glyph_hash A, glyph_hash B)
+{
+    __m128i Compare = _mm_cmpeq_epi8(A.Value, B.Value);
+    int     Mask    = _mm_movemask_epi8(Compare);
+
+    return (Mask == 0xFFFF);
+}
+
+
+static uint64_t
+GetGlyphTableFootprint(glyph_table_params Params)
+{
+    uint64_t SlotCount = Params.GroupCount * static_cast<uint32_t>(Params.GroupWidth);
+
+    uint64_t MetadataSize = SlotCount * sizeof(uint8_t);
+    uint64_t BucketsSize  = (SlotCount + 1) * sizeof(glyph_entry); // Accounts for sentinel.
+    uint64_t Result       = MetadataSize + BucketsSize + sizeof(glyph_table);
+
+    return Result;
+}
+
+
+static glyph_table *
+PlaceGlyphTableInMemory(glyph_table_params Params, void *Memory)
+{
+    glyph_table *Result = 0;
+
+    if(Memory)
+    {
+        uint64_t SlotCount = Params.GroupCount * static_cast<uint32_t>(Params.GroupWidth);
+
+        uint8_t     *Metadata = static_cast<uint8_t *>(Memory);
+        glyph_entry *Buckets  = reinterpret_cast<glyph_entry*>(Metadata + SlotCount);
+
+        Result = reinterpret_cast<glyph_table *>(Buckets + SlotCount + 1); // Skip sentinel
+        Result->Metadata      = Metadata;
+        Result->Buckets       = Buckets;
+        Result->GroupWidth    = static_cast<uint64_t>(Params.GroupWidth);
+        Result->GroupCount    = Params.GroupCount;
+        Result->HashMask      = Params.GroupCount - 1; // Only used to find the group index, not the slot index
+        Result->SentinelIndex = SlotCount;
+        Result->Count         = 0;
+
+
+        for(uint32_t Idx = 0; Idx < SlotCount; ++Idx)
+        {
+            glyph_entry *Entry = GetGlyphEntry(Idx, Result);
+            Entry->GlyphIndex   = 0;
+            Entry->Source       = {};
+            Entry->LayoutInfo   = {};
+            Entry->IsRasterized = false;
+        }
+
+        for(uint32_t Idx = 0; Idx < SlotCount; ++Idx)
+        {
+            Result->Metadata[Idx] = GlyphTableEmptyMask;
+        }
+
+        glyph_entry *Sentinel = GetGlyphTableSentinel(Result);
+        NTEXT_ASSERT(Sentinel);
+
+        Sentinel->PrevLRU = Result->SentinelIndex;
+        Sentinel->NextLRU = Result->SentinelIndex;
+    }
+
+    return Result;
+}
+
+
+// Inserts the entry when it does not exist. The table never grows, callers must evict
+// entries with EvictGlyphTableEntries before Count reaches GetGlyphTableMaxCount.
+
+static glyph_state
+FindGlyphEntryByHash(glyph_hash Hash, glyph_table *Table)
+{
+    NTEXT_ASSERT(Table);
+
+    glyph_entry *Result     = 0;
+    uint32_t     EntryIndex = GlyphTableInvalidEntry;
+
+    uint32_t ProbeCount = 0;
+    uint32_t GroupIndex = GetGlyphGroupIndexFromHash(Hash, Table);
+
+    NTEXT_ASSERT(GroupIndex < Table->GroupCount);
+
+    while(!Result)
+    {
+        uint8_t  *Meta = Table->Metadata + (GroupIndex * Table->GroupWidth);
+        glyph_tag Tag  = GetGlyphTagFromHash(Hash);
+
+        __m128i MetaVector = _mm_loadu_si128((__m128i *)Meta);
+        __m128i TagVector  = _mm_set1_epi8(Tag.Value);
+
+        // Uses a 6 bit tags to search a matching tag through the meta-data vector.
+        // If found compare hashes and return if they match.
+
+        int TagMask = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, TagVector));
+        while(TagMask)
+        {
+            EntryIndex = FindFirstBit(TagMask) + (GroupIndex * Table->GroupWidth);
+
+            glyph_entry *Entry = GetGlyphEntry(EntryIndex, Table);
+            if(GlyphHashesAreEqual(Hash, Entry->Hash))
+            {
+                Result = Entry;
+                break;
+            }
+
+            TagMask &= TagMask - 1;
+        }
+
+        if(!Result)
+        {
+            __m128i EmptyVector = _mm_set1_epi8(GlyphTableEmptyMask);
+            int     EmptyMask   = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, EmptyVector));
+
+            if(!EmptyMask)
+            {
+                // Triangular steps visit every group when GroupCount is a power of two.
+
+                ProbeCount++;
+                GroupIndex = (GroupIndex + ProbeCount) & Table->HashMask;
+            }
+            else
+            {
+                EntryIndex = FindFirstBit(EmptyMask) + (GroupIndex * Table->GroupWidth);
+                break;
+            }
+        }
+    }
+
+    if(Result)
+    {
+        // An existing entry was found, we simply pop it from the chain.
+
+        glyph_entry *Prev = GetGlyphEntry(Result->PrevLRU, Table);
+        glyph_entry *Next = GetGlyphEntry(Result->NextLRU, Table);
+
+        NTEXT_ASSERT(Prev);
+        NTEXT_ASSERT(Next);
+
+        Prev->NextLRU = Result->NextLRU;
+        Next->PrevLRU = Result->PrevLRU;
+    }
+    else
+    {
+        // No existing entry was found, we simply allocate a new one by updating the metadata array.
+
+        NTEXT_ASSERT(EntryIndex != GlyphTableInvalidEntry);
+
+        // Since the tag is 00XX XXXX, we clear the state bits.
+        Table->Metadata[EntryIndex] = GetGlyphTagFromHash(Hash).Value;
+
+        Result = GetGlyphEntry(EntryIndex, Table);
+        Result->Hash         = Hash;
+        Result->IsRasterized = false;
+
+        Table->Count += 1;
+    }
+
+    glyph_entry *Sentinel = GetGlyphTableSentinel(Table);
+    NTEXT_ASSERT(Sentinel && Result != Sentinel);
+
+    Result->NextLRU = Sentinel->NextLRU;
+    Result->PrevLRU = Table->SentinelIndex;
+
+    glyph_entry *Head = GetGlyphEntry(Sentinel->NextLRU, Table);
+    Head->PrevLRU     = EntryIndex;
+    Sentinel->NextLRU = EntryIndex;
+
+    glyph_state State = {};
+    State.IsRasterized = Result->IsRasterized;
+    State.Id           = EntryIndex;
+    State.GlyphIndex   = Result->GlyphIndex;
+    State.LayoutInfo   = Result->LayoutInfo;
+    State.Source       = Result->Source;
+
+    return State;
+}
+
+
+static void
+UpdateGlyphTableEntry(uint32_t Id, bool IsRasterized, uint16_t GlyphIndex, glyph_layout_info LayoutInfo, rectangle Source, glyph_table *Table)
+{
+    glyph_entry *Entry = GetGlyphEntry(Id, Table);
+    NTEXT_ASSERT(Entry);
+
+    Entry->IsRasterized = IsRasterized;
+    Entry->GlyphIndex   = GlyphIndex;
+    Entry->LayoutInfo   = LayoutInfo;
+    Entry->Source       = Source;
+}
+
+
+static uint32_t
+GetGlyphTableMaxCount(glyph_table *Table)
+{
+    uint64_t SlotCount = Table->GroupCount * Table->GroupWidth;
+    uint32_t Result    = static_cast<uint32_t>(SlotCount - (SlotCount / 4));
+
+    return Result;
+}
+
+
+// Keeps the KeepCount most recently used entries and evicts the others. The table is
+// rebuilt such that no tombstone is left behind, thus ids returned before are invalid.
+// Returns the amount of evicted entries.
+
+static uint32_t
+EvictGlyphTableEntries(uint32_t KeepCount, glyph_table *Table, memory_arena *Arena)
+{
+    NTEXT_ASSERT(Table);
+
+    if(KeepCount >= Table->Count)
+    {
+        return 0;
+    }
+
+    memory_region Region = EnterMemoryRegion(Arena);
+
+    glyph_entry *Kept      = PushArray<glyph_entry>(Arena, KeepCount ? KeepCount : 1);
+    uint32_t     KeptCount = 0;
+
+    NTEXT_ASSERT(Kept);
+
+    glyph_entry *Sentinel = GetGlyphTableSentinel(Table);
+    uint32_t     Index    = Sentinel->NextLRU;
+
+    while(Index != Table->SentinelIndex && KeptCount < KeepCount)
+    {
+        glyph_entry *Entry = GetGlyphEntry(Index, Table);
+
+        Kept[KeptCount++] = *Entry;
+        Index             = Entry->NextLRU;
+    }
+
+    uint32_t Result    = Table->Count - KeptCount;
+    uint64_t SlotCount = Table->GroupCount * Table->GroupWidth;
+
+    for(uint32_t Idx = 0; Idx < SlotCount; ++Idx)
+    {
+        Table->Metadata[Idx] = GlyphTableEmptyMask;
+    }
+
+    Sentinel->PrevLRU = Table->SentinelIndex;
+    Sentinel->NextLRU = Table->SentinelIndex;
+    Table->Count      = 0;
+
+    // Coldest first, such that the LRU order is preserved.
+
+    for(uint32_t Idx = KeptCount; Idx-- > 0;)
+    {
+        glyph_entry &Entry = Kept[Idx];
+        glyph_state  State = FindGlyphEntryByHash(Entry.Hash, Table);
+
+        UpdateGlyphTableEntry(State.Id, Entry.IsRasterized, Entry.GlyphIndex, Entry.LayoutInfo, Entry.Source, Table);
+    }
+
+    LeaveMemoryRegion(Region);
+
+    return Result;
+}
+
+
+// ==================================================================================
+// @Internal : UTF-8 Decoding
+// Same semantics as DecodeByteString: a lead byte followed by the expected amount of
+// continuation bytes decodes to a codepoint, anything else consumes a single byte and
+// decodes to InvalidCodepoint. Overlong forms and surrogates are not rejected.
+// ==================================================================================
+
+constexpr uint32_t InvalidCodepoint     = 0xFFFFFFFFu;
+constexpr uint32_t ReplacementCodepoint = 0xFFFDu;
+
+
+struct utf8_decode
+{
+    uint32_t Increment;
+    uint32_t Codepoint;
+};
+
+
+// 0 = Continuation, 1 = ASCII, 2..4 = Lead of that many bytes, 5 = Invalid (Indexed by Byte >> 3)
+
+static uint8_t UTF8ByteClass[32] =
+{
+    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,2,2,2,2,3,3,4,5,
+};
+
+
+static utf8_decode
+DecodeUTF8(const uint8_t *At, uint64_t Maximum)
+{
+    NTEXT_ASSERT(Maximum > 0);
+
+    utf8_decode Result = {1, InvalidCodepoint};
+
+    uint8_t Byte      = At[0];
+    uint8_t ByteClass = UTF8ByteClass[Byte >> 3];
+
+    if(ByteClass == 1)
+    {
+        Result.Codepoint = Byte;
+    }
+    else if(ByteClass >= 2 && ByteClass <= 4 && ByteClass <= Maximum)
+    {
+        static const uint8_t LeadMask[5] = {0, 0, 0x1F, 0x0F, 0x07};
+
+        uint32_t Codepoint = Byte & LeadMask[ByteClass];
+        bool     IsValid   = true;
+
+        for(uint32_t Idx = 1; Idx < ByteClass; ++Idx)
+        {
+            IsValid   = IsValid && (UTF8ByteClass[At[Idx] >> 3] == 0);
+            Codepoint = (Codepoint << 6) | (At[Idx] & 0x3F);
+        }
+
+        if(IsValid)
+        {
+            Result.Codepoint = Codepoint;
+            Result.Increment = ByteClass;
+        }
+    }
+
+    return Result;
+}
+
+
+// Decodes 4 positions. B0..B3 hold the bytes at offset 0..3 of each position in their low
+// 4 bytes, V2..V4 the byte masks of positions starting a valid sequence of that length.
+
+static __m128i
+DecodeUTF8Lanes(__m128i B0, __m128i B1, __m128i B2, __m128i B3, __m128i V2, __m128i V3, __m128i V4)
+{
+    __m128i Low6 = _mm_set1_epi32(0x3F);
+
+    __m128i X0 = _mm_cvtepu8_epi32(B0);
+    __m128i P1 = _mm_and_si128(_mm_cvtepu8_epi32(B1), Low6);
+    __m128i P2 = _mm_and_si128(_mm_cvtepu8_epi32(B2), Low6);
+    __m128i P3 = _mm_and_si128(_mm_cvtepu8_epi32(B3), Low6);
+
+    __m128i Cp2 = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(X0, _mm_set1_epi32(0x1F)), 6), P1);
+    __m128i Cp3 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(X0, _mm_set1_epi32(0x0F)), 12), _mm_slli_epi32(P1, 6)), P2);
+    __m128i Cp4 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(X0, _mm_set1_epi32(0x07)), 18), _mm_slli_epi32(P1, 12)),
+                               _mm_or_si128(_mm_slli_epi32(P2, 6), P3));
+
+    __m128i Ascii  = _mm_cmplt_epi32(X0, _mm_set1_epi32(0x80));
+    __m128i Result = _mm_set1_epi32((int)InvalidCodepoint);
+
+    Result = _mm_blendv_epi8(Result, X0 , Ascii);
+    Result = _mm_blendv_epi8(Result, Cp2, _mm_cvtepi8_epi32(V2));
+    Result = _mm_blendv_epi8(Result, Cp3, _mm_cvtepi8_epi32(V3));
+    Result = _mm_blendv_epi8(Result, Cp4, _mm_cvtepi8_epi32(V4));
+
+    return Result;
+}
+
+
+// A valid sequence only ever spans continuation bytes, so the decode of a position does
+// not depend on where the previous sequence started. Blocks of 16 positions are decoded
+// independently and the positions that start a sequence are the ones not covered by a
+// valid sequence on their left. Coverage may carry into the next block. The tail (less
+// than 16 + 3 bytes of lookahead) is decoded with DecodeUTF8.
+// Codepoints must hold Count entries, returns the amount of decoded codepoints.
+
+static uint32_t
+DecodeUTF8ToCodepoints(const uint8_t *Data, uint64_t Count, uint32_t *Codepoints)
+{
+    uint32_t Result = 0;
+    uint64_t At     = 0;
+    uint32_t Carry  = 0;
+
+    __m128i TopTwo   = _mm_set1_epi8((char)0xC0);
+    __m128i TopThree = _mm_set1_epi8((char)0xE0);
+    __m128i TopFour  = _mm_set1_epi8((char)0xF0);
+    __m128i TopFive  = _mm_set1_epi8((char)0xF8);
+    __m128i ContTag  = _mm_set1_epi8((char)0x80);
+
+    while(At + 16 + 3 <= Count)
+    {
+        __m128i B0 = _mm_loadu_si128((__m128i *)(Data + At));
+
+        if(!_mm_movemask_epi8(B0) && !Carry)
+        {
+            _mm_storeu_si128((__m128i *)(Codepoints + Result +  0), _mm_cvtepu8_epi32(B0));
+            _mm_storeu_si128((__m128i *)(Codepoints + Result +  4), _mm_cvtepu8_epi32(_mm_srli_si128(B0,  4)));
+            _mm_storeu_si128((__m128i *)(Codepoints + Result +  8), _mm_cvtepu8_epi32(_mm_srli_si128(B0,  8)));
+            _mm_storeu_si128((__m128i *)(Codepoints + Result + 12), _mm_cvtepu8_epi32(_mm_srli_si128(B0, 12)));
+
+            Result += 16;
+            At     += 16;
+            continue;
+        }
+
+        __m128i B1 = _mm_loadu_si128((__m128i *)(Data + At + 1));
+        __m128i B2 = _mm_loadu_si128((__m128i *)(Data + At + 2));
+        __m128i B3 = _mm_loadu_si128((__m128i *)(Data + At + 3));
+
+        __m128i C1 = _mm_cmpeq_epi8(_mm_and_si128(B1, TopTwo), ContTag);
+        __m128i C2 = _mm_cmpeq_epi8(_mm_and_si128(B2, TopTwo), ContTag);
+        __m128i C3 = _mm_cmpeq_epi8(_mm_and_si128(B3, TopTwo), ContTag);
+
+        __m128i V2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(B0, TopThree), TopTwo  ), C1);
+        __m128i V3 = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(B0, TopFour ), TopThree), _mm_and_si128(C1, C2));
+        __m128i V4 = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(B0, TopFive ), TopFour ), _mm_and_si128(C1, _mm_and_si128(C2, C3)));
+
+        uint32_t M2 = (uint32_t)_mm_movemask_epi8(V2);
+        uint32_t M3 = (uint32_t)_mm_movemask_epi8(V3);
+        uint32_t M4 = (uint32_t)_mm_movemask_epi8(V4);
+
+        uint32_t Covered = Carry | (M2 << 1) | (M3 << 1) | (M3 << 2) | (M4 << 1) | (M4 << 2) | (M4 << 3);
+        uint32_t Starts  = ~Covered & 0xFFFF;
+
+        Carry = Covered >> 16;
+
+        alignas(16) uint32_t Decoded[16];
+        _mm_store_si128((__m128i *)(Decoded +  0), DecodeUTF8Lanes(B0, B1, B2, B3, V2, V3, V4));
+        _mm_store_si128((__m128i *)(Decoded +  4), DecodeUTF8Lanes(_mm_srli_si128(B0,  4), _mm_srli_si128(B1,  4), _mm_srli_si128(B2,  4), _mm_srli_si128(B3,  4),
+                                                                   _mm_srli_si128(V2,  4), _mm_srli_si128(V3,  4), _mm_srli_si128(V4,  4)));
+        _mm_store_si128((__m128i *)(Decoded +  8), DecodeUTF8Lanes(_mm_srli_si128(B0,  8), _mm_srli_si128(B1,  8), _mm_srli_si128(B2,  8), _mm_srli_si128(B3,  8),
+                                                                   _mm_srli_si128(V2,  8), _mm_srli_si128(V3,  8), _mm_srli_si128(V4,  8)));
+        _mm_store_si128((__m128i *)(Decoded + 12), DecodeUTF8Lanes(_mm_srli_si128(B0, 12), _mm_srli_si128(B1, 12), _mm_srli_si128(B2, 12), _mm_srli_si128(B3, 12),
+                                                                   _mm_srli_si128(V2, 12), _mm_srli_si128(V3, 12), _mm_srli_si128(V4, 12)));
+
+        while(Starts)
+        {
+            Codepoints[Result++] = Decoded[FindFirstBit(Starts)];
+            Starts &= Starts - 1;
+        }
+
+        At += 16;
+    }
+
+    // Coverage carried from the last block is contiguous from its first position.
+    while(Carry & 1)
+    {
+        Carry >>= 1;
+        At     += 1;
+    }
+
+    while(At < Count)
+    {
+        utf8_decode Decode = DecodeUTF8(Data + At, Count - At);
+
+        Codepoints[Result++] = Decode.Codepoint;
+        At                  += Decode.Increment;
+    }
+
+    return Result;
+}
+
+
+// Counts the codepoints DecodeUTF8ToCodepoints would return without storing them. Blocks
+// of 16 ASCII bytes are skipped at once, anything else goes through DecodeUTF8.
+
+static uint32_t
+CountUTF8Codepoints(const uint8_t *Data, uint64_t Count)
+{
+    uint32_t Result = 0;
+    uint64_t At     = 0;
+
+    while(At < Count)
+    {
+        if(At + 16 <= Count && !_mm_movemask_epi8(_mm_loadu_si128((__m128i *)(Data + At))))
+        {
+            Result += 16;
+            At     += 16;
+            continue;
+        }
+
+        utf8_decode Decode = DecodeUTF8(Data + At, Count - At);
+
+        Result += 1;
+        At     += Decode.Increment;
+    }
+
+    return Result;
+}
+
+
+// ==================================================================================
+// @Public : NText Context
+// Placeholder: generator and context management
+// ==================================================================================
+
+// LazyAtlas rasterizes coverage at EmSize, a font size is one generator. SDF rasterizes each
+// glyph once at EmSize and stores a signed distance field instead, padded by SDFSpread texels
+// on every side. It can be drawn at any size: the renderer scales the quad and maps the
+// distance back to coverage. SDF atlases must be GreyScale.
+
+enum class TextStorage
+{
+    None      = 0,
+    LazyAtlas = 1,
+    SDF       = 2,
+};
+
+
+// Texels a distance field extends past the glyph box. 0.5 is the outline, a step of
+// 1 / (2 * SDFSpread) is one texel.
+
+constexpr uint32_t SDFSpread = 4;
+
+
+// The backend rasterizes coverage only, GreyScale atlases store it as one byte per texel.
+
+enum class TextureFormat
+{
+    None      = 0,
+    RGBA      = 1,
+    GreyScale = 2,
+};
+
+
+struct glyph_generator_params
+{
+    ntext::TextStorage      TextStorage;
+    ntext::TextureFormat    TextureFormat;
+    float                   EmSize;
+    uint64_t                FrameMemoryBudget;
+    void                   *FrameMemory;
+    uint16_t                CacheSizeX;
+    uint16_t                CacheSizeY;
+    uint16_t                CachePageCount;  // Atlas pages of CacheSizeX by CacheSizeY, 0 is one, MaxAtlasPageCount at most
+    ntext::PackingHeuristic PackingHeuristic;
+    const char             *FamilyName;      // System family (Win32) or font file path, null for the default font
+};
+
+
+// When the atlas or the glyph table is full, the least recently used glyphs are evicted
+// and the survivors are repacked from scratch (ASCII glyphs are never evicted). A repack
+// moves glyphs: AtlasVersion changes and every live glyph is emitted again in the
+// rasterized list of the run that triggered it.
+//
+// An atlas may have several pages. Glyphs go to the first page they fit in and the next
+// page only opens once they fit in none, the atlas is full (and repacked) when every page
+// is. Pages stack on Y: the sources of page P are offset by P * CacheSizeY, such that a
+// source still identifies a single texel of the atlas. Opening a page moves nothing.
+
+constexpr uint32_t MaxAtlasPageCount = 4;
+
+struct glyph_generator_stats
+{
+    uint64_t EvictedCount;
+    uint64_t RepackCount;
+    uint64_t FailedCount;     // Glyphs that did not fit even after eviction
+};
+
+
+struct glyph_generator
+{
+    // Memory
+    memory_arena     *Arena;
+    uint64_t          FrameStart;      // Arena position after the static state, see ClearGlyphGeneratorFrame
+
+    // Systems
+    glyph_table      *GlyphTable;
+    cached_glyph     *DirectGlyphs;    // Indexed by codepoint, DirectGlyphCount entries
+    rectangle_packer *Pages[MaxAtlasPageCount];
+    uint16_t          PageCount;
+    uint16_t          ActivePageCount; // Pages holding glyphs, at least one
+
+    // Misc
+    ntext::TextStorage    TextStorage;     // Qualified, GCC rejects members which change the meaning of a type name
+    ntext::TextureFormat  TextureFormat;
+    float                 EmSize;
+    float                 FixedAdvance;    // Advance of every glyph at EmSize for fixed pitch fonts, 0 otherwise
+    backend_context       Backend;
+    uint32_t              AtlasVersion;
+    glyph_generator_stats Stats;
+};
+
+// Should we add a function to get the static footprint for the glyph generator?
+
+
+static glyph_generator CreateGlyphGenerator(glyph_generator_params Params)
+{
+    glyph_generator Generator = {};
+
+    if(Params.FrameMemoryBudget == 0 || Params.FrameMemory == 0 || Params.TextStorage == TextStorage::None || Params.TextureFormat == TextureFormat::None)
+    {
+        return Generator;
+    }
+
+    if(Params.EmSize <= 0.f || (Params.TextStorage == TextStorage::SDF && Params.TextureFormat != TextureFormat::GreyScale))
+    {
+        return Generator;
+    }
+
+    // Arena Initialization
+    {
+        NTEXT_ASSERT(Params.FrameMemory);
+        NTEXT_ASSERT(Params.FrameMemoryBudget);
+
+        Generator.Arena = static_cast<memory_arena *>(Params.FrameMemory);
+        Generator.Arena->Reserved     = Params.FrameMemoryBudget;
+        Generator.Arena->BasePosition = 0;
+        Generator.Arena->Position     = sizeof(memory_arena);
+    }
+
+    // Glyph Table
+    {
+        glyph_table_params Params =
         {
-            Packer->Skyline[End] = Packer->Skyline[Start];
-        }
+            .GroupWidth = GlyphTableWidth::_128Bits,
+            .GroupCount = 64,
+        };
 
-        Packer->SkylineCount += (InsertedCount - RemovedCount);
-    } else
-    if(InsertedCount < RemovedCount)
+        // Buckets follow the metadata (a multiple of 16 bytes) and hold __m128i hashes.
+
+        uint64_t Footprint = GetGlyphTableFootprint(Params);
+        void    *Memory    = PushArena(Generator.Arena, Footprint, AlignOf(glyph_entry));
+
+        Generator.GlyphTable = PlaceGlyphTableInMemory(Params, Memory);
+
+        NTEXT_ASSERT(Generator.GlyphTable);
+    }
+
+    // Direct Glyphs
     {
-        // Copy from the first exclusive element to (Start - ElementsToRemoveCount)
-        // We basically start copying behind us and iterate until the end of the array.
+        Generator.DirectGlyphs = PushArray<cached_glyph>(Generator.Arena, DirectGlyphCount);
 
-        uint16_t Start = BestIndexExclusive;
-        uint16_t End   = Start - (RemovedCount - InsertedCount);
+        NTEXT_ASSERT(Generator.DirectGlyphs);
 
-        for(; Start < Packer->SkylineCount; ++Start, ++End)
+        for(uint32_t Idx = 0; Idx < DirectGlyphCount; ++Idx)
         {
-            Packer->Skyline[End] = Packer->Skyline[Start];
+            Generator.DirectGlyphs[Idx] = {};
+        }
+    }
+
+    // Pages
+    {
+        uint16_t PageCount = Params.CachePageCount ? Params.CachePageCount : 1;
+        PageCount = PageCount < MaxAtlasPageCount ? PageCount : static_cast<uint16_t>(MaxAtlasPageCount);
+
+        for(uint16_t Page = 0; Page < PageCount; ++Page)
+        {
+            uint64_t Footprint = GetRectanglePackerFootprint(Params.CacheSizeX);
+            void    *Memory    = PushArena(Generator.Arena, Footprint, AlignOf(void *));
+
+            Generator.Pages[Page] = PlaceRectanglePackerInMemory(Params.CacheSizeX, Params.CacheSizeY, Params.PackingHeuristic, Memory);
+
+            NTEXT_ASSERT(Generator.Pages[Page]);
         }
 
-        Packer->SkylineCount += (RemovedCount - InsertedCount);
+        Generator.PageCount       = PageCount;
+        Generator.ActivePageCount = 1;
     }
 
-    Packer->Skyline[BestIndexInclusive] = NewTopLeft;
-    if(HasBottomRightPoint)
+    // Constant Forwarding
     {
-        Packer->Skyline[BestIndexInclusive + 1] = NewBotRight;
+        NTEXT_ASSERT(Params.TextStorage   != TextStorage::None);
+        NTEXT_ASSERT(Params.TextureFormat != TextureFormat::None);
+
+        Generator.TextStorage   = Params.TextStorage;
+        Generator.TextureFormat = Params.TextureFormat;
+        Generator.EmSize        = Params.EmSize;
     }
 
-    // This is kind of a hack. Unsure why this work since I do not fully remember how this algorithm works.
-    // The caller assumes that we return the bottom left and this looks like it does the trick?
-    // No it doesn't. Wait I am confused.
+    // Backend Initialization
+    {
+        Generator.Backend = CreateBackendContext(Params.FamilyName);
 
-    Rectangle.WasPacked = 1;
-    Rectangle.X         = NewTopLeft.X;
-    Rectangle.Y         = NewBotRight.Y;
+        if(Generator.Backend.IsValid() && Generator.Backend.IsFixedPitch)
+        {
+            Generator.FixedAdvance = Generator.Backend.FindGlyphInformation(' ', Generator.EmSize).Advance;
+        }
+    }
+
+    Generator.FrameStart = Generator.Arena->Position;
+
+    return Generator;
+}
+
+
+// Frees every shaped_glyph_run returned since the last call. Call it once their
+// rasterized lists were uploaded and their layout buffers copied.
+
+static void
+ClearGlyphGeneratorFrame(glyph_generator &Generator)
+{
+    NTEXT_ASSERT(Generator.Arena);
+
+    Generator.Arena->Position = Generator.FrameStart;
+}
+
+
+static bool IsValidGlyphGenerator(const glyph_generator &GlyphGenerator)
+{
+    bool Result = (GlyphGenerator.Arena != 0);
+    return Result;
 }
 
 
 // ==================================================================================
-// @Public : NText Glyph Table Implementation
-// Placeholder: glyph table types and hash utilities
+// @Public : NText Collection
+// Placeholder: texture & atlas routines
 // ==================================================================================
 
-enum class GlyphTableWidth : uint64_t
+// FillAtlas only reserves the atlas rect of a glyph, Buffer stays empty until the list is
+// passed to RasterizeGlyphList.
+
+struct rasterized_glyph
 {
-    None     = 0,
-    _128Bits = 16,
+    rectangle         Source;
+    rasterized_buffer Buffer;
+    uint16_t          GlyphIndex;
+    float             Advance;
 };
 
+struct rasterized_glyph_node
+{
+    rasterized_glyph_node *Next;
+    rasterized_glyph       Value;
+};
 
-struct glyph_table_params
+struct rasterized_glyph_list
 {
-    GlyphTableWidth GroupWidth;
-    uint64_t        GroupCount;
+    rasterized_glyph_node *First;
+    rasterized_glyph_node *Last;
+    uint32_t               Count;
 };
 
+// SourceBuffer holds the atlas rect of every glyph in LayoutBuffer, empty for glyphs with
+// nothing to draw. Sources are only valid for AtlasVersion.
 
-struct glyph_hash
+struct shaped_glyph_run
 {
-    __m128i Value;
+    rasterized_glyph_list RasterizedList;
+    glyph_layout_info    *LayoutBuffer;
+    rectangle            *SourceBuffer;
+    uint32_t              LayoutBufferSize;
+    uint32_t              AtlasVersion;
 };
 
+static uint64_t GetTextureFormatBytesPerPixel(TextureFormat Format)
+{
+    switch(Format)
+    {
 
-struct glyph_tag
+    case TextureFormat::None:
+    {
+       return 0;
+    } break;
+
+    case TextureFormat::GreyScale:
+    {
+        return 1;
+    } break;
+
+    case TextureFormat::RGBA:
+    {
+        return 4;
+    } break;
+
+    }
+}
+
+// Converts a coverage buffer to a signed distance field padded by Spread texels on every
+// side. Texels on the contour (partially covered, or next to a texel on the other side) are
+// seeds: the outline is roughly Coverage - 0.5 away from their center. Every texel takes the
+// closest seed through two dead reckoning passes, which is linear in the texel count.
+// Distances are clamped to Spread and stored as 0.5 + D / (2 * Spread), positive inside.
+
+struct distance_seed
 {
-    uint8_t Value;
+    int16_t X;
+    int16_t Y;
 };
 
 
-struct glyph_layout_info
+static float
+GetSeedDistance(int32_t X, int32_t Y, bool IsInside, distance_seed Seed, int32_t Width, const float *Edge)
 {
-    float Advance;
-    float OffsetX;
-    float OffsetY;
-};
+    float DX     = static_cast<float>(Seed.X - X);
+    float DY     = static_cast<float>(Seed.Y - Y);
+    float Offset = Edge[Seed.Y * Width + Seed.X];
+    float Result = sqrtf(DX * DX + DY * DY) + (IsInside ? Offset : -Offset);
 
+    return Result;
+}
 
-struct glyph_entry
+
+static rasterized_buffer
+BuildDistanceField(rasterized_buffer Coverage, uint32_t Spread, memory_arena *Arena)
 {
-    glyph_hash        Hash;
+    rasterized_buffer Result = {};
 
-    uint32_t          PrevLRU;
-    uint32_t          NextLRU;
+    if(!Coverage.Data || Coverage.BytesPerPixel != 1 || Coverage.Width == 0 || Coverage.Height == 0)
+    {
+        return Result;
+    }
 
-    uint16_t          GlyphIndex;
-    rectangle         Source;
-    glyph_layout_info LayoutInfo;
-    bool              IsRasterized;
-};
+    int32_t SourceWidth  = static_cast<int32_t>(Coverage.Width);
+    int32_t SourceHeight = static_cast<int32_t>(Coverage.Height);
+    int32_t Pad          = static_cast<int32_t>(Spread);
+    int32_t Width        = SourceWidth  + 2 * Pad;
+    int32_t Height       = SourceHeight + 2 * Pad;
+    int32_t Count        = Width * Height;
 
+    uint8_t *Pixels = PushArrayNoZeroAligned<uint8_t>(Arena, (uint64_t)Count, 1);
+    if(!Pixels)
+    {
+        return Result;
+    }
 
-struct glyph_table
-{
-    uint8_t     *Metadata;
-    glyph_entry *Buckets;
+    // Coverage minus one half in padded coordinates, then the closest seed of every texel
+    // and the distance to the outline through it.
+    memory_region Region = EnterMemoryRegion(Arena);
 
-    uint64_t     GroupWidth;
-    uint64_t     GroupCount;
-    uint64_t     HashMask;
+    float         *Edge      = PushArrayNoZeroAligned<float        >(Arena, (uint64_t)Count, alignof(float        ));
+    float         *Distances = PushArrayNoZeroAligned<float        >(Arena, (uint64_t)Count, alignof(float        ));
+    distance_seed *Seeds     = PushArrayNoZeroAligned<distance_seed>(Arena, (uint64_t)Count, alignof(distance_seed));
+    if(!Edge || !Distances || !Seeds)
+    {
+        LeaveMemoryRegion(Region);
+        return Result;
+    }
 
-    uint32_t     SentinelIndex;
-};
+    for(int32_t Y = 0; Y < Height; ++Y)
+    {
+        for(int32_t X = 0; X < Width; ++X)
+        {
+            int32_t SourceX = X - Pad;
+            int32_t SourceY = Y - Pad;
+            float   Value   = 0.f;
 
+            if(SourceX >= 0 && SourceX < SourceWidth && SourceY >= 0 && SourceY < SourceHeight)
+            {
+                const uint8_t *Row = static_cast<const uint8_t *>(Coverage.Data) + SourceY * Coverage.Stride;
+                Value = Row[SourceX] / 255.f;
+            }
 
-struct glyph_state
+            Edge[Y * Width + X] = Value - 0.5f;
+        }
+    }
+
+    for(int32_t Y = 0; Y < Height; ++Y)
+    {
+        for(int32_t X = 0; X < Width; ++X)
+        {
+            int32_t Index    = Y * Width + X;
+            bool    IsInside = Edge[Index] >= 0.f;
+            bool    IsSeed   = fabsf(Edge[Index]) < 0.5f;
+
+            IsSeed = IsSeed || (X > 0          && (Edge[Index - 1    ] >= 0.f) != IsInside);
+            IsSeed = IsSeed || (X < Width  - 1 && (Edge[Index + 1    ] >= 0.f) != IsInside);
+            IsSeed = IsSeed || (Y > 0          && (Edge[Index - Width] >= 0.f) != IsInside);
+            IsSeed = IsSeed || (Y < Height - 1 && (Edge[Index + Width] >= 0.f) != IsInside);
+
+            Seeds    [Index] = IsSeed ? distance_seed{static_cast<int16_t>(X), static_cast<int16_t>(Y)} : distance_seed{-1, -1};
+            Distances[Index] = IsSeed ? fabsf(Edge[Index]) : FLT_MAX;
+        }
+    }
+
+    // Forward pass looks at the texels above and to the left, backward pass at the others.
+
+    static const int32_t Forward [4][2] = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}};
+    static const int32_t Backward[4][2] = {{ 1,  1}, {0,  1}, {-1, 1}, { 1, 0}};
+
+    for(uint32_t Pass = 0; Pass < 2; ++Pass)
+    {
+        const int32_t (*Neighbors)[2] = Pass == 0 ? Forward : Backward;
+
+        for(int32_t Row = 0; Row < Height; ++Row)
+        {
+            for(int32_t Column = 0; Column < Width; ++Column)
+            {
+                int32_t Y        = Pass == 0 ? Row    : Height - 1 - Row;
+                int32_t X        = Pass == 0 ? Column : Width  - 1 - Column;
+                int32_t Index    = Y * Width + X;
+                bool    IsInside = Edge[Index] >= 0.f;
+
+                for(uint32_t Idx = 0; Idx < 4; ++Idx)
+                {
+                    int32_t OtherX = X + Neighbors[Idx][0];
+                    int32_t OtherY = Y + Neighbors[Idx][1];
+
+                    if(OtherX >= 0 && OtherX < Width && OtherY >= 0 && OtherY < Height)
+                    {
+                        // Neighbors mostly share a seed, which needs no new distance.
+                        distance_seed Seed    = Seeds[OtherY * Width + OtherX];
+                        bool          IsKnown = Seed.X == Seeds[Index].X && Seed.Y == Seeds[Index].Y;
+
+                        if(Seed.X >= 0 && !IsKnown)
+                        {
+                            float Candidate = GetSeedDistance(X, Y, IsInside, Seed, Width, Edge);
+                            if(Candidate < Distances[Index])
+                            {
+                                Distances[Index] = Candidate;
+                                Seeds    [Index] = Seed;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    float MaxDistance = static_cast<float>(Spread);
+
+    for(int32_t Index = 0; Index < Count; ++Index)
+    {
+        float Distance = Distances[Index] < MaxDistance ? Distances[Index] : MaxDistance;
+        float Signed   = Edge[Index] >= 0.f ? Distance : -Distance;
+        float Encoded  = 0.5f + Signed / (2.f * MaxDistance);
+        Encoded = Encoded < 0.f ? 0.f : (Encoded > 1.f ? 1.f : Encoded);
+
+        Pixels[Index] = static_cast<uint8_t>(Encoded * 255.f + 0.5f);
+    }
+
+    LeaveMemoryRegion(Region);
+
+    Result.Data          = Pixels;
+    Result.Stride        = static_cast<uint32_t>(Width);
+    Result.Width         = static_cast<uint32_t>(Width);
+    Result.Height        = static_cast<uint32_t>(Height);
+    Result.BytesPerPixel = 1;
+
+    return Result;
+}
+
+
+// Reserves the atlas rect of a glyph of the given size, appending it to List on success.
+
+static bool
+PlaceGlyphInAtlas(uint16_t GlyphIndex, float Advance, uint16_t Width, uint16_t Height, glyph_generator &Generator, rasterized_glyph_list &List, rectangle &Source)
 {
-    uint32_t          Id;
-    uint16_t          GlyphIndex;
-    glyph_layout_info LayoutInfo;
-    rectangle         Source;
-    bool              IsRasterized;
-};
+    packed_rectangle Rectangle =
+    {
+        .Width  = Width,
+        .Height = Height,
+    };
 
+    uint16_t Page = 0;
 
-constexpr uint32_t GlyphTableInvalidEntry = 0xFFFFFFFFu;
-constexpr uint8_t  GlyphTableEmptyMask    = 1 << 6; 
-constexpr uint8_t  GlyphTableDeadMask     = 1 << 7;
-constexpr uint8_t  GlyphTableTagMask      = 0xFF & ~0x03;
+    for(; Page < Generator.ActivePageCount && !Rectangle.WasPacked; ++Page)
+    {
+        PackRectangle(Rectangle, Generator.Pages[Page]);
+    }
+
+    if(!Rectangle.WasPacked && Generator.ActivePageCount < Generator.PageCount)
+    {
+        Page = ++Generator.ActivePageCount;
 
+        PackRectangle(Rectangle, Generator.Pages[Page - 1]);
+    }
 
-static bool
-IsValidGlyphTable(glyph_table *Table)
-{
-    bool Result = Table && Table->Metadata && Table->Buckets;
-    return Result;
-}
+    if(Rectangle.WasPacked)
+    {
+        uint32_t PageY = (Page - 1) * Generator.Pages[0]->Height;
 
+        Source =
+        {
+            .Left   = static_cast<float>(Rectangle.X),
+            .Top    = static_cast<float>(PageY + Rectangle.Y),
+            .Right  = static_cast<float>(Rectangle.X + Rectangle.Width ),
+            .Bottom = static_cast<float>(PageY + Rectangle.Y + Rectangle.Height),
+        };
 
-static glyph_entry *
-GetGlyphEntry(uint64_t Index, glyph_table *Table)
-{
-    NTEXT_ASSERT(Table);
-    NTEXT_ASSERT(Index <= (Table->GroupCount * Table->GroupWidth)); // Could be sentinel.
+        auto *Node = PushStruct<rasterized_glyph_node>(Generator.Arena);
+        if(Node)
+        {
+            Node->Value.Buffer     = {};
+            Node->Value.Source     = Source;
+            Node->Value.GlyphIndex = GlyphIndex;
+            Node->Value.Advance    = Advance;
+            Node->Next             = 0;
 
-    glyph_entry *Result = Table->Buckets + Index;
-    return Result;
-}
+            if(!List.First)
+            {
+                List.First = Node;
+            }
 
-static glyph_entry *
-GetGlyphTableSentinel(glyph_table *Table)
-{
-    NTEXT_ASSERT(Table->SentinelIndex == Table->GroupCount * Table->GroupWidth);
+            if(List.Last)
+            {
+                List.Last->Next = Node;
+            }
 
-    glyph_entry *Result = Table->Buckets + Table->SentinelIndex;
-    return Result;
+            List.Last   = Node;
+            List.Count += 1;
+        }
+    }
+
+    return Rectangle.WasPacked;
 }
 
 
-static uint32_t
-GetGlyphGroupIndexFromHash(glyph_hash Hash, glyph_table *Table)
+static bool
+RepackCachedGlyph(uint16_t GlyphIndex, float Advance, rectangle &Source, glyph_generator &Generator, rasterized_glyph_list &List)
 {
-    uint64_t Low64  = _mm_cvtsi128_si64(Hash.Value);
-    uint32_t Result = (uint32_t)(Low64 & Table->HashMask);
+    uint16_t Width  = static_cast<uint16_t>(Source.Right  - Source.Left);
+    uint16_t Height = static_cast<uint16_t>(Source.Bottom - Source.Top );
 
+    bool Result = (Width == 0 || Height == 0) || PlaceGlyphInAtlas(GlyphIndex, Advance, Width, Height, Generator, List, Source);
     return Result;
 }
 
 
-static char unsigned OverhangMask[32] =
+// A survivor of an eviction, pointing back at its direct glyph or glyph table entry.
+
+struct repacked_glyph
 {
-    255, 255, 255, 255,  255, 255, 255, 255,  255, 255, 255, 255,  255, 255, 255, 255,
-    0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0
+    rectangle *Source;
+    bool      *IsRasterized;
+    float      Advance;
+    uint32_t   Order;         // Direct glyphs, then entries most recently used first
+    uint16_t   GlyphIndex;
+    uint16_t   Height;
+    bool       IsEntry;
 };
 
 
-static char unsigned DefaultSeed[16] =
+static int
+CompareRepackedGlyphs(const void *A, const void *B)
 {
-    178, 201, 95, 240, 40, 41, 143, 216,
-    2, 209, 178, 114, 232, 4, 176, 188
-};
+    const repacked_glyph *First  = static_cast<const repacked_glyph *>(A);
+    const repacked_glyph *Second = static_cast<const repacked_glyph *>(B);
 
+    int Result = First->Height != Second->Height ? (First->Height > Second->Height ? -1 : 1) :
+                 (First->Order < Second->Order ? -1 : (First->Order > Second->Order ? 1 : 0));
+    return Result;
+}
 
-static glyph_hash
-ComputeGlyphHash(size_t Count, char unsigned *At, char unsigned *Seedx16)
+
+// Evicts the coldest half of the glyph table and repacks every remaining glyph. Glyphs
+// which no longer fit are evicted as well. Glyphs emitted in List before the call are
+// dropped since they are emitted again. Returns false when nothing could be evicted.
+//
+// Survivors are repacked tallest first (ties in recency order): a skyline fed by sorted
+// heights leaves far fewer holes than one fed in arrival order, about 6% more of the page
+// holds glyphs before it is full again. Glyphs which no longer fit are then the shortest
+// ones rather than the coldest ones.
+
+static bool
+EvictAndRepackAtlas(glyph_generator &Generator, rasterized_glyph_list &List)
 {
-    glyph_hash Result = {0};
+    glyph_table *Table = Generator.GlyphTable;
 
-    __m128i HashValue = _mm_cvtsi64_si128(Count);
-    HashValue = _mm_xor_si128(HashValue, _mm_loadu_si128((__m128i *)Seedx16));
+    uint32_t KeepCount    = (Table->Count + 1) / 2;
+    uint32_t EvictedCount = EvictGlyphTableEntries(KeepCount, Table, Generator.Arena);
 
-    size_t ChunkCount = Count / 16;
-    while(ChunkCount--)
+    if(EvictedCount == 0)
     {
-        __m128i In = _mm_loadu_si128((__m128i *)At);
-        At += 16;
+        return false;
+    }
 
-        HashValue = _mm_xor_si128(HashValue, In);
-        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-        HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    for(uint16_t Page = 0; Page < Generator.ActivePageCount; ++Page)
+    {
+        ClearRectanglePacker(Generator.Pages[Page]);
     }
 
-    size_t Overhang = Count % 16;
+    Generator.ActivePageCount = 1;
+    List = {};
 
-    // Think there is a fix for that on the refterm issues tab.
+    // The array lives in the frame memory, the rasterized list is pushed after it.
 
-#if 0
-    __m128i In = _mm_loadu_si128((__m128i *)At);
-#else
-    char Temp[16];
-    __movsb((unsigned char *)Temp, At, Overhang);
-    __m128i In = _mm_loadu_si128((__m128i *)Temp);
-#endif
-    In = _mm_and_si128(In, _mm_loadu_si128((__m128i *)(OverhangMask + 16 - Overhang)));
+    repacked_glyph *Glyphs = PushArrayNoZeroAligned<repacked_glyph>(Generator.Arena, DirectGlyphCount + Table->Count, alignof(repacked_glyph));
+    uint32_t        Count  = 0;
 
-    HashValue = _mm_xor_si128(HashValue, In);
-    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
-    HashValue = _mm_aesdec_si128(HashValue, _mm_setzero_si128());
+    NTEXT_ASSERT(Glyphs);
 
-    Result.Value = HashValue;
+    for(uint32_t Idx = 0; Idx < DirectGlyphCount; ++Idx)
+    {
+        cached_glyph &Glyph = Generator.DirectGlyphs[Idx];
 
-    return Result;
-}
+        if(Glyph.IsRasterized)
+        {
+            Glyphs[Count] = {&Glyph.Source, &Glyph.IsRasterized, Glyph.LayoutInfo.Advance, Count, Glyph.GlyphIndex,
+                             static_cast<uint16_t>(Glyph.Source.Bottom - Glyph.Source.Top), false};
+            Count += 1;
+        }
+    }
 
+    uint32_t Index = GetGlyphTableSentinel(Table)->NextLRU;
+    while(Index != Table->SentinelIndex)
+    {
+        glyph_entry *Entry = GetGlyphEntry(Index, Table);
 
-static glyph_tag
-GetGlyphTagFromHash(glyph_hash Hash)
-{
-    uint64_t  Low64  = _mm_cvtsi128_si64(Hash.Value);
-    glyph_tag Result = {.Value = (uint8_t)(Low64 & 0x3F)};
+        if(Entry->IsRasterized)
+        {
+            Glyphs[Count] = {&Entry->Source, &Entry->IsRasterized, Entry->LayoutInfo.Advance, Count, Entry->GlyphIndex,
+                             static_cast<uint16_t>(Entry->Source.Bottom - Entry->Source.Top), true};
+            Count += 1;
+        }
 
-    return Result;
-}
+        Index = Entry->NextLRU;
+    }
 
+    qsort(Glyphs, Count, sizeof(repacked_glyph), CompareRepackedGlyphs);
 
-static bool
-GlyphHashesAreEqual(glyph_hash A, glyph_hash B)
-{
-    __m128i Compare = _mm_cmpeq_epi8(A.Value, B.Value);
-    int     Mask    = _mm_movemask_epi8(Compare);
+    for(uint32_t Idx = 0; Idx < Count; ++Idx)
+    {
+        repacked_glyph &Glyph = Glyphs[Idx];
 
-    return (Mask == 0xFFFF);
+        *Glyph.IsRasterized = RepackCachedGlyph(Glyph.GlyphIndex, Glyph.Advance, *Glyph.Source, Generator, List);
+        EvictedCount       += (Glyph.IsEntry && !*Glyph.IsRasterized) ? 1 : 0;
+    }
+
+    Generator.AtlasVersion      += 1;
+    Generator.Stats.RepackCount  += 1;
+    Generator.Stats.EvictedCount += EvictedCount;
+
+    return true;
 }
 
 
-static uint64_t
-GetGlyphTableFootprint(glyph_table_params Params)
-{
-    uint64_t SlotCount = Params.GroupCount * static_cast<uint32_t>(Params.GroupWidth);
+// Packs and rasterizes a single glyph, evicting cold glyphs until it fits. Glyphs with an
+// empty box (spaces) only carry layout info. The result is not rasterized if it did not
+// fit in an empty atlas, in which case nothing is drawn for it.
 
-    uint64_t MetadataSize = SlotCount * sizeof(uint8_t);
-    uint64_t BucketsSize  = (SlotCount + 1) * sizeof(glyph_entry); // Accounts for sentinel.
-    uint64_t Result       = MetadataSize + BucketsSize + sizeof(glyph_table);
+static cached_glyph
+RasterizeGlyph(uint32_t Codepoint, glyph_generator &Generator, rasterized_glyph_list &List)
+{
+    cached_glyph Result = {};
 
-    return Result;
-}
+    os_glyph_info Info = Generator.Backend.FindGlyphInformation(Codepoint, Generator.EmSize);
 
+    // This cast is wrong/dangerous. Should probably round up or allow floating points in the packer?
 
-static glyph_table *
-PlaceGlyphTableInMemory(glyph_table_params Params, void *Memory)
-{
-    glyph_table *Result = 0;
+    uint16_t Width  = static_cast<uint16_t>(Info.SizeX);
+    uint16_t Height = static_cast<uint16_t>(Info.SizeY);
 
-    if(Memory)
+    Result.GlyphIndex = Info.GlyphIndex;
+    Result.LayoutInfo =
     {
-        uint64_t SlotCount = Params.GroupCount * static_cast<uint32_t>(Params.GroupWidth);
+        .Advance = Info.Advance,
+        .OffsetX = Info.OffsetX,
+        .OffsetY = Info.OffsetY,
+    };
 
-        uint8_t     *Metadata = static_cast<uint8_t *>(Memory);
-        glyph_entry *Buckets  = reinterpret_cast<glyph_entry*>(Metadata + SlotCount);
+    // Distance fields extend past the glyph box, the pen offset moves back by the padding.
 
-        Result = reinterpret_cast<glyph_table *>(Buckets + SlotCount + 1); // Skip sentinel
-        Result->Metadata      = Metadata;
-        Result->Buckets       = Buckets;
-        Result->GroupWidth    = static_cast<uint64_t>(Params.GroupWidth);
-        Result->GroupCount    = Params.GroupCount;
-        Result->HashMask      = Params.GroupCount - 1; // Only used to find the group index, not the slot index
-        Result->SentinelIndex = SlotCount;
+    if(Generator.TextStorage == TextStorage::SDF && Width != 0 && Height != 0)
+    {
+        Width  += 2 * SDFSpread;
+        Height += 2 * SDFSpread;
 
+        Result.LayoutInfo.OffsetX -= (float)SDFSpread;
+        Result.LayoutInfo.OffsetY -= (float)SDFSpread;
+    }
 
-        for(uint32_t Idx = 0; Idx < SlotCount; ++Idx)
+    if(Width == 0 || Height == 0)
+    {
+        Result.IsRasterized = true;
+    }
+    else if(Width > Generator.Pages[0]->Width || Height > Generator.Pages[0]->Height)
+    {
+        Generator.Stats.FailedCount += 1;
+    }
+    else
+    {
+        while(!Result.IsRasterized)
         {
-            glyph_entry *Entry = GetGlyphEntry(Idx, Result);
-            Entry->GlyphIndex   = 0;
-            Entry->Source       = {};
-            Entry->LayoutInfo   = {};
-            Entry->IsRasterized = false;
-        }
+            Result.IsRasterized = PlaceGlyphInAtlas(Info.GlyphIndex, Info.Advance, Width, Height, Generator, List, Result.Source);
 
-        for(uint32_t Idx = 0; Idx < SlotCount; ++Idx)
-        {
-            Result->Metadata[Idx] = GlyphTableEmptyMask;
+            if(!Result.IsRasterized && !EvictAndRepackAtlas(Generator, List))
+            {
+                Generator.Stats.FailedCount += 1;
+                break;
+            }
         }
-
-        glyph_entry *Sentinel = GetGlyphTableSentinel(Result);
-        NTEXT_ASSERT(Sentinel);
-
-        Sentinel->PrevLRU = Result->SentinelIndex;
-        Sentinel->NextLRU = Result->SentinelIndex;
     }
 
     return Result;
 }
 
 
-// This will never trigger the LRU. Do we do some integer counting to figure out when it is full?
-// Simply recycle when we reach the maximum capacity? Sounds simple.
+// Fails with an empty run (LayoutBufferSize is 0) when the generator arena cannot hold the
+// buffers of the run, nothing is reserved in the atlas then.
 
-static glyph_state
-FindGlyphEntryByHash(glyph_hash Hash, glyph_table *Table)
+static shaped_glyph_run
+FillAtlas(char *Data, uint64_t Count, glyph_generator &Generator)
 {
-    NTEXT_ASSERT(Table);
+    shaped_glyph_run Run    = {};
+    memory_region    Region = EnterMemoryRegion(Generator.Arena);
 
-    glyph_entry *Result     = 0;
-    uint32_t     EntryIndex = GlyphTableInvalidEntry;
+    Run.LayoutBuffer = PushArray<glyph_layout_info>(Generator.Arena, Count);
+    Run.SourceBuffer = PushArray<rectangle>(Generator.Arena, Count);
 
-    uint32_t ProbeCount = 0;
-    uint32_t GroupIndex = GetGlyphGroupIndexFromHash(Hash, Table);
+    // NOTE:
+    // A codepoint takes at least one byte, so Count entries is always enough.
+    // Invalid sequences are drawn as the replacement character.
 
-    NTEXT_ASSERT(GroupIndex < Table->GroupCount);
+    uint32_t *Codepoints = PushArrayNoZeroAligned<uint32_t>(Generator.Arena, Count, alignof(uint32_t));
 
-    while(!Result)
+    if(!Run.LayoutBuffer || !Run.SourceBuffer || !Codepoints)
     {
-        uint8_t  *Meta = Table->Metadata + (GroupIndex * Table->GroupWidth);
-        glyph_tag Tag  = GetGlyphTagFromHash(Hash);
+        LeaveMemoryRegion(Region);
 
-        __m128i MetaVector = _mm_loadu_si128((__m128i *)Meta);
-        __m128i TagVector  = _mm_set1_epi8(Tag.Value);
+        Run              = {};
+        Run.AtlasVersion = Generator.AtlasVersion;
 
-        // Uses a 6 bit tags to search a matching tag through the meta-data vector.
-        // If found compare hashes and return if they match.
+        return Run;
+    }
 
-        int TagMask = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, TagVector));
-        while(TagMask)
+    uint32_t CodepointCount = DecodeUTF8ToCodepoints((const uint8_t *)Data, Count, Codepoints);
+    uint32_t AtlasVersion   = Generator.AtlasVersion;
+
+    for(uint32_t Idx = 0; Idx < CodepointCount; ++Idx)
+    {
+        uint32_t Codepoint = Codepoints[Idx] != InvalidCodepoint ? Codepoints[Idx] : ReplacementCodepoint;
+
+        glyph_layout_info LayoutInfo = {};
+        rectangle         Source     = {};
+
+        if(Codepoint < DirectGlyphCount)
         {
-            EntryIndex = FindFirstBit(TagMask) + (GroupIndex * Table->GroupWidth);
+            cached_glyph &Glyph = Generator.DirectGlyphs[Codepoint];
 
-            glyph_entry *Entry = GetGlyphEntry(EntryIndex, Table);
-            if(GlyphHashesAreEqual(Hash, Entry->Hash))
+            if(!Glyph.IsRasterized)
             {
-                Result = Entry;
-                break;
+                Glyph = RasterizeGlyph(Codepoint, Generator, Run.RasterizedList);
             }
 
-            TagMask &= TagMask - 1;
+            LayoutInfo = Glyph.LayoutInfo;
+            Source     = Glyph.IsRasterized ? Glyph.Source : rectangle{};
         }
-
-        if(!Result)
+        else
         {
-            __m128i EmptyVector = _mm_set1_epi8(GlyphTableEmptyMask);
-            int     EmptyMask   = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, EmptyVector));
+            glyph_table *Table = Generator.GlyphTable;
 
-            if(!EmptyMask)
+            if(Table->Count >= GetGlyphTableMaxCount(Table))
             {
-                ProbeCount++;
-                GroupIndex = (GroupIndex + (ProbeCount * ProbeCount)) & Table->HashMask ;
+                EvictAndRepackAtlas(Generator, Run.RasterizedList);
+            }
+
+            glyph_hash  Hash  = ComputeGlyphHash(sizeof(Codepoint), (char unsigned *)&Codepoint, DefaultSeed);
+            glyph_state State = FindGlyphEntryByHash(Hash, Table);
+
+            if(!State.IsRasterized)
+            {
+                uint32_t     AtlasVersion = Generator.AtlasVersion;
+                cached_glyph Glyph        = RasterizeGlyph(Codepoint, Generator, Run.RasterizedList);
+
+                // A repack rebuilds the table, the entry is kept (most recently used) but moved.
+
+                if(AtlasVersion != Generator.AtlasVersion)
+                {
+                    State = FindGlyphEntryByHash(Hash, Table);
+                }
+
+                if(Glyph.IsRasterized)
+                {
+                    UpdateGlyphTableEntry(State.Id, 1, Glyph.GlyphIndex, Glyph.LayoutInfo, Glyph.Source, Table);
+                    Source = Glyph.Source;
+                }
+
+                LayoutInfo = Glyph.LayoutInfo;
             }
             else
             {
-                EntryIndex = FindFirstBit(EmptyMask) + (GroupIndex * Table->GroupWidth);
-                break;
+                LayoutInfo = State.LayoutInfo;
+                Source     = State.Source;
             }
         }
+
+        Run.LayoutBuffer[Run.LayoutBufferSize  ] = LayoutInfo;
+        Run.SourceBuffer[Run.LayoutBufferSize++] = Source;
     }
 
-    if(Result)
-    {
-        // An existing entry was found, we simply pop it from the chain.
+    // A repack in the middle of the run moved the glyphs placed before it. Those that
+    // survived are found at their new place, the others are not drawn.
 
-        glyph_entry *Prev = GetGlyphEntry(Result->PrevLRU, Table);
-        glyph_entry *Next = GetGlyphEntry(Result->NextLRU, Table);
+    if(AtlasVersion != Generator.AtlasVersion)
+    {
+        for(uint32_t Idx = 0; Idx < CodepointCount; ++Idx)
+        {
+            uint32_t Codepoint = Codepoints[Idx] != InvalidCodepoint ? Codepoints[Idx] : ReplacementCodepoint;
 
-        NTEXT_ASSERT(Prev);
-        NTEXT_ASSERT(Next);
+            if(Codepoint < DirectGlyphCount)
+            {
+                cached_glyph &Glyph = Generator.DirectGlyphs[Codepoint];
+                Run.SourceBuffer[Idx] = Glyph.IsRasterized ? Glyph.Source : rectangle{};
+            }
+            else
+            {
+                glyph_hash  Hash  = ComputeGlyphHash(sizeof(Codepoint), (char unsigned *)&Codepoint, DefaultSeed);
+                glyph_state State = FindGlyphEntryByHash(Hash, Generator.GlyphTable);
 
-        Prev->NextLRU = Result->NextLRU;
-        Next->PrevLRU = Result->PrevLRU;
+                Run.SourceBuffer[Idx] = State.IsRasterized ? State.Source : rectangle{};
+            }
+        }
     }
-    else
-    {
-        // No existing entry was found, we simply allocate a new one by updating the metadata array.
 
-        NTEXT_ASSERT(EntryIndex != GlyphTableInvalidEntry);
+    Run.AtlasVersion = Generator.AtlasVersion;
 
-        // Since the tag is 00XX XXXX, we clear the state bits.
-        Table->Metadata[EntryIndex] = GetGlyphTagFromHash(Hash).Value;
+    return Run;
+}
 
-        Result = GetGlyphEntry(EntryIndex, Table);
-        Result->Hash = Hash;
+
+static shaped_glyph_run
+FillAtlas(const char *Data, uint64_t Count, glyph_generator &Generator)
+{
+    return FillAtlas((char *)Data, Count, Generator);
+}
+
+
+// Fast path for fixed pitch fonts: the width of printable ASCII text at EmSize is its byte
+// count times FixedAdvance, no glyph is looked up or reserved. Other bytes may not use the
+// fixed advance (tabs, control characters, wide or missing glyphs), thus the width is negative
+// when the text holds one of them or the font is proportional. The text must then be shaped
+// with FillAtlas.
+
+static float
+MeasureFixedPitchText(const char *Data, uint64_t Count, const glyph_generator &Generator)
+{
+    float Result = -1.f;
+
+    if(Generator.FixedAdvance <= 0.f)
+    {
+        return Result;
     }
 
-    glyph_entry *Sentinel = GetGlyphTableSentinel(Table);
-    NTEXT_ASSERT(Sentinel && Result != Sentinel);
+    const uint8_t *Bytes = (const uint8_t *)Data;
+    uint64_t       At    = 0;
 
-    Result->NextLRU = Sentinel->NextLRU;
-    Result->PrevLRU = Table->SentinelIndex;
+    // Bytes at or above 0x80 are negative once signed, they fail the lower bound.
 
-    glyph_entry *Head = GetGlyphEntry(Sentinel->NextLRU, Table);
-    Head->PrevLRU     = EntryIndex;
-    Sentinel->NextLRU = EntryIndex;
+    __m128i Low  = _mm_set1_epi8(0x1F);
+    __m128i High = _mm_set1_epi8(0x7F);
 
-    glyph_state State = {};
-    State.IsRasterized = Result->IsRasterized;
-    State.Id           = EntryIndex;
+    for(; At + 16 <= Count; At += 16)
+    {
+        __m128i Block     = _mm_loadu_si128((const __m128i *)(Bytes + At));
+        __m128i Printable = _mm_and_si128(_mm_cmpgt_epi8(Block, Low), _mm_cmplt_epi8(Block, High));
 
-    return State;
+        if(_mm_movemask_epi8(Printable) != 0xFFFF)
+        {
+            return Result;
+        }
+    }
+
+    for(; At < Count; ++At)
+    {
+        if(Bytes[At] < 0x20 || Bytes[At] > 0x7E)
+        {
+            return Result;
+        }
+    }
+
+    Result = Count * Generator.FixedAdvance;
+
+    return Result;
 }
 
 
+// Rasterizes a glyph reserved by FillAtlas into Arena. It only reads the generator, such
+// that glyphs may be rasterized on different threads as long as each one uses its own
+// arena. Single threaded callers pass the generator arena, the buffer then lives until
+// ClearGlyphGeneratorFrame. On Win32 the DirectWrite factory is shared (thread safe) and
+// nothing is written to disk unless NTEXT_DEBUG_DUMP_GLYPHS is defined.
+
 static void
-UpdateGlyphTableEntry(uint32_t Id, bool IsRasterized, uint16_t GlyphIndex, glyph_layout_info LayoutInfo, rectangle Source, glyph_table *Table)
+RasterizeGlyph(rasterized_glyph &Glyph, glyph_generator &Generator, memory_arena *Arena)
 {
-    glyph_entry *Entry = GetGlyphEntry(Id, Table);
-    NTEXT_ASSERT(Entry);
+    NTEXT_ASSERT(Arena);
 
-    Entry->IsRasterized = IsRasterized;
-    Entry->GlyphIndex   = GlyphIndex;
-    Entry->LayoutInfo   = LayoutInfo;
-    Entry->Source       = Source;
-}
+    // Shouldn't we check if this succeeded first?
+    rasterized_buffer Buffer = Generator.Backend.RasterizeGlyphToAlphaTexture(Glyph.GlyphIndex, Glyph.Advance, Generator.EmSize, Arena);
 
+    if(Generator.TextStorage == TextStorage::SDF)
+    {
+        Buffer = BuildDistanceField(Buffer, SDFSpread, Arena);
+    }
 
-// ==================================================================================
-// @Public : NText Context
-// Placeholder: generator and context management
-// ==================================================================================
+    NTEXT_ASSERT(!Buffer.Data || Buffer.BytesPerPixel == GetTextureFormatBytesPerPixel(Generator.TextureFormat));
 
-enum class TextStorage
-{
-    None      = 0,
-    LazyAtlas = 1,
-};
+    Glyph.Buffer = Buffer;
+}
 
 
-struct glyph_generator_params
+// Rasterizes the glyphs Start, Start + Stride, ... of a list returned by FillAtlas, see
+// RasterizeGlyph. Disjoint slices of one list may be rasterized on different threads.
+
+static void
+RasterizeGlyphList(rasterized_glyph_list &List, uint32_t Start, uint32_t Stride, glyph_generator &Generator, memory_arena *Arena)
 {
-    TextStorage TextStorage;
-    uint64_t    FrameMemoryBudget;
-    void       *FrameMemory;
-    uint16_t    CacheSizeX;
-    uint16_t    CacheSizeY;
-};
+    NTEXT_ASSERT(Stride);
 
+    uint32_t Index = 0;
 
-struct glyph_generator
-{
-    // Memory
-    memory_arena     *Arena;
+    for(rasterized_glyph_node *Node = List.First; Node; Node = Node->Next, ++Index)
+    {
+        if(Index >= Start && (Index - Start) % Stride == 0)
+        {
+            RasterizeGlyph(Node->Value, Generator, Arena);
+        }
+    }
+}
 
-    // Systems
-    glyph_table      *GlyphTable;
-    rectangle_packer *Packer;
 
-    // Misc
-    TextStorage       TextStorage;
-    backend_context   Backend;
-};
+// How well the open pages are used. Packed texels are the sources of the cached glyphs,
+// covered texels the area under the skylines: the space they took from the atlas. Their
+// ratio is the packing efficiency, the remainder of the page texels is still free.
 
-// Should we add a function to get the static footprint for the glyph generator?
+struct glyph_atlas_usage
+{
+    uint64_t PackedTexels;
+    uint64_t CoveredTexels;
+    uint64_t PageTexels;
+    uint16_t ActivePageCount;
+};
 
 
-static glyph_generator CreateGlyphGenerator(glyph_generator_params Params)
+static glyph_atlas_usage
+GetGlyphAtlasUsage(glyph_generator &Generator)
 {
-    glyph_generator Generator = {};
+    glyph_atlas_usage Result = {};
 
-    if(Params.FrameMemoryBudget == 0 || Params.FrameMemory == 0 || Params.TextStorage == TextStorage::None)
+    if(!IsValidGlyphGenerator(Generator))
     {
-        return Generator;
+        return Result;
     }
 
-    // Arena Initialization
-    {
-        NTEXT_ASSERT(Params.FrameMemory);
-        NTEXT_ASSERT(Params.FrameMemoryBudget);
-
-        Generator.Arena = static_cast<memory_arena *>(Params.FrameMemory);
-        Generator.Arena->Reserved     = Params.FrameMemoryBudget;
-        Generator.Arena->BasePosition = 0;
-        Generator.Arena->Position     = sizeof(memory_arena);
-    }
+    glyph_table *Table = Generator.GlyphTable;
 
-    // Glyph Table
+    for(uint32_t Idx = 0; Idx < DirectGlyphCount; ++Idx)
     {
-        glyph_table_params Params =
-        {
-            .GroupWidth = GlyphTableWidth::_128Bits,
-            .GroupCount = 64,
-        };
-
-        uint64_t Footprint = GetGlyphTableFootprint(Params);
-        void    *Memory    = PushArena(Generator.Arena, Footprint, AlignOf(void *));
-
-        Generator.GlyphTable = PlaceGlyphTableInMemory(Params, Memory);
+        cached_glyph &Glyph = Generator.DirectGlyphs[Idx];
 
-        NTEXT_ASSERT(Generator.GlyphTable);
+        if(Glyph.IsRasterized)
+        {
+            Result.PackedTexels += static_cast<uint64_t>((Glyph.Source.Right - Glyph.Source.Left) * (Glyph.Source.Bottom - Glyph.Source.Top));
+        }
     }
 
-    // Packer
+    uint32_t Index = GetGlyphTableSentinel(Table)->NextLRU;
+    while(Index != Table->SentinelIndex)
     {
-        uint64_t Footprint = GetRectanglePackerFootprint(Params.CacheSizeX);
-        void    *Memory    = PushArena(Generator.Arena, Footprint, AlignOf(void *));
+        glyph_entry *Entry = GetGlyphEntry(Index, Table);
 
-        Generator.Packer = PlaceRectanglePackerInMemory(Params.CacheSizeX, Params.CacheSizeY, Memory);
+        if(Entry->IsRasterized)
+        {
+            Result.PackedTexels += static_cast<uint64_t>((Entry->Source.Right - Entry->Source.Left) * (Entry->Source.Bottom - Entry->Source.Top));
+        }
 
-        NTEXT_ASSERT(Generator.Packer);
+        Index = Entry->NextLRU;
     }
 
-    // Constant Forwarding
+    for(uint16_t Page = 0; Page < Generator.ActivePageCount; ++Page)
     {
-        NTEXT_ASSERT(Params.TextStorage != TextStorage::None);
+        rectangle_packer *Packer = Generator.Pages[Page];
 
-        Generator.TextStorage = Params.TextStorage;
-    }
+        for(uint16_t Idx = 0; Idx < Packer->SkylineCount; ++Idx)
+        {
+            uint16_t Right = Idx + 1 < Packer->SkylineCount ? Packer->Skyline[Idx + 1].X : Packer->Width;
 
-    // Backend Initialization
-    {
-        Generator.Backend = CreateBackendContext();
-    }
+            Result.CoveredTexels += static_cast<uint64_t>(Right - Packer->Skyline[Idx].X) * Packer->Skyline[Idx].Y;
+        }
 
-    return Generator;
-}
+        Result.PageTexels += static_cast<uint64_t>(Packer->Width) * Packer->Height;
+    }
 
+    Result.ActivePageCount = Generator.ActivePageCount;
 
-static bool IsValidGlyphGenerator(const glyph_generator &GlyphGenerator)
-{
-    bool Result = (GlyphGenerator.Arena != 0);
     return Result;
 }
 
 
 // ==================================================================================
-// @Public : NText Collection
-// Placeholder: texture & atlas routines
+// @Internal : Glyph Cache Files
+// A cache file is the state of a generator: its direct glyphs, glyph table entries (coldest
+// first), the skylines and pixels of its open pages. A later run restores it and starts with every
+// glyph in place and nothing to rasterize. Structs are stored with the layout of this
+// build, GlyphCacheVersion must change with them. Files from another version, font file
+// or generator setup are rejected.
 // ==================================================================================
 
-enum class TextureFormat
+constexpr uint32_t GlyphCacheMagic   = 0x4358544Eu; // 'NTXC'
+constexpr uint32_t GlyphCacheVersion = 2;
+
+
+struct glyph_cache_header
 {
-    None      = 0,
-    RGBA      = 1,
-    GreyScale = 2,
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t FontStamp;
+    float    EmSize;
+    uint32_t TextStorage;
+    uint32_t TextureFormat;
+    uint16_t Width;           // Of a page
+    uint16_t Height;
+    uint32_t DirectCount;
+    uint32_t EntryCount;
+    uint32_t PageCount;       // Open pages, their skylines and their pixels follow each other
+    uint16_t SkylineCounts[MaxAtlasPageCount];
 };
 
 
-struct rasterized_glyph
+struct glyph_cache_entry
 {
+    glyph_hash        Hash;
+    uint16_t          GlyphIndex;
     rectangle         Source;
-    rasterized_buffer Buffer;
+    glyph_layout_info LayoutInfo;
 };
 
-struct rasterized_glyph_node
-{
-    rasterized_glyph_node *Next;
-    rasterized_glyph       Value;
-};
 
-struct rasterized_glyph_list
+// Offsets of the sections, each one is 16 bytes aligned.
+
+struct glyph_cache_layout
 {
-    rasterized_glyph_node *First;
-    rasterized_glyph_node *Last;
-    uint32_t               Count;
+    uint64_t Direct;
+    uint64_t Entries;
+    uint64_t Skyline;
+    uint64_t Pixels;
+    uint64_t Size;
 };
 
-struct shaped_glyph_run
+
+static glyph_cache_layout
+GetGlyphCacheLayout(uint32_t EntryCount, uint32_t SkylineCount, uint64_t PixelSize)
 {
-    rasterized_glyph_list RasterizedList;
-    glyph_layout_info    *LayoutBuffer;
-    uint32_t              LayoutBufferSize;
-};
+    glyph_cache_layout Result = {};
+    Result.Direct  = NTEXT_ALIGNPOW2(sizeof(glyph_cache_header), 16);
+    Result.Entries = NTEXT_ALIGNPOW2(Result.Direct  + DirectGlyphCount * sizeof(cached_glyph)    , 16);
+    Result.Skyline = NTEXT_ALIGNPOW2(Result.Entries + EntryCount       * sizeof(glyph_cache_entry), 16);
+    Result.Pixels  = NTEXT_ALIGNPOW2(Result.Skyline + SkylineCount     * sizeof(point)            , 16);
+    Result.Size    = Result.Pixels + PixelSize;
 
-static uint64_t GetTextureFormatBytesPerPixel(TextureFormat Format)
+    return Result;
+}
+
+
+static uint32_t
+CountCachedGlyphEntries(glyph_table *Table)
 {
-    switch(Format)
-    {
+    uint32_t Result = 0;
+    uint32_t Index  = GetGlyphTableSentinel(Table)->NextLRU;
 
-    case TextureFormat::None:
+    while(Index != Table->SentinelIndex)
     {
-       return 0;
-    } break;
+        glyph_entry *Entry = GetGlyphEntry(Index, Table);
 
-    case TextureFormat::GreyScale:
-    {
-        return 1;
-    } break;
+        Result += Entry->IsRasterized ? 1 : 0;
+        Index   = Entry->NextLRU;
+    }
 
-    case TextureFormat::RGBA:
-    {
-        return 4;
-    } break;
+    return Result;
+}
+
+
+static uint32_t
+CountOpenSkylinePoints(glyph_generator &Generator)
+{
+    uint32_t Result = 0;
 
+    for(uint16_t Page = 0; Page < Generator.ActivePageCount; ++Page)
+    {
+        Result += Generator.Pages[Page]->SkylineCount;
     }
+
+    return Result;
 }
 
-// TODO: Error checks.
 
-static shaped_glyph_run
-FillAtlas(char *Data, uint64_t Count, glyph_generator &Generator)
+static uint64_t
+GetGlyphCacheFootprint(glyph_generator &Generator)
 {
-    shaped_glyph_run Run = {};
-    Run.LayoutBuffer = PushArray<glyph_layout_info>(Generator.Arena, Count);
+    rectangle_packer *Page      = Generator.Pages[0];
+    uint64_t          PixelSize = (uint64_t)Page->Width * Page->Height * Generator.ActivePageCount * GetTextureFormatBytesPerPixel(Generator.TextureFormat);
+    uint64_t          Result    = GetGlyphCacheLayout(CountCachedGlyphEntries(Generator.GlyphTable), CountOpenSkylinePoints(Generator), PixelSize).Size;
 
-    uint32_t Advance     = 16;
-    __m128i  ComplexByte = _mm_set1_epi8(0x80);
+    return Result;
+}
 
-    bool HasComplexCharacter = false;
 
-    // TODO: Rewrite this loop in a better way, since the only goal is to early
-    // exit if we find a complex character.
+// ntext does not keep the atlas pixels, cached glyphs are rasterized again into the image
+// of the file.
 
-    uint32_t ParseCount = Count;
-    char    *ParseData  = Data;
+static void
+BakeCachedGlyph(uint16_t GlyphIndex, float Advance, rectangle Source, glyph_generator &Generator, uint8_t *Pixels, uint64_t Pitch)
+{
+    uint32_t Width  = static_cast<uint32_t>(Source.Right  - Source.Left);
+    uint32_t Height = static_cast<uint32_t>(Source.Bottom - Source.Top );
 
-    while(ParseCount)
+    if(Width == 0 || Height == 0)
     {
-        __m128i ContainsComplex = _mm_setzero_si128();
+        return;
+    }
 
-        while(ParseCount >= Advance)
-        {
-            __m128i Batch = _mm_loadu_si128((__m128i *) ParseData);
-            __m128i TestX = _mm_and_si128(Batch, ComplexByte);
+    memory_region Region = EnterMemoryRegion(Generator.Arena);
 
-            // NOTE:
-            // If we break early, is there a better instruction than a OR?
-            // This is not great.
+    rasterized_glyph Glyph = {};
+    Glyph.Source     = Source;
+    Glyph.GlyphIndex = GlyphIndex;
+    Glyph.Advance    = Advance;
 
-            ContainsComplex = _mm_or_si128(ContainsComplex, TestX);
-            if(_mm_movemask_epi8(ContainsComplex))
-            {
-                break;
-            }
+    RasterizeGlyph(Glyph, Generator, Generator.Arena);
 
-            ParseCount -= Advance;
-            ParseData  += Advance;
-        }
+    rasterized_buffer &Buffer = Glyph.Buffer;
 
-        HasComplexCharacter = _mm_movemask_epi8(ContainsComplex);
-        if(HasComplexCharacter)
-        {
-            break;
-        }
+    if(Buffer.Data)
+    {
+        uint32_t CopyWidth  = Buffer.Width  < Width  ? Buffer.Width  : Width;
+        uint32_t CopyHeight = Buffer.Height < Height ? Buffer.Height : Height;
+        uint8_t *Target     = Pixels + static_cast<uint64_t>(Source.Top) * Pitch + static_cast<uint64_t>(Source.Left) * Buffer.BytesPerPixel;
 
-        char Token = ParseData[0];
-        if(Token < 0)
+        for(uint32_t Y = 0; Y < CopyHeight; ++Y)
         {
-            HasComplexCharacter = 1;
-            break;
+            memcpy(Target + Y * Pitch, static_cast<uint8_t *>(Buffer.Data) + Y * Buffer.Stride, CopyWidth * Buffer.BytesPerPixel);
         }
-
-        ParseData++;
-        ParseCount--;
     }
 
-    if(HasComplexCharacter)
+    LeaveMemoryRegion(Region);
+}
+
+
+// Writes the cache file of the generator to Memory, which holds GetGlyphCacheFootprint
+// bytes. The generator arena is used as scratch. Returns the amount of bytes written, 0
+// on failure.
+
+static uint64_t
+WriteGlyphCache(glyph_generator &Generator, void *Memory, uint64_t Size)
+{
+    if(!IsValidGlyphGenerator(Generator) || !Memory)
     {
-        NTEXT_ASSERT(!"Not Implemented");
+        return 0;
     }
-    else
-    {
-        for(uint32_t Idx = 0; Idx < Count; ++Idx)
-        {
-            glyph_hash  Hash  = ComputeGlyphHash(1, (char unsigned *)&Data[Idx], DefaultSeed);
-            glyph_state State = FindGlyphEntryByHash(Hash, Generator.GlyphTable);
 
-            glyph_layout_info LayoutInfo = {};
+    glyph_table      *Table = Generator.GlyphTable;
+    rectangle_packer *First = Generator.Pages[0];
 
-            if(!State.IsRasterized)
-            {
-                os_glyph_info Info = Generator.Backend.FindGlyphInformation((uint32_t)Data[Idx], 16.f);
+    uint64_t           Pitch  = (uint64_t)First->Width * GetTextureFormatBytesPerPixel(Generator.TextureFormat);
+    uint32_t           Count  = CountCachedGlyphEntries(Table);
+    glyph_cache_layout Layout = GetGlyphCacheLayout(Count, CountOpenSkylinePoints(Generator), Pitch * First->Height * Generator.ActivePageCount);
 
-                // This cast is wrong/dangerous. Should probably round up or allow floating points in the packer?
+    if(Layout.Size > Size)
+    {
+        return 0;
+    }
 
-                packed_rectangle Rectangle =
-                {
-                    .Width  = static_cast<uint16_t>(Info.SizeX),
-                    .Height = static_cast<uint16_t>(Info.SizeY),
-                };
+    uint8_t *Base   = static_cast<uint8_t *>(Memory);
+    uint8_t *Pixels = Base + Layout.Pixels;
 
-                PackRectangle(Rectangle, Generator.Packer);
+    memset(Base, 0, Layout.Size);
 
-                if(Rectangle.WasPacked)
-                {
-                    // This cast is wrong/dangerous. Should probably round up or allow floating points in the packer?
-                    
-                    // This is just wrong. At least, what we return from the packer is confusing.
+    glyph_cache_header *Header = reinterpret_cast<glyph_cache_header *>(Base);
+    Header->Magic         = GlyphCacheMagic;
+    Header->Version       = GlyphCacheVersion;
+    Header->FontStamp     = Generator.Backend.FontStamp;
+    Header->EmSize        = Generator.EmSize;
+    Header->TextStorage   = static_cast<uint32_t>(Generator.TextStorage);
+    Header->TextureFormat = static_cast<uint32_t>(Generator.TextureFormat);
+    Header->Width         = First->Width;
+    Header->Height        = First->Height;
+    Header->DirectCount   = DirectGlyphCount;
+    Header->EntryCount    = Count;
+    Header->PageCount     = Generator.ActivePageCount;
 
-                    rectangle Source =
-                    {
-                        .Left   = static_cast<float>(Rectangle.X),
-                        .Top    = static_cast<float>(Rectangle.Y),
-                        .Right  = static_cast<float>(Rectangle.X + Rectangle.Width ),
-                        .Bottom = static_cast<float>(Rectangle.Y + Rectangle.Height),
-                    };
+    memcpy(Base + Layout.Direct, Generator.DirectGlyphs, DirectGlyphCount * sizeof(cached_glyph));
 
-                    // Shouldn't we check if this succeeded first?
-                    rasterized_buffer Buffer = Generator.Backend.RasterizeGlyphToAlphaTexture(Info.GlyphIndex, Info.Advance, 16.f, Generator.Arena);
+    point *Skyline = reinterpret_cast<point *>(Base + Layout.Skyline);
 
-                    auto *Node = PushStruct<rasterized_glyph_node>(Generator.Arena);
-                    if(Node)
-                    {
-                        rasterized_glyph_list &List = Run.RasterizedList;
+    for(uint16_t Page = 0; Page < Generator.ActivePageCount; ++Page)
+    {
+        rectangle_packer *Packer = Generator.Pages[Page];
 
-                        Node->Value.Buffer = Buffer;
-                        Node->Value.Source = Source;
+        Header->SkylineCounts[Page] = Packer->SkylineCount;
+        memcpy(Skyline, Packer->Skyline, Packer->SkylineCount * sizeof(point));
 
-                        if(!List.First)
-                        {
-                            List.First = Node;
-                        }
+        Skyline += Packer->SkylineCount;
+    }
 
-                        if(List.Last)
-                        {
-                            List.Last->Next = Node;
-                        }
+    for(uint32_t Idx = 0; Idx < DirectGlyphCount; ++Idx)
+    {
+        cached_glyph &Glyph = Generator.DirectGlyphs[Idx];
 
-                        List.Last   = Node;
-                        List.Count += 1;
-                    }
+        if(Glyph.IsRasterized)
+        {
+            BakeCachedGlyph(Glyph.GlyphIndex, Glyph.LayoutInfo.Advance, Glyph.Source, Generator, Pixels, Pitch);
+        }
+    }
 
-                    // Should we only update in the case that we allocated the node? That is a weird case.
+    glyph_cache_entry *Entries    = reinterpret_cast<glyph_cache_entry *>(Base + Layout.Entries);
+    uint32_t           EntryIndex = 0;
+    uint32_t           Index      = GetGlyphTableSentinel(Table)->PrevLRU;
 
-                    LayoutInfo =
-                    {
-                        .Advance = Info.Advance,
-                        .OffsetX = Info.OffsetX,
-                        .OffsetY = Info.OffsetY,
-                    };
+    while(Index != Table->SentinelIndex)
+    {
+        glyph_entry *Entry = GetGlyphEntry(Index, Table);
 
-                    UpdateGlyphTableEntry(State.Id, 1, Info.GlyphIndex, LayoutInfo, Source, Generator.GlyphTable);
-                }
-            }
-            else
-            {
-                LayoutInfo = State.LayoutInfo;
-            }
+        if(Entry->IsRasterized)
+        {
+            glyph_cache_entry &Cached = Entries[EntryIndex++];
+            Cached.Hash       = Entry->Hash;
+            Cached.GlyphIndex = Entry->GlyphIndex;
+            Cached.Source     = Entry->Source;
+            Cached.LayoutInfo = Entry->LayoutInfo;
 
-            Run.LayoutBuffer[Run.LayoutBufferSize++] = LayoutInfo;
+            BakeCachedGlyph(Entry->GlyphIndex, Entry->LayoutInfo.Advance, Entry->Source, Generator, Pixels, Pitch);
         }
+
+        Index = Entry->PrevLRU;
     }
 
-    return Run;
+    return Layout.Size;
 }
 
 
-static shaped_glyph_run
-FillAtlas(const char *Data, uint64_t Count, glyph_generator &Generator)
+// Restores a freshly created generator from a cache file. Returns the atlas pixels (rows
+// of the atlas width, tightly packed, ActivePageCount pages stacked on Y) which point
+// into Data, they must be uploaded before
+// the glyphs are drawn. Returns NULL and leaves the generator untouched when the file does
+// not match it.
+
+static const uint8_t *
+ReadGlyphCache(glyph_generator &Generator, const void *Data, uint64_t Size)
 {
-    return FillAtlas((char *)Data, Count, Generator);
+    const uint8_t *Result = 0;
+
+    if(!IsValidGlyphGenerator(Generator) || !Data || Size < sizeof(glyph_cache_header))
+    {
+        return Result;
+    }
+
+    glyph_table      *Table = Generator.GlyphTable;
+    rectangle_packer *First = Generator.Pages[0];
+
+    const uint8_t            *Base   = static_cast<const uint8_t *>(Data);
+    const glyph_cache_header *Header = reinterpret_cast<const glyph_cache_header *>(Base);
+
+    bool Matches = Header->Magic         == GlyphCacheMagic                             &&
+                   Header->Version       == GlyphCacheVersion                           &&
+                   Header->FontStamp     == Generator.Backend.FontStamp                 &&
+                   Header->FontStamp     != 0                                           &&
+                   Header->EmSize        == Generator.EmSize                            &&
+                   Header->TextStorage   == static_cast<uint32_t>(Generator.TextStorage)   &&
+                   Header->TextureFormat == static_cast<uint32_t>(Generator.TextureFormat) &&
+                   Header->Width         == First->Width                                &&
+                   Header->Height        == First->Height                               &&
+                   Header->DirectCount   == DirectGlyphCount                            &&
+                   Header->EntryCount    <= GetGlyphTableMaxCount(Table)                &&
+                   Header->PageCount     >= 1                                           &&
+                   Header->PageCount     <= Generator.PageCount                         &&
+                   Table->Count          == 0;
+
+    uint32_t SkylineCount = 0;
+
+    for(uint32_t Page = 0; Matches && Page < Header->PageCount; ++Page)
+    {
+        Matches       = Header->SkylineCounts[Page] >= 1 && Header->SkylineCounts[Page] <= First->Width;
+        SkylineCount += Header->SkylineCounts[Page];
+    }
+
+    uint64_t           Pitch  = (uint64_t)First->Width * GetTextureFormatBytesPerPixel(Generator.TextureFormat);
+    glyph_cache_layout Layout = GetGlyphCacheLayout(Header->EntryCount, SkylineCount, Pitch * First->Height * Header->PageCount);
+
+    if(!Matches || Layout.Size > Size)
+    {
+        return Result;
+    }
+
+    memcpy(Generator.DirectGlyphs, Base + Layout.Direct, DirectGlyphCount * sizeof(cached_glyph));
+
+    const uint8_t *Skyline = Base + Layout.Skyline;
+
+    for(uint32_t Page = 0; Page < Header->PageCount; ++Page)
+    {
+        rectangle_packer *Packer = Generator.Pages[Page];
+
+        memcpy(Packer->Skyline, Skyline, Header->SkylineCounts[Page] * sizeof(point));
+
+        Packer->SkylineCount = Header->SkylineCounts[Page];
+        Skyline             += Header->SkylineCounts[Page] * sizeof(point);
+    }
+
+    Generator.ActivePageCount = static_cast<uint16_t>(Header->PageCount);
+
+    // Coldest first, such that the LRU order is preserved.
+
+    for(uint32_t Idx = 0; Idx < Header->EntryCount; ++Idx)
+    {
+        glyph_cache_entry Cached;
+        memcpy(&Cached, Base + Layout.Entries + Idx * sizeof(glyph_cache_entry), sizeof(glyph_cache_entry));
+
+        glyph_state State = FindGlyphEntryByHash(Cached.Hash, Table);
+        UpdateGlyphTableEntry(State.Id, 1, Cached.GlyphIndex, Cached.LayoutInfo, Cached.Source, Table);
+    }
+
+    Result = Base + Layout.Pixels;
+
+    return Result;
 }
 
 
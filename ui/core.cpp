@@ -295,6 +295,7 @@ typedef struct ui_resource_entry
 
     UIResource_Type ResourceType;
     void           *Memory;
+    uint32_t        Version;
 } ui_resource_entry;
 
 typedef struct ui_resource_table
@@ -305,6 +306,7 @@ typedef struct ui_resource_table
     uint32_t              HashMask;
     uint32_t              HashSlotCount;
     uint32_t              EntryCount;
+    uint32_t              Version;
 
     uint32_t             *HashTable;
     ui_resource_entry    *Entries;
@@ -488,10 +490,14 @@ MakeGlobalResourceKey(UIResource_Type Type, byte_string Name)
     return Key;
 }
 
+// The zero key is never produced by the Make*ResourceKey functions (the type is never
+// UIResource_None), it is used for "no resource".
+
 static bool
 IsValidResourceKey(ui_resource_key Key)
 {
-    return true;
+    bool Result = !_mm_testz_si128(Key.Value, Key.Value);
+    return Result;
 }
 
 static ui_resource_state
@@ -565,6 +571,7 @@ FindResourceByKey(ui_resource_key Key, ui_resource_table *Table)
     Result.Id           = EntryIndex;
     Result.ResourceType = FoundEntry->ResourceType;
     Result.Resource     = FoundEntry->Memory;
+    Result.Version      = FoundEntry->Version;
 
     return Result;
 }
@@ -582,9 +589,13 @@ UpdateResourceTable(uint32_t Id, ui_resource_key Key, void *Memory, ui_resource_
         OSRelease(Entry->Memory);
     }
 
+    // Versions come from the table such that a recycled entry never repeats one.
+    Table->Version += 1;
+
     Entry->Key          = Key;
     Entry->Memory       = Memory;
     Entry->ResourceType = GetResourceTypeFromKey(Key);
+    Entry->Version      = Table->Version;
 
     VOID_ASSERT(Entry->ResourceType != UIResource_None);
 }
@@ -671,22 +682,98 @@ void ui_node::SetText(byte_string Text, ui_resource_key FontKey, ui_pipeline &Pi
     ui_resource_key   TextKey   = MakeNodeResourceKey(UIResource_Text, Index, Pipeline.Tree);
     ui_resource_state TextState = FindResourceByKey(TextKey, Context.ResourceTable);
 
-    if(!TextState.Resource)
+    // Setting the same text again keeps the resource and its version, thus nothing is damaged.
+
+    if(TextState.Resource)
     {
-        ui_resource_state FontState = FindResourceByKey(FontKey, Context.ResourceTable);
-        if(FontState.Resource)
+        ui_text *Current = static_cast<ui_text *>(TextState.Resource);
+        if(ResourceKeyAreEqual(Current->FontKey, FontKey) && Current->String.Size == Text.Size &&
+           MemoryCompare(Current->String.String, Text.String, Text.Size) == 0)
         {
-            // TODO: Create the text resource.
+            return;
         }
     }
-    else
+
+    uint64_t  Size   = GetTextFootprint(Text.Size);
+    void     *Memory = AllocateUIResource(Size, &Context.ResourceTable->Allocator);
+
+    ui_text *Resource = PlaceTextInMemory(Text, FontKey, Memory);
+    if(Resource)
+    {
+        UpdateResourceTable(TextState.Id, TextKey, Resource, Context.ResourceTable);
+        SetLayoutNodeFlags(Index, UILayoutNode_HasText, Pipeline.Tree);
+    }
+}
+
+// Declaring the same buffer again keeps the caret and the caret index. The buffer then holds
+// a gap: edits must go through ReplaceTextInput and reads through GetTextInputString.
+
+void ui_node::SetTextInput(uint8_t *Buffer, uint64_t BufferSize, ui_resource_key FontKey, ui_pipeline &Pipeline)
+{
+    void_context &Context  = GetVoidContext();
+
+    ui_resource_key   InputKey   = MakeNodeResourceKey(UIResource_TextInput, Index, Pipeline.Tree);
+    ui_resource_state InputState = FindResourceByKey(InputKey, Context.ResourceTable);
+    ui_text_input     Previous   = {};
+
+    if(InputState.Resource)
+    {
+        ui_text_input *Current = static_cast<ui_text_input *>(InputState.Resource);
+        if(Current->Buffer == Buffer && Current->Capacity == BufferSize && ResourceKeyAreEqual(Current->FontKey, FontKey))
+        {
+            return;
+        }
+
+        // The buffer holds a gap, it is closed such that the new input reads the content.
+        // The same buffer keeps its caret and its notifications.
+
+        GetTextInputString(Current);
+        ReleaseTextInput(Current);
+
+        if(Current->Buffer == Buffer)
+        {
+            Previous = *Current;
+        }
+    }
+
+    uint64_t  Size   = GetTextInputFootprint();
+    void     *Memory = AllocateUIResource(Size, &Context.ResourceTable->Allocator);
+
+    ui_text_input *Resource = PlaceTextInputInMemory(Buffer, BufferSize, FontKey, Memory);
+    if(Resource)
     {
-        VOID_ASSERT(!"Unsure");
+        if(Previous.Buffer)
+        {
+            Resource->Caret    = Min(Previous.Caret , Resource->Size);
+            Resource->Anchor   = Min(Previous.Anchor, Resource->Size);
+            Resource->Version  = Previous.Version + 1;
+            Resource->OnEdit   = Previous.OnEdit;
+            Resource->UserData = Previous.UserData;
+        }
+
+        UpdateResourceTable(InputState.Id, InputKey, Resource, Context.ResourceTable);
+        SetLayoutNodeFlags(Index, UILayoutNode_HasTextInput, Pipeline.Tree);
     }
 }
 
-void ui_node::SetTextInput(uint8_t *Buffer, uint64_t BufferSize, ui_pipeline &Pipeline)
+// Must follow SetTextInput, nodes without a text input are ignored.
+
+void ui_node::SetTextEdit(ui_text_input_onedit OnEdit, void *UserData, ui_pipeline &Pipeline)
 {
+    void_context &Context = GetVoidContext();
+
+    ui_resource_key   Key   = MakeNodeResourceKey(UIResource_TextInput, Index, Pipeline.Tree);
+    ui_resource_state State = FindResourceByKey(Key, Context.ResourceTable);
+
+    VOID_ASSERT(State.Resource && "SetTextEdit called on a node without a text input");
+    if(!State.Resource || State.ResourceType != UIResource_TextInput)
+    {
+        return;
+    }
+
+    ui_text_input *Input = static_cast<ui_text_input *>(State.Resource);
+    Input->OnEdit   = OnEdit;
+    Input->UserData = UserData;
 }
 
 // This is badly implemented.
@@ -770,6 +857,11 @@ UIBeginFrame(vec2_int WindowSize)
 
     static ui_pointer_state PointerStates[1];
 
+    Context.FrameHadInput = OSHasInputs(OSGetInputs());
+    Context.WakeDeadline  = 0;
+
+    ResetGlyphBudget(Context.GlyphQueue);
+
     // It seems like processing the pointer events here is the better idea.
     // But we need some kind of UI side state. Which maps to some pointer.
     // One bad thing that can probably be fixed with better logic is that
@@ -794,7 +886,7 @@ UIBeginFrame(vec2_int WindowSize)
                 // Not great.
                 ui_pipeline &Pipeline = Context.PipelineArray[static_cast<uint32_t>(State.PipelineSource)];
 
-                HandlePointerMove(Event.Delta, Pipeline.Tree);
+                HandlePointerMove(State.Position, Event.Delta, Pipeline.Tree);
             }
         } break;
 
@@ -847,6 +939,23 @@ UIBeginFrame(vec2_int WindowSize)
         }
     }
 
+    // Text events follow the pointer events, such that a click moves the focus first.
+
+    os_inputs *Inputs = OSGetInputs();
+
+    for(uint32_t EventIdx = 0; EventIdx < Inputs->TextEventCount; ++EventIdx)
+    {
+        for(uint32_t Idx = 0; Idx < Context.PipelineCount; ++Idx)
+        {
+            ui_pipeline &Pipeline = Context.PipelineArray[Idx];
+
+            if(Pipeline.Tree && HandleTextEvent(Inputs->TextEvents[EventIdx], Pipeline.Tree))
+            {
+                break;
+            }
+        }
+    }
+
     // If _some_ ButtonMask is 0 then it means the pointer is in a hover state.
     // We look for that hover target in any of the pipelines.
 
@@ -869,13 +978,70 @@ UIBeginFrame(vec2_int WindowSize)
         }
     }
 
+    // Damage is rebuilt by every pipeline painted this frame. A resize invalidates everything.
+    {
+        BeginRenderDamage(&RenderState.PassList);
+
+        if(!(WindowSize == Context.WindowSize))
+        {
+            MarkRenderDamageFull(&RenderState.PassList);
+        }
+    }
+
     Context.WindowSize = WindowSize;
 }
 
-static void
+static ui_frame_status
 UIEndFrame(void)
 {
-    // TODO: Something.
+    void_context &Context = GetVoidContext();
+
+    // Pipelines that were not painted this frame leave their previous area behind.
+
+    for(uint32_t Idx = 0; Idx < Context.PipelineCount; ++Idx)
+    {
+        ui_pipeline &Pipeline = Context.PipelineArray[Idx];
+
+        if(!Pipeline.Painted && Pipeline.Tree)
+        {
+            ComputePaintDamage   ({}, GetLastPaintBuffer(Pipeline.Tree));
+            ResetLastPaintBuffer (Pipeline.Tree);
+        }
+
+        Pipeline.Painted = false;
+    }
+
+    if(Context.ShapedRunCache)
+    {
+        ProfileShapedRunCache(Context.ShapedRunCache);
+    }
+
+    // Anything visible shows up as damage (layout, styles, resources). Pending texture
+    // uploads must be submitted even if nothing references them yet.
+
+    render_pass_list *PassList = &RenderState.PassList;
+
+    ui_frame_status Result = {};
+    Result.NeedsRepaint = PassList->Damage.Full || PassList->Damage.Count > 0 || PassList->FirstUpdate;
+    Result.HadInput     = Context.FrameHadInput;
+    Result.WakeDeadline = Context.WakeDeadline;
+
+    return Result;
+}
+
+// Called by anything that changes over time without input (animations, timers). The
+// earliest request of the frame wins.
+
+static void
+UIRequestWake(float DelayInSeconds)
+{
+    void_context &Context = GetVoidContext();
+
+    uint64_t Deadline = OSReadTimer() + (uint64_t)(Max(DelayInSeconds, 0.f) * (float)OSGetTimerFrequency());
+    if(!Context.WakeDeadline || Deadline < Context.WakeDeadline)
+    {
+        Context.WakeDeadline = Deadline;
+    }
 }
 
 // ==================================================================================
@@ -917,6 +1083,28 @@ CreateVoidContext(void)
 
         VOID_ASSERT(Context.ResourceTable);
     }
+
+    // Text
+    {
+        ui_shaped_run_cache_params CacheParams =
+        {
+            .HashSlotCount = 256,
+            .EntryCount    = 1024,
+            .ByteBudget    = VOID_MEGABYTE(4),
+        };
+
+        uint64_t CacheFootprint = GetShapedRunCacheFootprint(CacheParams);
+        void    *CacheMemory    = PushArena(Context.StateArena, CacheFootprint, AlignOf(ui_resource_key));
+
+        Context.ShapedRunCache = PlaceShapedRunCacheInMemory(CacheParams, CacheMemory);
+
+        VOID_ASSERT(Context.ShapedRunCache);
+
+        Context.GlyphWorkers = CreateGlyphWorkers(Context.StateArena);
+        Context.GlyphQueue   = CreateGlyphQueue(Context.StateArena);
+
+        VOID_ASSERT(Context.GlyphQueue);
+    }
 }
 
 static uint64_t
@@ -998,8 +1186,20 @@ UIUnbindPipeline(UIPipeline UserPipeline)
 
     if(Pipeline.Bound)
     {
-        PreOrderMeasureTree   (Pipeline.Tree, Pipeline.FrameArena);
-        PostOrderMeasureTree  (0            , Pipeline.Tree);          // WARN: Passing 0 is not always correct.
+        // Render data must outlive the pipeline's frame arena when a render thread consumes it.
+        // Glyphs shaped while measuring text (or left pending by earlier frames) are uploaded
+        // from it as well.
+
+        memory_arena *RenderArena = GetRenderFrameArena();
+        if(!RenderArena)
+        {
+            RenderArena = Pipeline.FrameArena;
+        }
+
+        CompletePendingGlyphs(RenderArena);
+
+        PreOrderMeasureTree   (Pipeline.Tree, Pipeline.FrameArena, RenderArena);
+        PostOrderMeasureTree  (0            , Pipeline.Tree, RenderArena);          // WARN: Passing 0 is not always correct.
         PlaceLayoutTree       (Pipeline.Tree, Pipeline.FrameArena);
 
         // NOTE: Not a fan of this flow. But it does seem to be better than what we had.
@@ -1007,9 +1207,14 @@ UIUnbindPipeline(UIPipeline UserPipeline)
         ui_paint_buffer Buffer = GeneratePaintBuffer(Pipeline.Tree, Pipeline.StyleArray, Pipeline.FrameArena);
         if(Buffer.Commands && Buffer.Size)
         {
-            ExecutePaintCommands(Buffer, Pipeline.FrameArena);
+            ExecutePaintCommands(Buffer, RenderArena);
         }
 
+        ComputePaintDamage(Buffer, GetLastPaintBuffer(Pipeline.Tree));
+        SwapPaintBuffers  (Buffer, Pipeline.Tree);
+
+        Pipeline.Painted = true;
+
         Pipeline.Bound = false;
     }
 }
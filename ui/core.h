@@ -103,7 +103,8 @@ typedef struct ui_rect
     ui_color         ColorTR;
     ui_color         ColorBR;
     ui_corner_radius CornerRadii;
-    float            BorderWidth, Softness, SampleTexture, _P0; // Style Params
+    float            BorderWidth, Softness, SampleTexture;       // Style Params
+    uint32_t         ClipIndex;                                  // Index in the pass clip table
 } ui_rect;
 
 // ------------------------------------------------------------------------------------
@@ -119,6 +120,21 @@ typedef enum UIEvent_State
 typedef UIEvent_State (*ui_text_input_onchar)  (uint8_t Char, void *UserData);
 typedef UIEvent_State (*ui_text_input_onkey)   (OSInputKey_Type Key, void *UserData);
 
+// Sent after every edit of a text input. Line indices are those of the content after the
+// edit: RemovedLineCount lines at FirstLine were replaced by InsertedLineCount lines.
+
+typedef struct ui_text_edit
+{
+    uint64_t Offset;
+    uint64_t RemovedSize;
+    uint64_t InsertedSize;
+    uint32_t FirstLine;
+    uint32_t RemovedLineCount;
+    uint32_t InsertedLineCount;
+} ui_text_edit;
+
+typedef void          (*ui_text_input_onedit)  (ui_text_edit Edit, void *UserData);
+
 
 
 // -----------------------------------------------------------------------------------
@@ -161,7 +177,8 @@ typedef struct ui_node_table_params
 
 #include <immintrin.h>
 
-typedef struct ui_resource_table ui_resource_table;
+typedef struct ui_resource_table   ui_resource_table;
+typedef struct ui_shaped_run_cache ui_shaped_run_cache;
 typedef struct ui_text ui_text;
 
 typedef enum UIResource_Type
@@ -197,6 +214,7 @@ typedef struct ui_resource_state
     uint32_t        Id;
     UIResource_Type ResourceType;
     void           *Resource;
+    uint32_t        Version;        // Changes every time the resource is updated
 } ui_resource_state;
 
 static uint64_t            GetResourceTableFootprint   (ui_resource_table_params Params);
@@ -247,7 +265,8 @@ struct ui_node
 
     // Resource
     void     SetText          (byte_string Text, ui_resource_key FontKey, ui_pipeline &Pipeline);
-    void     SetTextInput     (uint8_t *Buffer, uint64_t BufferSize, ui_pipeline &Pipeline);
+    void     SetTextInput     (uint8_t *Buffer, uint64_t BufferSize, ui_resource_key FontKey, ui_pipeline &Pipeline);
+    void     SetTextEdit      (ui_text_input_onedit OnEdit, void *UserData, ui_pipeline &Pipeline);
     void     SetScroll        (float ScrollSpeed, UIAxis_Type Axis, ui_pipeline &Pipeline);
     void     SetImage         (byte_string Path, byte_string Group, ui_pipeline &Pipeline);
 
@@ -264,8 +283,22 @@ struct pointer_event_node;
 struct pointer_event_list;
 static void ConsumePointerEvent  (pointer_event_node *Node, pointer_event_list *List);
 
-static void UIBeginFrame  (vec2_int WindowSize);
-static void UIEndFrame    (void);
+// Frame Status:
+//   UIEndFrame reports whether the frame changed anything visible (NeedsRepaint) and whether
+//   inputs were processed (HadInput). When neither is set, hosts may skip rendering and
+//   block on the next OS event. WakeDeadline (OSReadTimer ticks, 0 = none) is the earliest
+//   time something asked to run again, such as an animation, see UIRequestWake.
+
+struct ui_frame_status
+{
+    bool     NeedsRepaint;
+    bool     HadInput;
+    uint64_t WakeDeadline;
+};
+
+static void            UIBeginFrame   (vec2_int WindowSize);
+static ui_frame_status UIEndFrame     (void);
+static void            UIRequestWake  (float DelayInSeconds);
 
 // -----------------------------------------------------------------------------------
 
@@ -316,6 +349,7 @@ struct ui_pipeline
     // Misc
     uint32_t ZIndex;
     bool     Bound;
+    bool     Painted;       // Reset by UIEndFrame, used to damage pipelines that stop painting
     uint64_t NodeCount;
 };
 
@@ -332,6 +366,8 @@ static ui_pipeline_params UIGetDefaultPipelineParams  (void);
 // Because it could fit in the global resource pattern as far as I understand?
 
 struct ui_font;
+struct ui_glyph_workers;
+struct ui_glyph_queue;
 typedef struct ui_font_list
 {
     ui_font *First;
@@ -345,14 +381,22 @@ struct void_context
     memory_arena      *StateArena;
 
     // State
-    ui_resource_table *ResourceTable;
+    ui_resource_table   *ResourceTable;
+    ui_shaped_run_cache *ShapedRunCache;
+    ui_glyph_workers    *GlyphWorkers;
+    ui_glyph_queue      *GlyphQueue;
     ui_pipeline        PipelineArray[PipelineCount];
     uint32_t           PipelineCount;
 
-    ui_font_list     Fonts; // TODO: Find a solution such that this is a global resource.
+    ui_font_list     Fonts; // Faces. TODO: Find a solution such that this is a global resource.
+    byte_string      GlyphCacheDirectory;
 
     // State
     vec2_int   WindowSize;
+
+    // Frame
+    bool       FrameHadInput;
+    uint64_t   WakeDeadline;
 };
 
 static void_context GlobalVoidContext;
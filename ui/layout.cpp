@@ -125,8 +125,11 @@ typedef struct ui_layout_tree
     // State
     ui_parent_list    ParentList;
     uint32_t          CapturedNodeIndex;
+    uint32_t          FocusedNodeIndex;   // Text input receiving text events
 
     ui_paint_command *PaintBuffer;
+    ui_paint_command *LastPaintBuffer;
+    uint32_t          LastPaintCount;
 } ui_layout_tree;
 
 static bool
@@ -249,7 +252,7 @@ static uint64_t
 GetLayoutTreeFootprint(uint64_t NodeCount)
 {
     uint64_t ArraySize = NodeCount * sizeof(ui_layout_node);
-    uint64_t PaintSize = NodeCount * sizeof(ui_paint_command);
+    uint64_t PaintSize = NodeCount * sizeof(ui_paint_command) * 2;
     uint64_t Result    = sizeof(ui_layout_tree) + ArraySize + PaintSize;
 
     return Result;
@@ -262,14 +265,18 @@ PlaceLayoutTreeInMemory(uint64_t NodeCount, void *Memory)
 
     if (Memory)
     {
-        ui_layout_node   *Nodes      = static_cast<ui_layout_node*>(Memory);
-        ui_paint_command *PaintBuffer = reinterpret_cast<ui_paint_command *>(Nodes + NodeCount);
-
-        Result = reinterpret_cast<ui_layout_tree *>(PaintBuffer + NodeCount);
-        Result->Nodes        = Nodes;
-        Result->PaintBuffer  = PaintBuffer;
-        Result->NodeCount    = 0;
-        Result->NodeCapacity = NodeCount;
+        ui_layout_node   *Nodes           = static_cast<ui_layout_node*>(Memory);
+        ui_paint_command *PaintBuffer     = reinterpret_cast<ui_paint_command *>(Nodes + NodeCount);
+        ui_paint_command *LastPaintBuffer = PaintBuffer + NodeCount;
+
+        Result = reinterpret_cast<ui_layout_tree *>(LastPaintBuffer + NodeCount);
+        Result->Nodes            = Nodes;
+        Result->PaintBuffer      = PaintBuffer;
+        Result->LastPaintBuffer  = LastPaintBuffer;
+        Result->LastPaintCount   = 0;
+        Result->NodeCount        = 0;
+        Result->NodeCapacity     = NodeCount;
+        Result->FocusedNodeIndex = InvalidLayoutNodeIndex;
 
         for (uint64_t Idx = 0; Idx < Result->NodeCapacity; Idx++)
         {
@@ -618,6 +625,19 @@ HandlePointerClick(vec2_float Position, uint32_t ClickMask, uint32_t NodeIndex,
             Node->Flags |= LayoutNodeFlag::HasCapturedPointer;
 
             Tree->CapturedNodeIndex = NodeIndex;
+            Tree->FocusedNodeIndex  = InvalidLayoutNodeIndex;
+
+            if(Node->LegacyFlags & UILayoutNode_HasTextInput)
+            {
+                Tree->FocusedNodeIndex = NodeIndex;
+
+                void_context &Context = GetVoidContext();
+
+                ui_text_input *Input = static_cast<ui_text_input *>(QueryNodeResource(NodeIndex, Tree, UIResource_TextInput, Context.ResourceTable));
+                rect_float     Rect  = GetNodeOuterRect(Node);
+
+                SetTextInputPointer(Input, vec2_float(Position.X - Rect.Left, Position.Y - Rect.Top), false);
+            }
 
             return true;
         }
@@ -698,7 +718,7 @@ HandlePointerHover(vec2_float Position, uint32_t NodeIndex, ui_layout_tree *Tree
 // not need to handle multiple focus yet. Perhaps this will change, but it should be trivial to implement.
 
 static void
-HandlePointerMove(vec2_float Delta, ui_layout_tree *Tree)
+HandlePointerMove(vec2_float Position, vec2_float Delta, ui_layout_tree *Tree)
 {
     ui_layout_node *CapturedNode = GetLayoutNode(Tree->CapturedNodeIndex, Tree);
 
@@ -709,9 +729,55 @@ HandlePointerMove(vec2_float Delta, ui_layout_tree *Tree)
             CapturedNode->ResultX += Delta.X;
             CapturedNode->ResultY += Delta.Y;
         }
+
+        // Dragging inside a text input extends the selection from the clicked caret.
+
+        if(CapturedNode->LegacyFlags & UILayoutNode_HasTextInput)
+        {
+            void_context &Context = GetVoidContext();
+
+            ui_text_input *Input = static_cast<ui_text_input *>(QueryNodeResource(CapturedNode->Index, Tree, UIResource_TextInput, Context.ResourceTable));
+            rect_float     Rect  = GetNodeOuterRect(CapturedNode);
+
+            SetTextInputPointer(Input, vec2_float(Position.X - Rect.Left, Position.Y - Rect.Top), true);
+        }
     }
 }
 
+// Text events go to the text input that was clicked last, clicking any other node of the
+// tree drops the focus. A click of the same frame is resolved first when a render frame is
+// being built, such that typing after it lands at the clicked caret.
+
+static bool
+HandleTextEvent(text_event Event, ui_layout_tree *Tree)
+{
+    ui_layout_node *FocusedNode = GetLayoutNode(Tree->FocusedNodeIndex, Tree);
+
+    if(FocusedNode && (FocusedNode->LegacyFlags & UILayoutNode_HasTextInput))
+    {
+        void_context &Context = GetVoidContext();
+
+        ui_resource_key   Key   = MakeNodeResourceKey(UIResource_TextInput, FocusedNode->Index, Tree);
+        ui_resource_state State = FindResourceByKey(Key, Context.ResourceTable);
+
+        if(State.Resource && State.ResourceType == UIResource_TextInput)
+        {
+            ui_text_input *Input       = static_cast<ui_text_input *>(State.Resource);
+            memory_arena  *UploadArena = GetRenderFrameArena();
+
+            if(UploadArena)
+            {
+                ResolveTextInputPointer(Input, UploadArena);
+            }
+
+            ApplyTextInputEvent(Input, Event);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 // ----------------------------------------------------------------------------------
 // @Internal: Layout Pass Helpers
 
@@ -756,9 +822,13 @@ GetConstrainedSize(float ParentSize, float MinSize, float MaxSize, ui_sizing_axi
 // @Public: Layout Pass
 
 // BUG: Seems like shrink is not correctly implemented. The most simple case simply bleeds out.
+//
+// Text nodes with a Fit width take the width of their widest line, and a Fit height is the
+// height for that width, such that grow and shrink see the size of the text. Both come from
+// the shaped run cache, PostOrderMeasureTree fixes the height once the width is final.
 
 static void
-PreOrderMeasureTree(ui_layout_tree *Tree, memory_arena *Arena)
+PreOrderMeasureTree(ui_layout_tree *Tree, memory_arena *Arena, memory_arena *UploadArena)
 {
     VOID_ASSERT(Arena);
     VOID_ASSERT(IsValidLayoutTree(Tree));
@@ -811,6 +881,32 @@ PreOrderMeasureTree(ui_layout_tree *Tree, memory_arena *Arena)
             Child->MinorSize = GetConstrainedSize(MinorInnerParentSize, Child->MinorBounds.Min, Child->MinorBounds.Max, Child->MinorSizing);
             Child->MajorSize = GetConstrainedSize(MajorInnerParentSize, Child->MajorBounds.Min, Child->MajorBounds.Max, Child->MajorSizing);
 
+            if(Child->LegacyFlags & UILayoutNode_HasText)
+            {
+                bool IsXMajor = (Child->Direction == LayoutDirection::Horizontal);
+
+                ui_sizing_axis &WidthSizing  = IsXMajor ? Child->MajorSizing : Child->MinorSizing;
+                ui_size_bounds &WidthBounds  = IsXMajor ? Child->MajorBounds : Child->MinorBounds;
+                float          &WidthSize    = IsXMajor ? Child->MajorSize   : Child->MinorSize;
+                ui_sizing_axis &HeightSizing = IsXMajor ? Child->MinorSizing : Child->MajorSizing;
+                ui_size_bounds &HeightBounds = IsXMajor ? Child->MinorBounds : Child->MajorBounds;
+                float          &HeightSize   = IsXMajor ? Child->MinorSize   : Child->MajorSize;
+
+                ui_resource_key TextKey = MakeNodeResourceKey(UIResource_Text, Child->Index, Tree);
+
+                if(WidthSizing.Type == Sizing::Fit)
+                {
+                    ui_text_metrics Metrics = MeasureText(TextKey, UploadArena);
+                    WidthSize = min(max(Metrics.Width, WidthBounds.Min), WidthBounds.Max);
+                }
+
+                if(HeightSizing.Type == Sizing::Fit)
+                {
+                    float TextHeight = MeasureTextHeight(TextKey, WidthSize, UploadArena);
+                    HeightSize = min(max(TextHeight, HeightBounds.Min), HeightBounds.Max);
+                }
+            }
+
             if(Child->ChildCount > 0)
             {
                 LayoutBuffer[VisitedNodes++] = Child;
@@ -955,8 +1051,12 @@ PreOrderMeasureTree(ui_layout_tree *Tree, memory_arena *Arena)
     }
 }
 
+// Text nodes with a Fit height are sized from their width: the text is wrapped to the
+// node width (the width it is painted with) and the height is the line count times the
+// line height.
+
 static void
-PostOrderMeasureTree(uint32_t NodeIndex , ui_layout_tree *Tree)
+PostOrderMeasureTree(uint32_t NodeIndex , ui_layout_tree *Tree, memory_arena *Arena)
 {
     ui_layout_node *Root = GetLayoutNode(NodeIndex, Tree);
 
@@ -964,11 +1064,25 @@ PostOrderMeasureTree(uint32_t NodeIndex , ui_layout_tree *Tree)
     {
         IterateLinkedList(Root, ui_layout_node *, Child)
         {
-            PostOrderMeasureTree(Child->Index, Tree);
+            PostOrderMeasureTree(Child->Index, Tree, Arena);
         }
 
         bool IsXMajor = (Root->Direction == LayoutDirection::Horizontal);
 
+        if(Root->LegacyFlags & UILayoutNode_HasText)
+        {
+            ui_sizing_axis &HeightSizing = IsXMajor ? Root->MinorSizing : Root->MajorSizing;
+            ui_size_bounds &HeightBounds = IsXMajor ? Root->MinorBounds : Root->MajorBounds;
+            float          &HeightSize   = IsXMajor ? Root->MinorSize   : Root->MajorSize;
+            float           Width        = IsXMajor ? Root->MajorSize   : Root->MinorSize;
+
+            if(HeightSizing.Type == Sizing::Fit)
+            {
+                float TextHeight = MeasureTextHeight(MakeNodeResourceKey(UIResource_Text, Root->Index, Tree), Width, Arena);
+                HeightSize = min(max(TextHeight, HeightBounds.Min), HeightBounds.Max);
+            }
+        }
+
         Root->ResultWidth  = IsXMajor ? Root->MajorSize : Root->MinorSize;
         Root->ResultHeight = IsXMajor ? Root->MinorSize : Root->MajorSize;
     }
@@ -1064,17 +1178,29 @@ GeneratePaintBuffer(ui_layout_tree *Tree, ui_cached_style *Cached, memory_arena
                 Node->Flags &= ~LayoutNodeFlag::UseHoveredStyle;
             }
 
-            Command.Rectangle     = GetNodeOuterRect(Node);
-            Command.RectangleClip = {};
-            Command.TextKey       = {};
-            Command.ImageKey      = {};
+            Command.Rectangle       = GetNodeOuterRect(Node);
+            Command.RectangleClip   = {};
+            Command.TextKey         = {};
+            Command.ImageKey        = {};
+            Command.ResourceVersion = 0;
+            Command.AtlasVersion    = 0;
+
+            if(Node->LegacyFlags & UILayoutNode_HasText)
+            {
+                Command.TextKey = MakeNodeResourceKey(UIResource_Text, Node->Index, Tree);
+            }
+            else if(Node->LegacyFlags & UILayoutNode_HasTextInput)
+            {
+                Command.TextKey = MakeNodeResourceKey(UIResource_TextInput, Node->Index, Tree);
+            }
 
             // Set Paint Properties
-            Command.CornerRadius  = Paint.CornerRadius.Value;
-            Command.Softness      = Paint.Softness.Value;
-            Command.BorderWidth   = Paint.BorderWidth.Value;
-            Command.Color         = Paint.Color.Value;
-            Command.BorderColor   = Paint.BorderColor.Value;
+            Command.CornerRadius    = Paint.CornerRadius.Value;
+            Command.Softness        = Paint.Softness.Value;
+            Command.BorderWidth     = Paint.BorderWidth.Value;
+            Command.Color           = Paint.Color.Value;
+            Command.BorderColor     = Paint.BorderColor.Value;
+            Command.TextColor       = Paint.TextColor.Value;
 
             IterateLinkedList(Node, ui_layout_node *, Child)
             {
@@ -1086,3 +1212,29 @@ GeneratePaintBuffer(ui_layout_tree *Tree, ui_cached_style *Cached, memory_arena
     ui_paint_buffer Result = {.Commands = Tree->PaintBuffer, .Size = CommandCount};
     return Result;
 }
+
+// The previous frame's commands are kept around to compute damage. Buffers are swapped
+// once a frame has been painted, rather than copied.
+
+static ui_paint_buffer
+GetLastPaintBuffer(ui_layout_tree *Tree)
+{
+    ui_paint_buffer Result = {.Commands = Tree->LastPaintBuffer, .Size = Tree->LastPaintCount};
+    return Result;
+}
+
+static void
+SwapPaintBuffers(ui_paint_buffer Buffer, ui_layout_tree *Tree)
+{
+    VOID_ASSERT(Buffer.Commands == Tree->PaintBuffer); // Internal Corruption
+
+    Tree->PaintBuffer     = Tree->LastPaintBuffer;
+    Tree->LastPaintBuffer = Buffer.Commands;
+    Tree->LastPaintCount  = Buffer.Size;
+}
+
+static void
+ResetLastPaintBuffer(ui_layout_tree *Tree)
+{
+    Tree->LastPaintCount = 0;
+}
@@ -8,6 +8,18 @@ IsVisibleColor(ui_color Color)
     return Result;
 }
 
+static uint32_t
+PackColorRGBA8(ui_color Color)
+{
+    uint32_t R = (uint32_t)(Min(Max(Color.R, 0.f), 1.f) * 255.f + .5f);
+    uint32_t G = (uint32_t)(Min(Max(Color.G, 0.f), 1.f) * 255.f + .5f);
+    uint32_t B = (uint32_t)(Min(Max(Color.B, 0.f), 1.f) * 255.f + .5f);
+    uint32_t A = (uint32_t)(Min(Max(Color.A, 0.f), 1.f) * 255.f + .5f);
+
+    uint32_t Result = R | (G << 8) | (B << 16) | (A << 24);
+    return Result;
+}
+
 static ui_color
 NormalizeColor(ui_color Color)
 {
@@ -31,41 +43,19 @@ NormalizeColor(ui_color Color)
 // Slight fritiction with the resource API. The members of resource state are too verbose 
 // and can already be inferred from the context.
 
+// Text is painted in glyph groups, rect groups only sample images.
+
 static render_batch_list *
-GetPaintBatchList(ui_resource_key TextKey, ui_resource_key ImageKey, memory_arena *Arena, rect_float RectangleClip)
+GetPaintBatchList(ui_resource_key ImageKey, memory_arena *Arena)
 {
     VOID_ASSERT(Arena); // Internal Corruption
 
-    void_context &Context = GetVoidContext();
-
     render_pass           *Pass     = GetRenderPass(Arena, RenderPass_UI);
     render_pass_params_ui *UIParams = &Pass->Params.UI.Params;
     rect_group_node       *Node     = UIParams->Last;
 
     rect_group_params Params = {};
     {
-        Params.Transform = Mat3x3Identity();
-        Params.Clip      = RectangleClip;
-
-        if(IsValidResourceKey(TextKey))
-        {
-            ui_resource_state TextResource = FindResourceByKey(TextKey, Context.ResourceTable);
-            if(TextResource.ResourceType == UIResource_Text && TextResource.Resource)
-            {
-                auto *Text = static_cast<ui_text *>(TextResource.Resource);
-
-                ui_resource_state FontState = FindResourceByKey(Text->FontKey, Context.ResourceTable);
-                if(FontState.Resource)
-                {
-                    ui_font *Font = static_cast<ui_font *>(FontState.Resource);
-
-                    Params.Texture     = Font->TextureView;
-                    Params.TextureSize = Font->TextureSize;
-
-                }
-            }
-        }
-
         if(IsValidResourceKey(ImageKey))
         {
             // TODO: Reimplement.
@@ -85,6 +75,8 @@ GetPaintBatchList(ui_resource_key TextKey, ui_resource_key ImageKey, memory_aren
         Node->BatchList.BytesPerInstance = sizeof(ui_rect);
 
         AppendToLinkedList(UIParams, Node, UIParams->Count);
+
+        Pass->Params.UI.Stats.GroupCount += 1;
     }
 
     VOID_ASSERT(Node);
@@ -95,10 +87,57 @@ GetPaintBatchList(ui_resource_key TextKey, ui_resource_key ImageKey, memory_aren
     return Result;
 }
 
+// Consecutive labels using the same atlas page share a glyph group until it references
+// GlyphRunCapacity runs.
+
+static rect_group_node *
+GetPaintGlyphGroup(ui_font *Font, uint32_t Page, memory_arena *Arena)
+{
+    VOID_ASSERT(Arena); // Internal Corruption
+
+    render_pass           *Pass     = GetRenderPass(Arena, RenderPass_UI);
+    render_pass_params_ui *UIParams = &Pass->Params.UI.Params;
+    rect_group_node       *Node     = UIParams->Last;
+
+    rect_group_params Params =
+    {
+        .TextureSize = Font->TextureSize,
+        .Texture     = Font->Face->TextureViews[Page],
+        .Type        = RectGroup_Glyphs,
+    };
+
+    bool CanMergeNodes = (Node && CanMergeRectGroupParams(&Node->Params, &Params) && GetGlyphRunCount(Node) < GlyphRunCapacity);
+    if(!CanMergeNodes)
+    {
+        Node = PushStruct(Arena, rect_group_node);
+        Node->BatchList.BytesPerInstance = sizeof(render_glyph);
+        Node->RunList.BytesPerInstance   = sizeof(render_glyph_run);
+        Node->Params                     = Params;
+
+        AppendToLinkedList(UIParams, Node, UIParams->Count);
+
+        Pass->Params.UI.Stats.GroupCount += 1;
+    }
+
+    return Node;
+}
+
+static uint32_t
+GetPaintClipIndex(rect_float RectangleClip, memory_arena *Arena)
+{
+    VOID_ASSERT(Arena); // Internal Corruption
+
+    render_pass           *Pass     = GetRenderPass(Arena, RenderPass_UI);
+    render_pass_params_ui *UIParams = &Pass->Params.UI.Params;
+
+    uint32_t Result = PushRectClip(Arena, &UIParams->ClipTable, Mat3x3Identity(), RectangleClip);
+    return Result;
+}
+
 // We do not do any gradient stuff right now, but a basic version is implemented.
 
 static void
-PaintUIRect(rect_float Rect, ui_color Color, ui_corner_radius CornerRadii, float BorderWidth, float Softness, render_batch_list *BatchList, memory_arena *Arena)
+PaintUIRect(rect_float Rect, ui_color Color, ui_corner_radius CornerRadii, float BorderWidth, float Softness, uint32_t ClipIndex, render_batch_list *BatchList, memory_arena *Arena)
 {
     ui_rect *UIRect = (ui_rect *)PushDataInBatchList(Arena, BatchList);
     UIRect->RectBounds    = Rect;
@@ -111,10 +150,11 @@ PaintUIRect(rect_float Rect, ui_color Color, ui_corner_radius CornerRadii, float
     UIRect->Softness      = Softness;
     UIRect->TextureSource = {};
     UIRect->SampleTexture = 0;
+    UIRect->ClipIndex     = ClipIndex;
 }
 
 static void
-PaintUIImage(rect_float Rect, rect_float Source, render_batch_list *BatchList, memory_arena *Arena)
+PaintUIImage(rect_float Rect, rect_float Source, uint32_t ClipIndex, render_batch_list *BatchList, memory_arena *Arena)
 {
     ui_rect *UIRect = (ui_rect *)PushDataInBatchList(Arena, BatchList);
     UIRect->RectBounds    = Rect;
@@ -127,22 +167,362 @@ PaintUIImage(rect_float Rect, rect_float Source, render_batch_list *BatchList, m
     UIRect->Softness      = 0;
     UIRect->TextureSource = Source;
     UIRect->SampleTexture = 1;
+    UIRect->ClipIndex     = ClipIndex;
 }
 
+// Glyphs come from the shaped run cache, glyphs rasterized by a miss are uploaded along
+// with this frame. The atlas version is kept on the command such that a repack damages
+// every label painted with the old atlas, as does a pending glyph landing in it.
+
+// Glyphs batch with the texture of their atlas page, a run spread over several pages is drawn
+// as one glyph run per page. Sources stack the pages on Y.
+
 static void
-PaintUIGlyph(rect_float Rect, ui_color Color, rect_float Source, render_batch_list *BatchList, memory_arena *Arena)
+PaintGlyphLines(ui_shaped_run *Run, ui_text_line *Lines, uint32_t LineCount, vec2_float Origin, ui_font *Font, ui_color Color, uint32_t ClipIndex, memory_arena *Arena)
 {
-    ui_rect *UIRect = (ui_rect *)PushDataInBatchList(Arena, BatchList);
-    UIRect->RectBounds    = Rect;
-    UIRect->ColorTL       = Color;
-    UIRect->ColorBL       = Color;
-    UIRect->ColorTR       = Color;
-    UIRect->ColorBR       = Color;
-    UIRect->CornerRadii   = {.TL = 0, .TR = 0, .BR = 0, .BL = 0};
-    UIRect->BorderWidth   = 0;
-    UIRect->Softness      = 0;
-    UIRect->TextureSource = Source;
-    UIRect->SampleTexture = 1;
+    for(uint32_t Page = 0; Page < Font->Face->PageCount; ++Page)
+    {
+        float            PageTop    = (float)(Page * Font->TextureSize.Y);
+        float            PageBottom = PageTop + Font->TextureSize.Y;
+        rect_group_node *Group      = 0;
+        uint32_t         RunIndex   = 0;
+
+        for(uint32_t LineIdx = 0; LineIdx < LineCount; ++LineIdx)
+        {
+            ui_text_line &Line    = Lines[LineIdx];
+            float         OffsetX = -GetRunPenX(Run, Line.Start);
+            float         OffsetY = LineIdx * Run->LineHeight;
+
+            for(uint32_t Idx = Line.Start; Idx < Line.End; ++Idx)
+            {
+                ui_shaped_glyph &Glyph = Run->Glyphs[Idx];
+
+                bool HasPixels = Glyph.Source.Right > Glyph.Source.Left && Glyph.Source.Bottom > Glyph.Source.Top;
+                if(!HasPixels || Glyph.Source.Top < PageTop || Glyph.Source.Top >= PageBottom)
+                {
+                    continue;
+                }
+
+                if(!Group)
+                {
+                    Group    = GetPaintGlyphGroup(Font, Page, Arena);
+                    RunIndex = GetGlyphRunCount(Group);
+
+                    render_glyph_run *GlyphRun = (render_glyph_run *)PushDataInBatchList(Arena, &Group->RunList);
+                    GlyphRun->Origin    = Origin;
+                    GlyphRun->Color     = PackColorRGBA8(Color);
+                    GlyphRun->ClipIndex = ClipIndex;
+                    GlyphRun->Scale     = Font->Scale;
+                    GlyphRun->Sharpness = Font->Sharpness;
+                }
+
+                render_glyph *Instance = (render_glyph *)PushDataInBatchList(Arena, &Group->BatchList);
+                Instance->OffsetX      = (int16_t)roundf(Glyph.Position.Left + OffsetX);
+                Instance->OffsetY      = (int16_t)roundf(Glyph.Position.Top  + OffsetY);
+                Instance->SourceX      = (uint16_t)Glyph.Source.Left;
+                Instance->SourceY      = (uint16_t)(Glyph.Source.Top - PageTop);
+                Instance->SourceWidth  = (uint16_t)(Glyph.Source.Right  - Glyph.Source.Left);
+                Instance->SourceHeight = (uint16_t)(Glyph.Source.Bottom - Glyph.Source.Top);
+                Instance->RunIndex     = RunIndex;
+            }
+        }
+    }
+}
+
+static void
+PaintUIText(ui_paint_command &Command, uint32_t ClipIndex, memory_arena *Arena)
+{
+    void_context &Context = GetVoidContext();
+
+    ui_resource_state TextState = FindResourceByKey(Command.TextKey, Context.ResourceTable);
+    if(TextState.ResourceType != UIResource_Text || !TextState.Resource)
+    {
+        return;
+    }
+
+    ui_text       *Text = static_cast<ui_text *>(TextState.Resource);
+    ui_shaped_run *Run  = FindShapedRun(Text->String, Text->FontKey, Arena, Context.ShapedRunCache);
+
+    if(Run && Run->GlyphCount && IsVisibleColor(Command.TextColor))
+    {
+        ui_font    *Font      = static_cast<ui_font *>(FindResourceByKey(Text->FontKey, Context.ResourceTable).Resource);
+        uint32_t    LineCount = WrapShapedRun(Command.Rectangle.Right - Command.Rectangle.Left, Run);
+        vec2_float  Origin    = vec2_float(Command.Rectangle.Left, Command.Rectangle.Top);
+
+        PaintGlyphLines(Run, Run->Lines, LineCount, Origin, Font, Command.TextColor, ClipIndex, Arena);
+
+        Command.AtlasVersion = Run->AtlasVersion + Font->Face->ReadyVersion;
+    }
+}
+
+// Inputs are not wrapped, one hard line per line height. Only the lines inside the rectangle
+// are shaped and drawn: selection first, then the glyphs, then the caret. The input version
+// is folded in the atlas version such that edits and caret moves damage the command.
+
+static void
+PaintUITextInput(ui_paint_command &Command, uint32_t ClipIndex, memory_arena *Arena)
+{
+    void_context &Context = GetVoidContext();
+
+    ui_resource_state InputState = FindResourceByKey(Command.TextKey, Context.ResourceTable);
+    if(InputState.ResourceType != UIResource_TextInput || !InputState.Resource)
+    {
+        return;
+    }
+
+    ui_text_input     *Input     = static_cast<ui_text_input *>(InputState.Resource);
+    ui_resource_state  FontState = FindResourceByKey(Input->FontKey, Context.ResourceTable);
+    if(FontState.ResourceType != UIResource_Font || !FontState.Resource)
+    {
+        return;
+    }
+
+    ui_font *Font       = static_cast<ui_font *>(FontState.Resource);
+    float    LineHeight = Font->Size;
+    float    Height     = Command.Rectangle.Bottom - Command.Rectangle.Top;
+
+    if(LineHeight <= 0.f || Height <= 0.f || !IsVisibleColor(Command.TextColor))
+    {
+        return;
+    }
+
+    ResolveTextInputPointer(Input, Arena);
+
+    uint32_t   VisibleCount = Min(Input->LineCount, (uint32_t)ceilf(Height / LineHeight));
+    vec2_float Origin       = vec2_float(Command.Rectangle.Left, Command.Rectangle.Top);
+    uint32_t   AtlasVersion = 0;
+
+    // Selections start at or after the first line, at most VisibleCount rects reach the
+    // rectangle.
+
+    if(Input->Caret != Input->Anchor)
+    {
+        rect_float *Rects     = PushArray(Arena, rect_float, VisibleCount);
+        uint32_t    RectCount = GetTextInputSelectionRects(Input, Input->Caret, Input->Anchor, Rects, VisibleCount, Arena);
+
+        ui_color SelectionColor = Command.TextColor;
+        SelectionColor.A *= 0.3f;
+
+        render_batch_list *BatchList = GetPaintBatchList(Command.ImageKey, Arena);
+        for(uint32_t Idx = 0; Idx < RectCount && Rects[Idx].Top < Height; ++Idx)
+        {
+            rect_float Rect = rect_float(Origin.X + Rects[Idx].Left, Origin.Y + Rects[Idx].Top, Origin.X + Rects[Idx].Right, Origin.Y + Rects[Idx].Bottom);
+            PaintUIRect(Rect, SelectionColor, {}, 0, 0, ClipIndex, BatchList, Arena);
+        }
+    }
+
+    for(uint32_t LineIdx = 0; LineIdx < VisibleCount; ++LineIdx)
+    {
+        byte_string    Text = ReadTextInputLine(Input, LineIdx, Arena);
+        ui_shaped_run *Run  = FindShapedRun(Text, Input->FontKey, Arena, Context.ShapedRunCache);
+
+        if(Run && Run->GlyphCount)
+        {
+            ui_text_line Line       = {.Start = 0, .End = Run->GlyphCount, .Width = GetRunPenX(Run, Run->GlyphCount)};
+            vec2_float   LineOrigin = vec2_float(Origin.X, Origin.Y + LineIdx * LineHeight);
+
+            PaintGlyphLines(Run, &Line, 1, LineOrigin, Font, Command.TextColor, ClipIndex, Arena);
+
+            AtlasVersion += Run->AtlasVersion;
+        }
+    }
+
+    rect_float Caret = GetTextInputCaretRect(Input, Input->Caret, Arena);
+    if(Caret.Top < Height)
+    {
+        rect_float Rect = rect_float(Origin.X + Caret.Left, Origin.Y + Caret.Top, Origin.X + Caret.Right, Origin.Y + Caret.Bottom);
+        PaintUIRect(Rect, Command.TextColor, {}, 0, 0, ClipIndex, GetPaintBatchList(Command.ImageKey, Arena), Arena);
+    }
+
+    Command.AtlasVersion = AtlasVersion + Font->Face->ReadyVersion + Input->Version;
+}
+
+// -----------------------------------------------------------------------------------
+// Occlusion internal Implementation
+
+// Commands are walked front-to-back (reverse paint order). Every opaque command pushes the
+// largest axis-aligned rect it is guaranteed to fully cover, and any command whose visible
+// area fits inside one of those rects is dropped before batching. A rounded rect is opaque
+// on the band between its corners, we keep whichever band (horizontal or vertical) is larger.
+
+static bool
+IsPaintClipSet(rect_float Clip)
+{
+    bool Result = (Clip.Left != 0.f || Clip.Top != 0.f || Clip.Right != 0.f || Clip.Bottom != 0.f);
+    return Result;
+}
+
+static rect_float
+GetPaintVisibleRect(ui_paint_command &Command)
+{
+    rect_float Result = Command.Rectangle;
+    if(IsPaintClipSet(Command.RectangleClip))
+    {
+        Result = Result.Intersect(Command.RectangleClip);
+    }
+
+    return Result;
+}
+
+static bool
+IsOpaquePaintCommand(ui_paint_command &Command)
+{
+    bool Result = (Command.Color.A >= 1.f && Command.Softness <= 0.f && !IsValidResourceKey(Command.ImageKey));
+    return Result;
+}
+
+static rect_float
+GetPaintOccluderRect(ui_paint_command &Command)
+{
+    rect_float       Rect   = Command.Rectangle;
+    ui_corner_radius Radius = Command.CornerRadius;
+
+    rect_float Horizontal = {Rect.Left + Max(Radius.TL, Radius.BL), Rect.Top, Rect.Right - Max(Radius.TR, Radius.BR), Rect.Bottom};
+    rect_float Vertical   = {Rect.Left, Rect.Top + Max(Radius.TL, Radius.TR), Rect.Right, Rect.Bottom - Max(Radius.BL, Radius.BR)};
+
+    float HorizontalArea = Max(Horizontal.Right - Horizontal.Left, 0.f) * Max(Horizontal.Bottom - Horizontal.Top, 0.f);
+    float VerticalArea   = Max(Vertical.Right   - Vertical.Left  , 0.f) * Max(Vertical.Bottom   - Vertical.Top  , 0.f);
+
+    rect_float Result = (HorizontalArea >= VerticalArea) ? Horizontal : Vertical;
+    if(IsPaintClipSet(Command.RectangleClip))
+    {
+        Result = Result.Intersect(Command.RectangleClip);
+    }
+
+    return Result;
+}
+
+static bool
+IsRectContained(rect_float Inner, rect_float Outer)
+{
+    bool Result = (Inner.Left >= Outer.Left && Inner.Top >= Outer.Top && Inner.Right <= Outer.Right && Inner.Bottom <= Outer.Bottom);
+    return Result;
+}
+
+// Returns one flag per command, set if the command is fully covered. The occluder set is
+// bounded such that the pass stays linear on large trees, late occluders are simply ignored.
+
+static bool *
+CullOccludedPaintCommands(ui_paint_buffer Buffer, memory_arena *Arena)
+{
+    VOID_ASSERT(Buffer.Commands); // Internal Corruption
+    VOID_ASSERT(Arena);           // Internal Corruption
+
+    bool       *Result        = PushArray(Arena, bool, Buffer.Size);
+    rect_float *Occluders     = PushArray(Arena, rect_float, PaintOccluderCapacity);
+    uint32_t    OccluderCount = 0;
+
+    for(uint32_t Idx = Buffer.Size; Idx-- > 0;)
+    {
+        ui_paint_command &Command = Buffer.Commands[Idx];
+
+        rect_float Visible = GetPaintVisibleRect(Command);
+        if(Visible.Right <= Visible.Left || Visible.Bottom <= Visible.Top)
+        {
+            continue;
+        }
+
+        for(uint32_t OccluderIdx = 0; OccluderIdx < OccluderCount; ++OccluderIdx)
+        {
+            if(IsRectContained(Visible, Occluders[OccluderIdx]))
+            {
+                Result[Idx] = true;
+                break;
+            }
+        }
+
+        if(!Result[Idx] && OccluderCount < PaintOccluderCapacity && IsOpaquePaintCommand(Command))
+        {
+            rect_float Occluder = GetPaintOccluderRect(Command);
+            if(Occluder.Right > Occluder.Left && Occluder.Bottom > Occluder.Top)
+            {
+                Occluders[OccluderCount++] = Occluder;
+            }
+        }
+    }
+
+    return Result;
+}
+
+// -----------------------------------------------------------------------------------
+// Damage internal Implementation
+
+// Damage is the difference between this frame's commands and the previous frame's. Layout
+// moves, hover/focus styles and resource updates all end up changing a command, in which
+// case both its old and new visible rects are damaged.
+
+static uint32_t
+GetPaintResourceVersion(ui_paint_command &Command)
+{
+    void_context &Context = GetVoidContext();
+
+    uint32_t Result = 0;
+
+    if(IsValidResourceKey(Command.TextKey))
+    {
+        Result += FindResourceByKey(Command.TextKey, Context.ResourceTable).Version;
+    }
+
+    if(IsValidResourceKey(Command.ImageKey))
+    {
+        Result += FindResourceByKey(Command.ImageKey, Context.ResourceTable).Version;
+    }
+
+    return Result;
+}
+
+static bool
+PaintCommandsAreEqual(ui_paint_command &A, ui_paint_command &B)
+{
+    bool Result = MemoryCompare(&A.Rectangle    , &B.Rectangle    , sizeof(rect_float)      ) == 0 &&
+                  MemoryCompare(&A.RectangleClip, &B.RectangleClip, sizeof(rect_float)      ) == 0 &&
+                  MemoryCompare(&A.Color        , &B.Color        , sizeof(ui_color)        ) == 0 &&
+                  MemoryCompare(&A.BorderColor  , &B.BorderColor  , sizeof(ui_color)        ) == 0 &&
+                  MemoryCompare(&A.TextColor    , &B.TextColor    , sizeof(ui_color)        ) == 0 &&
+                  MemoryCompare(&A.CornerRadius , &B.CornerRadius , sizeof(ui_corner_radius)) == 0 &&
+                  A.Softness        == B.Softness        &&
+                  A.BorderWidth     == B.BorderWidth     &&
+                  A.ResourceVersion == B.ResourceVersion &&
+                  A.AtlasVersion    == B.AtlasVersion    &&
+                  ResourceKeyAreEqual(A.TextKey , B.TextKey ) &&
+                  ResourceKeyAreEqual(A.ImageKey, B.ImageKey);
+
+    return Result;
+}
+
+static void
+ComputePaintDamage(ui_paint_buffer Buffer, ui_paint_buffer LastBuffer)
+{
+    render_pass_list *List = &RenderState.PassList;
+
+    for(uint32_t Idx = 0; Idx < Buffer.Size; ++Idx)
+    {
+        Buffer.Commands[Idx].ResourceVersion = GetPaintResourceVersion(Buffer.Commands[Idx]);
+    }
+
+    uint32_t CommonCount = Min(Buffer.Size, LastBuffer.Size);
+
+    for(uint32_t Idx = 0; Idx < CommonCount; ++Idx)
+    {
+        ui_paint_command &Command     = Buffer.Commands[Idx];
+        ui_paint_command &LastCommand = LastBuffer.Commands[Idx];
+
+        if(!PaintCommandsAreEqual(Command, LastCommand))
+        {
+            PushRenderDamage(List, GetPaintVisibleRect(LastCommand));
+            PushRenderDamage(List, GetPaintVisibleRect(Command));
+        }
+    }
+
+    for(uint32_t Idx = CommonCount; Idx < Buffer.Size; ++Idx)
+    {
+        PushRenderDamage(List, GetPaintVisibleRect(Buffer.Commands[Idx]));
+    }
+
+    for(uint32_t Idx = CommonCount; Idx < LastBuffer.Size; ++Idx)
+    {
+        PushRenderDamage(List, GetPaintVisibleRect(LastBuffer.Commands[Idx]));
+    }
 }
 
 // -----------------------------------------------------------------------------------
@@ -154,21 +534,31 @@ ExecutePaintCommands(ui_paint_buffer Buffer, memory_arena *Arena)
     VOID_ASSERT(Buffer.Commands);  // Internal Corruption
     VOID_ASSERT(Arena);            // Internal Corruption
 
+    bool        *Occluded = CullOccludedPaintCommands(Buffer, Arena);
+    render_pass *Pass     = GetRenderPass(Arena, RenderPass_UI);
+
     for(uint32_t Idx = 0; Idx < Buffer.Size; ++Idx)
     {
         ui_paint_command &Command = Buffer.Commands[Idx];
 
+        if(Occluded[Idx])
+        {
+            Pass->Params.UI.Stats.CulledInstanceCount += (Command.Color.A > 0.f) + (Command.BorderColor.A > 0.f && Command.BorderWidth > 0.f);
+            continue;
+        }
+
         rect_float       Rect     = Command.Rectangle;
         ui_color         Color    = Command.Color;
         ui_corner_radius Radius   = Command.CornerRadius;
         float            Softness = Command.Softness;
 
         // TODO: Can this return NULL?
-        render_batch_list *BatchList = GetPaintBatchList(Command.TextKey, Command.ImageKey, Arena, Command.RectangleClip);
+        render_batch_list *BatchList = GetPaintBatchList(Command.ImageKey, Arena);
+        uint32_t           ClipIndex = GetPaintClipIndex(Command.RectangleClip, Arena);
 
         if(Color.A > 0.f)
         {
-            PaintUIRect(Rect, Color, Radius, 0, Softness, BatchList, Arena);
+            PaintUIRect(Rect, Color, Radius, 0, Softness, ClipIndex, BatchList, Arena);
         }
 
         ui_color BorderColor = Command.BorderColor;
@@ -176,12 +566,23 @@ ExecutePaintCommands(ui_paint_buffer Buffer, memory_arena *Arena)
 
         if(BorderColor.A > 0.f && BorderWidth > 0.f)
         {
-            PaintUIRect(Rect, BorderColor, Radius, BorderWidth, Softness, BatchList, Arena);
+            PaintUIRect(Rect, BorderColor, Radius, BorderWidth, Softness, ClipIndex, BatchList, Arena);
         }
 
 
-        // TODO: RE-IMPLEMENT TEXT & TEXT-INPUT & IMAGE DRAWING (TRIVIAL, JUST READ RESOURCE KEY?)
-        // TODO: RE-IMPLEMENT CLIPPING AND WHATNOT
+        if(IsValidResourceKey(Command.TextKey))
+        {
+            if(GetResourceTypeFromKey(Command.TextKey) == UIResource_TextInput)
+            {
+                PaintUITextInput(Command, ClipIndex, Arena);
+            }
+            else
+            {
+                PaintUIText(Command, ClipIndex, Arena);
+            }
+        }
+
+        // TODO: RE-IMPLEMENT IMAGE DRAWING (TRIVIAL, JUST READ RESOURCE KEY?)
         // TODO: RE-IMPLEMENT DEBUG DRAWING
     }
 }
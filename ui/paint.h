@@ -61,9 +61,12 @@ struct ui_paint_command
 
     ui_color         Color;
     ui_color         BorderColor;
+    ui_color         TextColor;
     ui_corner_radius CornerRadius;
     float            Softness;
     float            BorderWidth;
+    uint32_t         ResourceVersion;   // Sum of the referenced resource versions, for damage
+    uint32_t         AtlasVersion;      // Font atlas the text was painted with, for damage
 };
 
 struct ui_paint_buffer
@@ -199,6 +202,28 @@ struct ui_cached_style
 // @Internal: Small Helpers
 
 static bool     IsVisibleColor  (ui_color Color);
+static uint32_t PackColorRGBA8  (ui_color Color);
 static ui_color NormalizeColor  (ui_color Color);
 
 static void ExecutePaintCommands(ui_paint_buffer Buffer, memory_arena *Arena);
+static void PaintUIText         (ui_paint_command &Command, uint32_t ClipIndex, memory_arena *Arena);
+static void PaintUITextInput    (ui_paint_command &Command, uint32_t ClipIndex, memory_arena *Arena);
+
+// ===================================================================================
+// @Internal: Occlusion
+
+const static uint32_t PaintOccluderCapacity = 64;
+
+static bool       IsPaintClipSet             (rect_float Clip);
+static rect_float GetPaintVisibleRect        (ui_paint_command &Command);
+static bool       IsOpaquePaintCommand       (ui_paint_command &Command);
+static rect_float GetPaintOccluderRect       (ui_paint_command &Command);
+static bool       IsRectContained            (rect_float Inner, rect_float Outer);
+static bool     * CullOccludedPaintCommands  (ui_paint_buffer Buffer, memory_arena *Arena);
+
+// ===================================================================================
+// @Internal: Damage
+
+static uint32_t   GetPaintResourceVersion    (ui_paint_command &Command);
+static bool       PaintCommandsAreEqual      (ui_paint_command &A, ui_paint_command &B);
+static void       ComputePaintDamage         (ui_paint_buffer Buffer, ui_paint_buffer LastBuffer);
@@ -1,6 +1,148 @@
 // =================================================================
 // @Internal: Fonts Implementation
 
+// The path of the cache file of a face, false when no cache directory is set.
+
+static bool
+GetGlyphCachePath(ui_font *Face, char *Buffer, uint32_t BufferSize)
+{
+    byte_string Directory = GetVoidContext().GlyphCacheDirectory;
+
+    if(!Directory.Size)
+    {
+        return false;
+    }
+
+    const char *Suffix = Face->Generator.TextStorage == ntext::TextStorage::SDF ? "-sdf" : "";
+    int         Length = snprintf(Buffer, BufferSize, "%.*s/%.*s-%u%s.glyphs", (int)Directory.Size, (char *)Directory.String,
+                                  (int)Face->Name.Size, (char *)Face->Name.String, (uint32_t)Face->Size, Suffix);
+
+    bool Result = Length > 0 && (uint32_t)Length < BufferSize;
+    return Result;
+}
+
+// The file stays mapped until its pixels are uploaded, a file which does not match the face
+// is left alone and overwritten on save.
+
+static void
+ReadGlyphCacheFile(ui_font *Face)
+{
+    char Path[OS_MAX_PATH];
+    if(!GetGlyphCachePath(Face, Path, sizeof(Path)))
+    {
+        return;
+    }
+
+    os_mapped_file File   = OSMapFile(ByteString((uint8_t *)Path, strlen(Path)));
+    const uint8_t *Pixels = ntext::ReadGlyphCache(Face->Generator, File.Content.String, File.Content.Size);
+
+    if(Pixels)
+    {
+        Face->CacheFile   = File;
+        Face->CachePixels = Pixels;
+    }
+    else
+    {
+        OSUnmapFile(&File);
+    }
+}
+
+// Sources stack the atlas pages on Y, page P starts at P * TextureSize.Y. The update is
+// moved to its page, whose texture is created the first time.
+
+static void
+PushAtlasUpdate(ui_font *Face, uint32_t X, uint32_t Y, uint16_t Width, uint16_t Height, void *Pixels, uint32_t Pitch, memory_arena *Arena)
+{
+    uint32_t Page = Y / Face->TextureSize.Y;
+
+    VOID_ASSERT(Page < ntext::MaxAtlasPageCount);
+
+    while(Face->PageCount <= Page)
+    {
+        Face->Textures    [Face->PageCount] = CreateRenderTexture(Face->TextureSize.X, Face->TextureSize.Y, RenderTexture::GreyScale);
+        Face->TextureViews[Face->PageCount] = CreateRenderTextureView(Face->Textures[Face->PageCount], RenderTexture::GreyScale);
+        Face->PageCount                    += 1;
+
+        ProfileCounter("Glyph Atlas Pages", Face->PageCount);
+    }
+
+    PushRenderTextureUpdate(Arena, Face->Textures[Page], (uint16_t)X, (uint16_t)(Y - Page * Face->TextureSize.Y), Width, Height, Pixels, Pitch);
+}
+
+static void
+UploadGlyphCacheAtlas(ui_font *Face, memory_arena *Arena)
+{
+    uint64_t PageSize = (uint64_t)Face->TextureSize.X * Face->TextureSize.Y;
+
+    for(uint32_t Page = 0; Page < Face->Generator.ActivePageCount; ++Page)
+    {
+        void *Pixels = (void *)(Face->CachePixels + Page * PageSize);
+        PushAtlasUpdate(Face, 0, Page * Face->TextureSize.Y, Face->TextureSize.X, Face->TextureSize.Y, Pixels, Face->TextureSize.X, Arena);
+    }
+
+    OSUnmapFile(&Face->CacheFile);
+    Face->CachePixels = 0;
+}
+
+// Creates the generator and the atlas of a face. Glyphs are rasterized at EmSize, or come
+// from the cache file of the face.
+
+static void
+InitializeFontFace(ui_font *Font, byte_string Name, ntext::TextStorage Storage, float EmSize, uint16_t CacheSizeX, uint16_t CacheSizeY)
+{
+    void_context &Context = GetVoidContext();
+
+    // The backend finds the font by name, which must be zero terminated.
+
+    char FamilyName[256] = {};
+    MemoryCopy(FamilyName, Name.String, Min(Name.Size, sizeof(FamilyName) - 1));
+
+    ntext::glyph_generator_params GeneratorParams =
+    {
+        .TextStorage       = Storage,
+        .TextureFormat     = ntext::TextureFormat::GreyScale,
+        .EmSize            = EmSize,
+        .FrameMemoryBudget = VOID_MEGABYTE(1),
+        .FrameMemory       = malloc(VOID_MEGABYTE(1)),         // Do we really malloc?
+        .CacheSizeX        = CacheSizeX,
+        .CacheSizeY        = CacheSizeY,
+        .CachePageCount    = UIFontAtlasPageCount,
+        .FamilyName        = FamilyName,
+    };
+
+    MemoryZero(Font, sizeof(ui_font));
+
+    Font->Generator    = ntext::CreateGlyphGenerator(GeneratorParams);
+    Font->TextureSize  = vec2_uint16(CacheSizeX, CacheSizeY);
+    Font->Face         = Font;
+    Font->ReadyVersion = 0;
+    Font->Size         = (uint16_t)EmSize;
+    Font->Name         = Name;
+    Font->Next         = 0;
+    Font->PageCount    = 0;
+    Font->CacheFile    = {};
+    Font->CachePixels  = 0;
+    Font->CacheDirty   = false;
+
+    if(ntext::IsValidGlyphGenerator(Font->Generator))
+    {
+        ReadGlyphCacheFile(Font);
+    }
+
+    if(!Context.Fonts.First)
+    {
+        Context.Fonts.First = Font;
+    }
+
+    if(Context.Fonts.Last)
+    {
+        Context.Fonts.Last->Next = Font;
+    }
+
+    Context.Fonts.Last   = Font;
+    Context.Fonts.Count += 1;
+}
+
 static ui_resource_key
 UILoadSystemFont(byte_string Name, float Size, uint16_t CacheSizeX, uint16_t CacheSizeY)
 {
@@ -16,19 +158,59 @@ UILoadSystemFont(byte_string Name, float Size, uint16_t CacheSizeX, uint16_t Cac
 
         if(Font)
         {
-            ntext::glyph_generator_params GeneratorParams =
+            InitializeFontFace(Font, Name, ntext::TextStorage::LazyAtlas, Size, CacheSizeX, CacheSizeY);
+
+            Font->Scale     = 1.f;
+            Font->Sharpness = 0.f;
+
+            UpdateResourceTable(State.Id, Key, Font, Context.ResourceTable);
+        }
+    }
+
+    return Key;
+}
+
+// The face is stored under the global key of the name, the cache size of the first load wins.
+
+static ui_resource_key
+UILoadDistanceFont(byte_string Name, float Size, uint16_t CacheSizeX, uint16_t CacheSizeY)
+{
+    void_context &Context = GetVoidContext();
+
+    ui_resource_key   Key   = MakeFontResourceKey(Name, Size);
+    ui_resource_state State = FindResourceByKey(Key, Context.ResourceTable);
+
+    if(!State.Resource)
+    {
+        ui_resource_key   FaceKey   = MakeGlobalResourceKey(UIResource_Font, Name);
+        ui_resource_state FaceState = FindResourceByKey(FaceKey, Context.ResourceTable);
+        ui_font          *Face      = static_cast<ui_font *>(FaceState.Resource);
+
+        if(!Face)
+        {
+            Face = static_cast<ui_font *>(malloc(sizeof(ui_font)));
+
+            if(Face)
             {
-                .TextStorage       = ntext::TextStorage::LazyAtlas,
-                .FrameMemoryBudget = VOID_MEGABYTE(1),
-                .FrameMemory       = malloc(VOID_MEGABYTE(1)),         // Do we really malloc?
-                .CacheSizeX        = CacheSizeX,
-                .CacheSizeY        = CacheSizeY,
-            };
-
-            Font->Generator   = ntext::CreateGlyphGenerator(GeneratorParams);
-            Font->Texture     = CreateRenderTexture(CacheSizeX, CacheSizeY, RenderTexture::RGBA);
-            Font->TextureView = CreateRenderTextureView(Font->Texture, RenderTexture::RGBA);
-            Font->TextureSize = vec2_uint16(CacheSizeX, CacheSizeY);
+                InitializeFontFace(Face, Name, ntext::TextStorage::SDF, UIDistanceFontEmSize, CacheSizeX, CacheSizeY);
+
+                Face->Scale     = 1.f;
+                Face->Sharpness = 2.f * ntext::SDFSpread;
+
+                UpdateResourceTable(FaceState.Id, FaceKey, Face, Context.ResourceTable);
+            }
+        }
+
+        ui_font *Font = Face ? static_cast<ui_font *>(malloc(sizeof(ui_font))) : 0;
+
+        if(Font)
+        {
+            MemoryZero(Font, sizeof(ui_font));
+
+            Font->TextureSize = Face->TextureSize;
+            Font->Face        = Face;
+            Font->Scale       = Size / UIDistanceFontEmSize;
+            Font->Sharpness   = 2.f * ntext::SDFSpread * Font->Scale;
             Font->Size        = Size;
             Font->Name        = Name;
 
@@ -39,33 +221,1806 @@ UILoadSystemFont(byte_string Name, float Size, uint16_t CacheSizeX, uint16_t Cac
     return Key;
 }
 
-// =================================================================
-// @Internal: Static Text Implementation
+static void
+UISetGlyphCacheDirectory(byte_string Path)
+{
+    void_context &Context = GetVoidContext();
+
+    Context.GlyphCacheDirectory = ByteStringCopy(Path, Context.StateArena);
+}
 
-// TODO:
-// So this should be somewhat trivial. We just have to call FillAtlas using the glyph_generator.
-// And store the relevant data inside our own structure. We also need to give the rasterized list to
-// the renderer.
+// Faces whose file is still mapped did not shape anything, their file is up to date.
 
-// TODO:
-// On NText side we probably have to provide some kind of source rect instead of simply returning layout info.
-// We also have to provide a function that pops the arena every frame.
+static void
+UISaveGlyphCaches(void)
+{
+    void_context &Context = GetVoidContext();
+
+    for(ui_font *Face = Context.Fonts.First; Face; Face = Face->Next)
+    {
+        char Path[OS_MAX_PATH];
+        if(!Face->CacheDirty || !GetGlyphCachePath(Face, Path, sizeof(Path)))
+        {
+            continue;
+        }
+
+        uint64_t Footprint = ntext::GetGlyphCacheFootprint(Face->Generator);
+        void    *Memory    = malloc(Footprint);
+        uint64_t Size      = Memory ? ntext::WriteGlyphCache(Face->Generator, Memory, Footprint) : 0;
+
+        if(Size && OSWriteFile(ByteString((uint8_t *)Path, strlen(Path)), ByteString((uint8_t *)Memory, Size)))
+        {
+            Face->CacheDirty = false;
+        }
+
+        free(Memory);
+    }
+}
+
+// =================================================================
+// @Internal: Static Text Implementation
 
 static uint64_t
 GetTextFootprint(uint64_t Size)
 {
-    return 0;
+    uint64_t Result = sizeof(ui_text) + Size;
+    return Result;
 }
 
 
 static ui_text *
-PlaceTextInMemory(byte_string String, void *Memory)
+PlaceTextInMemory(byte_string String, ui_resource_key FontKey, void *Memory)
 {
     ui_text *Result = 0;
 
     if(Memory)
     {
+        uint8_t *Bytes = (uint8_t *)Memory + sizeof(ui_text);
+        MemoryCopy(Bytes, String.String, String.Size);
+
+        Result = (ui_text *)Memory;
+        Result->FontKey = FontKey;
+        Result->String  = ByteString(Bytes, String.Size);
+    }
+
+    return Result;
+}
+
+// =================================================================
+// @Internal: Glyph Workers Implementation
+
+static ui_glyph_workers *
+CreateGlyphWorkers(memory_arena *Arena)
+{
+    ui_glyph_workers *Result = 0;
+
+    uint32_t ProcessorCount = OSGetSystemInfo()->ProcessorCount;
+    uint32_t WorkerCount    = ProcessorCount > 1 ? ProcessorCount - 1 : 0;
+
+    if(WorkerCount == 0)
+    {
+        return Result;
+    }
+
+    os_work_queue *Queue = PushStruct(Arena, os_work_queue);
+    if(!Queue || !InitializeWorkQueue(Queue, WorkerCount) || Queue->ThreadCount == 0)
+    {
+        return Result;
     }
 
+    uint32_t      JobCount = Queue->ThreadCount + 1;
+    ui_glyph_job *Jobs     = PushArray(Arena, ui_glyph_job, JobCount);
+
+    for(uint32_t Idx = 0; Idx < JobCount; ++Idx)
+    {
+        ntext::memory_arena *Scratch = (ntext::memory_arena *)PushArena(Arena, UIGlyphJobScratchSize, AlignOf(ntext::memory_arena));
+        if(!Scratch)
+        {
+            return Result;
+        }
+
+        Scratch->Reserved     = UIGlyphJobScratchSize;
+        Scratch->BasePosition = 0;
+        Scratch->Position     = sizeof(ntext::memory_arena);
+
+        Jobs[Idx].Scratch = Scratch;
+    }
+
+    Result = PushStruct(Arena, ui_glyph_workers);
+    Result->Queue    = Queue;
+    Result->Jobs     = Jobs;
+    Result->JobCount = JobCount;
+
+    return Result;
+}
+
+static void
+RasterizeGlyphJob(void *Data)
+{
+    ui_glyph_job *Job = static_cast<ui_glyph_job *>(Data);
+
+    ntext::RasterizeGlyphList(*Job->List, Job->Start, Job->Stride, *Job->Generator, Job->Scratch);
+}
+
+// The rect of a glyph may still hold the pixels of a glyph evicted by a repack, it is cleared
+// when its own pixels are not uploaded.
+
+static void
+ClearAtlasRect(ntext::rectangle Source, ui_font *Face, memory_arena *Arena)
+{
+    uint16_t Width  = (uint16_t)(Source.Right  - Source.Left);
+    uint16_t Height = (uint16_t)(Source.Bottom - Source.Top );
+
+    if(Width && Height)
+    {
+        uint8_t *Pixels = PushArray(Arena, uint8_t, Width * Height);
+        if(Pixels)
+        {
+            PushAtlasUpdate(Face, (uint32_t)Source.Left, (uint32_t)Source.Top, Width, Height, Pixels, Width, Arena);
+        }
+    }
+}
+
+// Glyph coverage (or distance) is uploaded as is, the atlas is GreyScale and the glyph shader
+// multiplies the text color alpha with the coverage. A glyph without pixels (deferred, or its
+// arena ran out) clears its rect instead.
+
+static void
+UploadRasterizedGlyph(ntext::rasterized_glyph &Glyph, ui_font *Face, memory_arena *Arena)
+{
+    ntext::rasterized_buffer &Buffer = Glyph.Buffer;
+    ntext::rectangle         &Source = Glyph.Source;
+
+    if(!Buffer.Data)
+    {
+        ClearAtlasRect(Source, Face, Arena);
+        return;
+    }
+
+    uint16_t Width  = (uint16_t)Min((float)Buffer.Width , Source.Right  - Source.Left);
+    uint16_t Height = (uint16_t)Min((float)Buffer.Height, Source.Bottom - Source.Top );
+
+    if(Width == 0 || Height == 0)
+    {
+        return;
+    }
+
+    VOID_ASSERT(Buffer.BytesPerPixel == 1);
+
+    PushAtlasUpdate(Face, (uint32_t)Source.Left, (uint32_t)Source.Top, Width, Height, Buffer.Data, Buffer.Stride, Arena);
+}
+
+static void
+UploadRasterizedGlyphs(ntext::rasterized_glyph_list &List, ui_font *Face, memory_arena *Arena)
+{
+    for(ntext::rasterized_glyph_node *Node = List.First; Node; Node = Node->Next)
+    {
+        UploadRasterizedGlyph(Node->Value, Face, Arena);
+    }
+}
+
+// =================================================================
+// @Internal: Glyph Budget Implementation
+
+static ui_glyph_queue *
+CreateGlyphQueue(memory_arena *Arena)
+{
+    ui_glyph_queue *Result = PushStruct(Arena, ui_glyph_queue);
+
+    if(Result)
+    {
+        Result->Items       = PushArray(Arena, ui_pending_glyph, UIPendingGlyphCapacity);
+        Result->Capacity    = Result->Items ? UIPendingGlyphCapacity : 0;
+        Result->BudgetTicks = (uint64_t)(UIGlyphFrameBudget * (float)OSGetTimerFrequency());
+    }
+
+    return Result;
+}
+
+static void
+ResetGlyphBudget(ui_glyph_queue *Queue)
+{
+    Queue->FrameTicks   = 0;
+    Queue->FrameOverrun = false;
+}
+
+static bool
+HasGlyphBudget(ui_glyph_queue *Queue, uint64_t Begin)
+{
+    bool Result = Queue->FrameTicks + (OSReadTimer() - Begin) < Queue->BudgetTicks;
     return Result;
 }
+
+// A single glyph (or a parallel batch) may go past the budget, the frame is then counted
+// as an overrun once.
+
+static void
+ChargeGlyphBudget(ui_glyph_queue *Queue, uint64_t Ticks)
+{
+    Queue->FrameTicks += Ticks;
+
+    if(Queue->FrameTicks > Queue->BudgetTicks && !Queue->FrameOverrun)
+    {
+        Queue->FrameOverrun  = true;
+        Queue->OverrunCount += 1;
+
+        ProfileCounter("Glyph Budget Overruns", Queue->OverrunCount);
+    }
+}
+
+// The glyph is left without pixels, UploadRasterizedGlyphs clears its rect until it lands.
+// Returns false when the queue is full, the glyph must then be rasterized now.
+
+static bool
+DeferGlyph(ntext::rasterized_glyph &Glyph, ui_font *Face, ui_glyph_queue *Queue)
+{
+    if(Queue->Count == Queue->Capacity)
+    {
+        return false;
+    }
+
+    ui_pending_glyph &Pending = Queue->Items[(Queue->First + Queue->Count) % Queue->Capacity];
+    Pending.Face         = Face;
+    Pending.AtlasVersion = Face->Generator.AtlasVersion;
+    Pending.Glyph        = Glyph;
+
+    Queue->Count         += 1;
+    Queue->DeferredCount += 1;
+
+    return true;
+}
+
+// Rasterizes the misses of a run. Jobs take interleaved glyphs rather than contiguous
+// slices, glyphs of a run tend to be sorted by size (caps, then lower case) and this keeps
+// the work even. A parallel batch is only started with budget left and is not split.
+
+static void
+RasterizeMissingGlyphs(ntext::rasterized_glyph_list &List, ui_font *Face, memory_arena *UploadArena)
+{
+    void_context           &Context   = GetVoidContext();
+    ui_glyph_workers       *Workers   = Context.GlyphWorkers;
+    ui_glyph_queue         *Queue     = Context.GlyphQueue;
+    ntext::glyph_generator &Generator = Face->Generator;
+
+    if(!List.Count)
+    {
+        return;
+    }
+
+    TimeBlock("Glyph Rasterization");
+
+    uint64_t Begin = OSReadTimer();
+
+    if(Workers && List.Count >= UIParallelGlyphMinCount && HasGlyphBudget(Queue, Begin))
+    {
+        uint32_t JobCount = Min(Workers->JobCount, List.Count);
+
+        for(uint32_t Idx = 0; Idx < JobCount; ++Idx)
+        {
+            ui_glyph_job &Job = Workers->Jobs[Idx];
+            Job.List      = &List;
+            Job.Generator = &Generator;
+            Job.Start     = Idx;
+            Job.Stride    = JobCount;
+
+            ntext::ClearArena(Job.Scratch);
+            PushWorkEntry(Workers->Queue, RasterizeGlyphJob, &Job);
+        }
+
+        CompleteAllWork(Workers->Queue);
+    }
+    else
+    {
+        for(ntext::rasterized_glyph_node *Node = List.First; Node; Node = Node->Next)
+        {
+            if(HasGlyphBudget(Queue, Begin) || !DeferGlyph(Node->Value, Face, Queue))
+            {
+                ntext::RasterizeGlyph(Node->Value, Generator, Generator.Arena);
+            }
+        }
+    }
+
+    ChargeGlyphBudget(Queue, OSReadTimer() - Begin);
+
+    if(Queue->Count)
+    {
+        UIRequestWake(0.f);
+    }
+}
+
+// Glyphs left pending by a repack are emitted again by it, with their new rect.
+
+static void
+CompletePendingGlyphs(memory_arena *UploadArena)
+{
+    ui_glyph_queue *Queue = GetVoidContext().GlyphQueue;
+
+    if(!Queue || !Queue->Count)
+    {
+        return;
+    }
+
+    TimeBlock("Glyph Queue");
+
+    uint64_t Begin = OSReadTimer();
+
+    while(Queue->Count && HasGlyphBudget(Queue, Begin))
+    {
+        ui_pending_glyph Pending = Queue->Items[Queue->First];
+
+        Queue->First  = (Queue->First + 1) % Queue->Capacity;
+        Queue->Count -= 1;
+
+        ui_font *Face = Pending.Face;
+        if(Pending.AtlasVersion != Face->Generator.AtlasVersion)
+        {
+            continue;
+        }
+
+        ntext::RasterizeGlyph(Pending.Glyph, Face->Generator, Face->Generator.Arena);
+        UploadRasterizedGlyph(Pending.Glyph, Face, UploadArena);
+        ntext::ClearGlyphGeneratorFrame(Face->Generator);
+
+        Face->ReadyVersion += 1;
+    }
+
+    ChargeGlyphBudget(Queue, OSReadTimer() - Begin);
+
+    ProfileCounter("Glyph Queue Depth", Queue->Count);
+
+    // Pipelines painted earlier this frame only see the new glyphs on the next one.
+
+    UIRequestWake(0.f);
+}
+
+// =================================================================
+// @Internal: Shaped Run Cache Implementation
+
+// Entry 0 is the sentinel: its LRU links are the head/tail of the LRU chain and its hash
+// chain link is the free list (same layout as the resource table).
+
+typedef struct ui_shaped_run_entry
+{
+    ui_resource_key FontKey;
+    uint64_t        TextHash;
+    uint64_t        TextSize;
+    float           FontSize;
+
+    uint32_t        NextWithSameHashSlot;
+    uint32_t        NextLRU;
+    uint32_t        PrevLRU;
+
+    ui_shaped_run   Run;
+    uint64_t        ByteSize;
+} ui_shaped_run_entry;
+
+struct ui_shaped_run_cache
+{
+    ui_resource_stats    Stats;
+
+    uint64_t             ByteBudget;
+    uint64_t             ByteCount;
+
+    uint32_t             HashMask;
+    uint32_t             HashSlotCount;
+    uint32_t             EntryCount;
+    uint32_t             FreeCount;
+
+    uint32_t            *HashTable;
+    ui_shaped_run_entry *Entries;
+};
+
+static ui_shaped_run_entry *
+GetShapedRunEntry(uint32_t Index, ui_shaped_run_cache *Cache)
+{
+    VOID_ASSERT(Index < Cache->EntryCount);
+
+    ui_shaped_run_entry *Result = Cache->Entries + Index;
+    return Result;
+}
+
+static uint32_t *
+GetShapedRunSlotPointer(uint64_t TextHash, ui_resource_key FontKey, ui_shaped_run_cache *Cache)
+{
+    uint32_t HashIndex = (uint32_t)TextHash ^ (uint32_t)_mm_cvtsi128_si32(FontKey.Value);
+    uint32_t HashSlot  = (HashIndex & Cache->HashMask);
+
+    uint32_t *Result = &Cache->HashTable[HashSlot];
+    return Result;
+}
+
+static void
+UnlinkShapedRunLRU(ui_shaped_run_entry *Entry, ui_shaped_run_cache *Cache)
+{
+    ui_shaped_run_entry *Prev = GetShapedRunEntry(Entry->PrevLRU, Cache);
+    ui_shaped_run_entry *Next = GetShapedRunEntry(Entry->NextLRU, Cache);
+
+    Prev->NextLRU = Entry->NextLRU;
+    Next->PrevLRU = Entry->PrevLRU;
+}
+
+static void
+PushShapedRunLRU(uint32_t Index, ui_shaped_run_cache *Cache)
+{
+    ui_shaped_run_entry *Sentinel = GetShapedRunEntry(0, Cache);
+    ui_shaped_run_entry *Entry    = GetShapedRunEntry(Index, Cache);
+    ui_shaped_run_entry *Head     = GetShapedRunEntry(Sentinel->NextLRU, Cache);
+
+    Entry->NextLRU    = Sentinel->NextLRU;
+    Entry->PrevLRU    = 0;
+    Head->PrevLRU     = Index;
+    Sentinel->NextLRU = Index;
+}
+
+static void
+ReleaseShapedRunGlyphs(ui_shaped_run_entry *Entry, ui_shaped_run_cache *Cache)
+{
+    if(Entry->Run.Glyphs)
+    {
+        free(Entry->Run.Glyphs);
+
+        Cache->ByteCount -= Entry->ByteSize;
+    }
+
+    Entry->Run      = {};
+    Entry->ByteSize = 0;
+}
+
+// Evicts the least recently used run: unlinked from its hash chain and the LRU chain,
+// then pushed on the free list.
+
+static bool
+EvictShapedRun(ui_shaped_run_cache *Cache)
+{
+    ui_shaped_run_entry *Sentinel = GetShapedRunEntry(0, Cache);
+    uint32_t             Index    = Sentinel->PrevLRU;
+
+    if(!Index)
+    {
+        return false;
+    }
+
+    ui_shaped_run_entry *Entry = GetShapedRunEntry(Index, Cache);
+    uint32_t            *Link  = GetShapedRunSlotPointer(Entry->TextHash, Entry->FontKey, Cache);
+
+    while(*Link != Index)
+    {
+        VOID_ASSERT(*Link); // Internal Corruption
+        Link = &GetShapedRunEntry(*Link, Cache)->NextWithSameHashSlot;
+    }
+
+    *Link = Entry->NextWithSameHashSlot;
+
+    UnlinkShapedRunLRU    (Entry, Cache);
+    ReleaseShapedRunGlyphs(Entry, Cache);
+
+    Entry->NextWithSameHashSlot    = Sentinel->NextWithSameHashSlot;
+    Sentinel->NextWithSameHashSlot = Index;
+
+    Cache->FreeCount += 1;
+
+    return true;
+}
+
+// Distance fonts shape with their face, positions and sizes are scaled to the font size
+// while sources stay in atlas texels.
+
+static bool
+ShapeTextRun(byte_string Text, ui_font *Font, memory_arena *UploadArena, ui_shaped_run_entry *Entry, ui_shaped_run_cache *Cache)
+{
+    ntext::glyph_generator &Generator = Font->Face->Generator;
+    float                   Scale     = Font->Scale;
+
+    if(Font->Face->CachePixels)
+    {
+        UploadGlyphCacheAtlas(Font->Face, UploadArena);
+    }
+
+    if(!ntext::IsValidGlyphGenerator(Generator) || !Text.Size)
+    {
+        Entry->Run.AtlasVersion = Generator.AtlasVersion;
+        return false;
+    }
+
+    uint32_t                AtlasVersion = Generator.AtlasVersion;
+    ntext::shaped_glyph_run Shaped       = ntext::FillAtlas((const char *)Text.String, Text.Size, Generator);
+
+    // The run does not fit in the generator arena, it is kept empty as for an invalid font.
+
+    if(!Shaped.LayoutBufferSize)
+    {
+        Entry->Run.AtlasVersion = Shaped.AtlasVersion;
+        ntext::ClearGlyphGeneratorFrame(Generator);
+        return false;
+    }
+
+    // Glyphs, advance sums, breaks and lines share a single allocation. Runs of a fixed pitch
+    // font only need the sums if one of their glyphs does not use the fixed advance.
+
+    uint32_t GlyphCount = Shaped.LayoutBufferSize;
+    uint32_t BreakCount = FindTextBreaks(Text, GlyphCount, 0);
+    bool     IsFixed    = Generator.FixedAdvance > 0.f;
+
+    for(uint32_t Idx = 0; Idx < GlyphCount && IsFixed; ++Idx)
+    {
+        IsFixed = Shaped.LayoutBuffer[Idx].Advance == Generator.FixedAdvance;
+    }
+
+    uint64_t GlyphSize = GlyphCount       * sizeof(ui_shaped_glyph);
+    uint64_t SumSize   = IsFixed ? 0 : (GlyphCount + 1) * sizeof(float);
+    uint64_t BreakSize = BreakCount       * sizeof(ui_text_break);
+    uint64_t LineSize  = (BreakCount + 1) * sizeof(ui_text_line);
+    uint64_t ByteSize  = GlyphSize + SumSize + BreakSize + LineSize;
+
+    uint8_t         *Memory = GlyphCount ? (uint8_t *)malloc(ByteSize) : 0;
+    ui_shaped_glyph *Glyphs = (ui_shaped_glyph *)Memory;
+
+    float PenX           = 0.f;
+    float UnwrappedWidth = 0.f;
+
+    if(Memory)
+    {
+        Entry->Run.AdvanceSums  = IsFixed ? 0 : (float *)(Memory + GlyphSize);
+        Entry->Run.FixedAdvance = IsFixed ? Generator.FixedAdvance * Scale : 0.f;
+        Entry->Run.Breaks       = (ui_text_break *)(Memory + GlyphSize + SumSize);
+        Entry->Run.Lines        = (ui_text_line  *)(Memory + GlyphSize + SumSize + BreakSize);
+        Entry->Run.BreakCount   = FindTextBreaks(Text, GlyphCount, Entry->Run.Breaks);
+        Entry->Run.LineCount    = 0;
+        Entry->Run.WrapWidth    = 0.f;
+
+        for(uint32_t Idx = 0; Idx < GlyphCount; ++Idx)
+        {
+            ntext::glyph_layout_info Layout = Shaped.LayoutBuffer[Idx];
+            ntext::rectangle         Source = Shaped.SourceBuffer[Idx];
+
+            float Width  = Source.Right  - Source.Left;
+            float Height = Source.Bottom - Source.Top;
+
+            ui_shaped_glyph &Glyph = Glyphs[Idx];
+            Glyph.Position = rect_float::FromXYWH(PenX + Layout.OffsetX * Scale, Layout.OffsetY * Scale, Width * Scale, Height * Scale);
+            Glyph.Source   = rect_float::FromXYWH(Source.Left, Source.Top, Width, Height);
+            Glyph.Advance  = Layout.Advance * Scale;
+
+            if(!IsFixed)
+            {
+                Entry->Run.AdvanceSums[Idx] = PenX;
+            }
+
+            PenX += Glyph.Advance;
+        }
+
+        if(IsFixed)
+        {
+            PenX = GlyphCount * Entry->Run.FixedAdvance;
+        }
+        else
+        {
+            Entry->Run.AdvanceSums[GlyphCount] = PenX;
+        }
+
+        // The widest hard line is what a Fit width asks for, it is measured once here such
+        // that layout never wraps the run to size it.
+
+        float LineStartX = 0.f;
+
+        for(uint32_t Idx = 0; Idx < Entry->Run.BreakCount; ++Idx)
+        {
+            ui_text_break Break = Entry->Run.Breaks[Idx];
+
+            if(Break.Type == UITextBreak_Newline)
+            {
+                float BreakX = IsFixed ? Break.GlyphIndex       * Entry->Run.FixedAdvance : Entry->Run.AdvanceSums[Break.GlyphIndex];
+                float NextX  = IsFixed ? (Break.GlyphIndex + 1) * Entry->Run.FixedAdvance : Entry->Run.AdvanceSums[Break.GlyphIndex + 1];
+
+                UnwrappedWidth = Max(UnwrappedWidth, BreakX - LineStartX);
+                LineStartX     = NextX;
+            }
+        }
+
+        UnwrappedWidth = Max(UnwrappedWidth, PenX - LineStartX);
+    }
+
+    Font->Face->CacheDirty = Font->Face->CacheDirty || Shaped.RasterizedList.Count > 0;
+
+    RasterizeMissingGlyphs(Shaped.RasterizedList, Font->Face, UploadArena);
+    UploadRasterizedGlyphs(Shaped.RasterizedList, Font->Face, UploadArena);
+
+    // Runs painted earlier this frame sampled the atlas before it was repacked, they are
+    // shaped again (and damaged) next frame.
+
+    if(AtlasVersion != Generator.AtlasVersion)
+    {
+        UIRequestWake(0.f);
+    }
+
+    Entry->Run.Glyphs         = Glyphs;
+    Entry->Run.GlyphCount     = Glyphs ? GlyphCount : 0;
+    Entry->Run.Width          = PenX;
+    Entry->Run.UnwrappedWidth = UnwrappedWidth;
+    Entry->Run.LineHeight     = Font->Size;
+    Entry->Run.AtlasVersion   = Shaped.AtlasVersion;
+    Entry->ByteSize           = Glyphs ? ByteSize : 0;
+
+    Cache->ByteCount += Entry->ByteSize;
+
+    ntext::ClearGlyphGeneratorFrame(Generator);
+
+    return true;
+}
+
+// =================================================================
+// @Internal: Shaped Run Cache Public API
+
+static uint64_t
+GetShapedRunCacheFootprint(ui_shaped_run_cache_params Params)
+{
+    uint64_t HashTableSize  = Params.HashSlotCount * sizeof(uint32_t);
+    uint64_t EntryArraySize = Params.EntryCount    * sizeof(ui_shaped_run_entry);
+    uint64_t Result         = sizeof(ui_shaped_run_cache) + HashTableSize + EntryArraySize;
+
+    return Result;
+}
+
+static ui_shaped_run_cache *
+PlaceShapedRunCacheInMemory(ui_shaped_run_cache_params Params, void *Memory)
+{
+    VOID_ASSERT(Params.EntryCount > 1);
+    VOID_ASSERT(Params.HashSlotCount);
+    VOID_ASSERT(VOID_ISPOWEROFTWO(Params.HashSlotCount));
+
+    ui_shaped_run_cache *Result = 0;
+
+    if(Memory)
+    {
+        uint32_t            *HashTable = (uint32_t *)Memory;
+        ui_shaped_run_entry *Entries   = (ui_shaped_run_entry *)(HashTable + Params.HashSlotCount);
+
+        Result = (ui_shaped_run_cache *)(Entries + Params.EntryCount);
+        Result->Stats         = {};
+        Result->ByteBudget    = Params.ByteBudget;
+        Result->ByteCount     = 0;
+        Result->HashTable     = HashTable;
+        Result->Entries       = Entries;
+        Result->EntryCount    = Params.EntryCount;
+        Result->FreeCount     = Params.EntryCount - 1;
+        Result->HashSlotCount = Params.HashSlotCount;
+        Result->HashMask      = Params.HashSlotCount - 1;
+
+        for(uint32_t Idx = 0; Idx < Params.HashSlotCount; ++Idx)
+        {
+            HashTable[Idx] = 0;
+        }
+
+        for(uint32_t Idx = 0; Idx < Params.EntryCount; ++Idx)
+        {
+            ui_shaped_run_entry *Entry = GetShapedRunEntry(Idx, Result);
+            MemoryZero(Entry, sizeof(ui_shaped_run_entry));
+
+            Entry->NextWithSameHashSlot = (Idx + 1) < Params.EntryCount ? Idx + 1 : 0;
+        }
+    }
+
+    return Result;
+}
+
+static ui_shaped_run *
+FindShapedRun(byte_string Text, ui_resource_key FontKey, memory_arena *UploadArena, ui_shaped_run_cache *Cache)
+{
+    VOID_ASSERT(Cache);
+
+    void_context &Context = GetVoidContext();
+
+    ui_resource_state FontState = FindResourceByKey(FontKey, Context.ResourceTable);
+    if(FontState.ResourceType != UIResource_Font || !FontState.Resource)
+    {
+        return 0;
+    }
+
+    ui_font *Font     = static_cast<ui_font *>(FontState.Resource);
+    float    FontSize = Font->Size;
+    uint64_t TextHash = HashByteString(Text);
+
+    uint32_t            *Slot       = GetShapedRunSlotPointer(TextHash, FontKey, Cache);
+    uint32_t             EntryIndex = Slot[0];
+    ui_shaped_run_entry *Entry      = 0;
+
+    while(EntryIndex)
+    {
+        ui_shaped_run_entry *Candidate = GetShapedRunEntry(EntryIndex, Cache);
+        if(Candidate->TextHash == TextHash && Candidate->TextSize == Text.Size && Candidate->FontSize == FontSize &&
+           ResourceKeyAreEqual(Candidate->FontKey, FontKey))
+        {
+            Entry = Candidate;
+            break;
+        }
+
+        EntryIndex = Candidate->NextWithSameHashSlot;
+    }
+
+    if(Entry && Entry->Run.AtlasVersion == Font->Face->Generator.AtlasVersion)
+    {
+        UnlinkShapedRunLRU(Entry, Cache);
+        PushShapedRunLRU(EntryIndex, Cache);
+
+        ++Cache->Stats.CacheHitCount;
+
+        return &Entry->Run;
+    }
+
+    ++Cache->Stats.CacheMissCount;
+
+    // Stale runs are shaped again in place. New runs first make room: an entry must be free
+    // and the glyph memory must fit in the budget, the run itself may exceed it.
+
+    if(Entry)
+    {
+        UnlinkShapedRunLRU    (Entry, Cache);
+        ReleaseShapedRunGlyphs(Entry, Cache);
+    }
+    else
+    {
+        uint64_t Needed = Text.Size * (sizeof(ui_shaped_glyph) + sizeof(float));
+
+        while(!Cache->FreeCount || (Cache->ByteCount + Needed > Cache->ByteBudget && Cache->ByteCount))
+        {
+            if(!EvictShapedRun(Cache))
+            {
+                break;
+            }
+        }
+
+        // Evicting may have unlinked the head of our slot.
+        Slot = GetShapedRunSlotPointer(TextHash, FontKey, Cache);
+
+        ui_shaped_run_entry *Sentinel = GetShapedRunEntry(0, Cache);
+
+        EntryIndex = Sentinel->NextWithSameHashSlot;
+        VOID_ASSERT(EntryIndex);
+
+        Entry = GetShapedRunEntry(EntryIndex, Cache);
+        Sentinel->NextWithSameHashSlot = Entry->NextWithSameHashSlot;
+        Cache->FreeCount              -= 1;
+
+        Entry->FontKey              = FontKey;
+        Entry->TextHash             = TextHash;
+        Entry->TextSize             = Text.Size;
+        Entry->FontSize             = FontSize;
+        Entry->NextWithSameHashSlot = Slot[0];
+
+        Slot[0] = EntryIndex;
+    }
+
+    PushShapedRunLRU(EntryIndex, Cache);
+
+    ShapeTextRun(Text, Font, UploadArena, Entry, Cache);
+
+    return &Entry->Run;
+}
+
+static ui_resource_stats
+GetShapedRunCacheStats(ui_shaped_run_cache *Cache)
+{
+    ui_resource_stats Result = Cache->Stats;
+    return Result;
+}
+
+// Samples the cache into the profiler counters: hit rate since startup and glyph memory in
+// use against the budget.
+
+static void
+ProfileShapedRunCache(ui_shaped_run_cache *Cache)
+{
+    ui_resource_stats Stats  = GetShapedRunCacheStats(Cache);
+    uint64_t          Lookup = Stats.CacheHitCount + Stats.CacheMissCount;
+
+    ProfileCounter("Shaped Run Misses"  , Stats.CacheMissCount);
+    ProfileCounter("Shaped Run Hit %"   , Lookup ? Stats.CacheHitCount * 100 / Lookup : 0);
+    ProfileCounter("Shaped Run KB"      , Cache->ByteCount / 1024);
+    ProfileCounter("Shaped Run Budget %", Cache->ByteBudget ? Cache->ByteCount * 100 / Cache->ByteBudget : 0);
+}
+
+// =================================================================
+// @Internal: Text Wrapping Implementation
+
+// Breaks are only found on ASCII bytes, the glyph index of a byte is its offset minus the
+// continuation bytes before it (one glyph per codepoint). Invalid sequences may decode to
+// more glyphs than that, the index is clamped.
+
+static uint32_t
+FindTextBreaks(byte_string Text, uint32_t GlyphCount, ui_text_break *Breaks)
+{
+    uint32_t Result = 0;
+
+    __m128i Space        = _mm_set1_epi8(' ');
+    __m128i Tab          = _mm_set1_epi8('\t');
+    __m128i Return       = _mm_set1_epi8('\r');
+    __m128i Newline      = _mm_set1_epi8('\n');
+    __m128i Hyphen       = _mm_set1_epi8('-');
+    __m128i Slash        = _mm_set1_epi8('/');
+    __m128i ContinueMask = _mm_set1_epi8((char)0xC0);
+    __m128i ContinueTag  = _mm_set1_epi8((char)0x80);
+
+    uint32_t GlyphBase = 0;
+
+    for(uint64_t Offset = 0; Offset < Text.Size && GlyphBase < GlyphCount; Offset += 16)
+    {
+        uint64_t Remaining = Text.Size - Offset;
+        uint32_t ValidMask = Remaining >= 16 ? 0xFFFF : (uint32_t)VOID_BITMASK(Remaining);
+        __m128i  Bytes;
+
+        if(Remaining >= 16)
+        {
+            Bytes = _mm_loadu_si128((const __m128i *)(Text.String + Offset));
+        }
+        else
+        {
+            uint8_t Tail[16] = {};
+            MemoryCopy(Tail, Text.String + Offset, Remaining);
+
+            Bytes = _mm_loadu_si128((const __m128i *)Tail);
+        }
+
+        __m128i IsSpace   = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Bytes, Space), _mm_cmpeq_epi8(Bytes, Tab)), _mm_cmpeq_epi8(Bytes, Return));
+        __m128i IsNewline = _mm_cmpeq_epi8(Bytes, Newline);
+        __m128i IsPunct   = _mm_or_si128(_mm_cmpeq_epi8(Bytes, Hyphen), _mm_cmpeq_epi8(Bytes, Slash));
+        __m128i IsCont    = _mm_cmpeq_epi8(_mm_and_si128(Bytes, ContinueMask), ContinueTag);
+
+        uint32_t NewlineBits  = (uint32_t)_mm_movemask_epi8(IsNewline) & ValidMask;
+        uint32_t PunctBits    = (uint32_t)_mm_movemask_epi8(IsPunct)   & ValidMask;
+        uint32_t ContinueBits = (uint32_t)_mm_movemask_epi8(IsCont)    & ValidMask;
+        uint32_t BreakBits    = ((uint32_t)_mm_movemask_epi8(IsSpace) & ValidMask) | NewlineBits | PunctBits;
+
+        while(BreakBits)
+        {
+            uint32_t Bit        = FindFirstBit(BreakBits);
+            uint32_t GlyphIndex = GlyphBase + Bit - CountSetBits(ContinueBits & (uint32_t)VOID_BITMASK(Bit));
+
+            if(GlyphIndex >= GlyphCount)
+            {
+                break;
+            }
+
+            if(Breaks)
+            {
+                UITextBreak_Type Type = UITextBreak_Space;
+                if(NewlineBits & (1u << Bit)) Type = UITextBreak_Newline;
+                if(PunctBits   & (1u << Bit)) Type = UITextBreak_Punctuation;
+
+                Breaks[Result] = {.GlyphIndex = GlyphIndex, .Type = Type};
+            }
+
+            ++Result;
+
+            BreakBits &= BreakBits - 1;
+        }
+
+        GlyphBase += CountSetBits(ValidMask) - CountSetBits(ContinueBits);
+    }
+
+    return Result;
+}
+
+// Greedy fit: the last break which still fits is remembered and a line is emitted at it
+// once a break overflows. A line ending at a space or a newline excludes that glyph.
+
+static uint32_t
+WrapShapedRun(float MaxWidth, ui_shaped_run *Run)
+{
+    VOID_ASSERT(Run);
+
+    if(!Run->GlyphCount || !Run->Lines)
+    {
+        return 0;
+    }
+
+    if(Run->LineCount && Run->WrapWidth == MaxWidth)
+    {
+        return Run->LineCount;
+    }
+
+    bool     Unbounded    = MaxWidth <= 0.f;
+    uint32_t LineCount    = 0;
+    uint32_t Start        = 0;
+    uint32_t Candidate    = 0;
+    bool     HasCandidate = false;
+
+    for(uint32_t Idx = 0; Idx < Run->BreakCount; ++Idx)
+    {
+        ui_text_break Break   = Run->Breaks[Idx];
+        uint32_t      LineEnd = Break.Type == UITextBreak_Punctuation ? Break.GlyphIndex + 1 : Break.GlyphIndex;
+        bool          Fits    = Unbounded || GetRunPenX(Run, LineEnd) - GetRunPenX(Run, Start) <= MaxWidth;
+
+        if(!Fits && HasCandidate)
+        {
+            ui_text_break Chosen = Run->Breaks[Candidate];
+            uint32_t      End    = Chosen.Type == UITextBreak_Punctuation ? Chosen.GlyphIndex + 1 : Chosen.GlyphIndex;
+
+            Run->Lines[LineCount++] = {.Start = Start, .End = End, .Width = GetRunPenX(Run, End) - GetRunPenX(Run, Start)};
+
+            Start     = Chosen.GlyphIndex + 1;
+            HasCandidate = false;
+
+            // The break is measured again from the new line start.
+            --Idx;
+            continue;
+        }
+
+        if(Break.Type == UITextBreak_Newline)
+        {
+            Run->Lines[LineCount++] = {.Start = Start, .End = LineEnd, .Width = GetRunPenX(Run, LineEnd) - GetRunPenX(Run, Start)};
+
+            Start     = Break.GlyphIndex + 1;
+            HasCandidate = false;
+        }
+        else
+        {
+            Candidate    = Idx;
+            HasCandidate = true;
+        }
+    }
+
+    if(!Unbounded && HasCandidate && GetRunPenX(Run, Run->GlyphCount) - GetRunPenX(Run, Start) > MaxWidth)
+    {
+        ui_text_break Chosen = Run->Breaks[Candidate];
+        uint32_t      End    = Chosen.Type == UITextBreak_Punctuation ? Chosen.GlyphIndex + 1 : Chosen.GlyphIndex;
+
+        Run->Lines[LineCount++] = {.Start = Start, .End = End, .Width = GetRunPenX(Run, End) - GetRunPenX(Run, Start)};
+
+        Start = Chosen.GlyphIndex + 1;
+    }
+
+    Run->Lines[LineCount++] = {.Start = Start, .End = Run->GlyphCount, .Width = GetRunPenX(Run, Run->GlyphCount) - GetRunPenX(Run, Start)};
+
+    Run->LineCount = LineCount;
+    Run->WrapWidth = MaxWidth;
+
+    return LineCount;
+}
+
+static float
+GetRunPenX(ui_shaped_run *Run, uint32_t GlyphIndex)
+{
+    VOID_ASSERT(Run && GlyphIndex <= Run->GlyphCount);
+
+    float Result = Run->AdvanceSums ? Run->AdvanceSums[GlyphIndex] : GlyphIndex * Run->FixedAdvance;
+    return Result;
+}
+
+// Fixed pitch fonts are measured from the byte count of each line, the text is neither hashed
+// nor shaped. A line with a glyph that may not use the fixed advance (see
+// MeasureFixedPitchText) measures the whole text from its shaped run, as ShapeTextRun keeps
+// the summed advances of such runs.
+
+static ui_text_metrics
+MeasureText(ui_resource_key TextKey, memory_arena *UploadArena)
+{
+    void_context &Context = GetVoidContext();
+
+    ui_text_metrics Result = {};
+
+    ui_resource_state TextState = FindResourceByKey(TextKey, Context.ResourceTable);
+    if(TextState.ResourceType == UIResource_Text && TextState.Resource)
+    {
+        ui_text           *Text      = static_cast<ui_text *>(TextState.Resource);
+        ui_resource_state  FontState = FindResourceByKey(Text->FontKey, Context.ResourceTable);
+
+        if(FontState.ResourceType == UIResource_Font && FontState.Resource)
+        {
+            ui_font *Font = static_cast<ui_font *>(FontState.Resource);
+
+            if(Font->Face->Generator.FixedAdvance > 0.f)
+            {
+                uint8_t *Bytes   = Text->String.String;
+                uint64_t Size    = Text->String.Size;
+                uint64_t Start   = 0;
+                bool     IsFixed = true;
+
+                while(Start <= Size && IsFixed)
+                {
+                    uint8_t *Newline = (uint8_t *)memchr(Bytes + Start, '\n', Size - Start);
+                    uint64_t End     = Newline ? (uint64_t)(Newline - Bytes) : Size;
+                    float    Width   = ntext::MeasureFixedPitchText((const char *)Bytes + Start, End - Start, Font->Face->Generator);
+
+                    IsFixed      = Width >= 0.f;
+                    Result.Width = Max(Result.Width, Width * Font->Scale);
+                    Start        = End + 1;
+                }
+
+                if(IsFixed)
+                {
+                    Result.LineHeight = Size ? Font->Size : 0.f;
+                    return Result;
+                }
+
+                Result = {};
+            }
+        }
+
+        ui_shaped_run *Run = FindShapedRun(Text->String, Text->FontKey, UploadArena, Context.ShapedRunCache);
+
+        if(Run && Run->GlyphCount)
+        {
+            Result.Width      = Run->UnwrappedWidth;
+            Result.LineHeight = Run->LineHeight;
+        }
+    }
+
+    return Result;
+}
+
+static float
+MeasureTextHeight(ui_resource_key TextKey, float Width, memory_arena *UploadArena)
+{
+    void_context &Context = GetVoidContext();
+
+    float Result = 0.f;
+
+    ui_resource_state TextState = FindResourceByKey(TextKey, Context.ResourceTable);
+    if(TextState.ResourceType == UIResource_Text && TextState.Resource)
+    {
+        ui_text       *Text = static_cast<ui_text *>(TextState.Resource);
+        ui_shaped_run *Run  = FindShapedRun(Text->String, Text->FontKey, UploadArena, Context.ShapedRunCache);
+
+        if(Run)
+        {
+            Result = WrapShapedRun(Width, Run) * Run->LineHeight;
+        }
+    }
+
+    return Result;
+}
+
+// =================================================================
+// @Internal: Text Input Implementation
+
+static float
+GetTextInputLineHeight(ui_text_input *Input)
+{
+    void_context &Context = GetVoidContext();
+
+    float Result = 0.f;
+
+    ui_resource_state FontState = FindResourceByKey(Input->FontKey, Context.ResourceTable);
+    if(FontState.ResourceType == UIResource_Font && FontState.Resource)
+    {
+        ui_font *Font = static_cast<ui_font *>(FontState.Resource);
+        Result = Font->Size;
+    }
+
+    return Result;
+}
+
+static uint8_t
+GetTextInputByte(ui_text_input *Input, uint64_t Offset)
+{
+    uint8_t Result = Input->Buffer[Offset < Input->GapStart ? Offset : Offset + Input->GapSize];
+    return Result;
+}
+
+static void
+MoveTextInputGap(ui_text_input *Input, uint64_t Offset)
+{
+    VOID_ASSERT(Offset <= Input->Size);
+
+    uint8_t *Buffer = Input->Buffer;
+
+    if(Offset < Input->GapStart)
+    {
+        MemoryCopy(Buffer + Offset + Input->GapSize, Buffer + Offset, Input->GapStart - Offset);
+    }
+    else if(Offset > Input->GapStart)
+    {
+        MemoryCopy(Buffer + Input->GapStart, Buffer + Input->GapStart + Input->GapSize, Offset - Input->GapStart);
+    }
+
+    Input->GapStart = Offset;
+}
+
+// Ranges on one side of the gap are read in place, the others are copied to Arena.
+
+static byte_string
+ReadTextInput(ui_text_input *Input, uint64_t Start, uint64_t Size, memory_arena *Arena)
+{
+    VOID_ASSERT(Start + Size <= Input->Size);
+
+    byte_string Result = {};
+
+    if(Start + Size <= Input->GapStart)
+    {
+        Result = ByteString(Input->Buffer + Start, Size);
+    }
+    else if(Start >= Input->GapStart)
+    {
+        Result = ByteString(Input->Buffer + Start + Input->GapSize, Size);
+    }
+    else
+    {
+        uint64_t Before = Input->GapStart - Start;
+        uint8_t *Bytes  = PushArray(Arena, uint8_t, Size);
+
+        MemoryCopy(Bytes         , Input->Buffer + Start, Before);
+        MemoryCopy(Bytes + Before, Input->Buffer + Input->GapStart + Input->GapSize, Size - Before);
+
+        Result = ByteString(Bytes, Size);
+    }
+
+    return Result;
+}
+
+static uint64_t
+GetCaretLineStart(ui_text_input *Input, uint32_t LineIndex)
+{
+    uint64_t Result = Input->Lines[LineIndex].Start;
+
+    if(LineIndex >= Input->ShiftLine)
+    {
+        Result += Input->ShiftDelta;
+    }
+
+    return Result;
+}
+
+// Applies the pending shift to the lines between the old and the new boundary, which costs
+// the distance in lines to the previous edit.
+
+static void
+MoveCaretLineShift(ui_text_input *Input, uint32_t ShiftLine)
+{
+    if(Input->ShiftDelta)
+    {
+        for(uint32_t Idx = Input->ShiftLine; Idx < ShiftLine && Idx < Input->LineCount; ++Idx)
+        {
+            Input->Lines[Idx].Start += Input->ShiftDelta;
+        }
+
+        for(uint32_t Idx = ShiftLine; Idx < Input->ShiftLine && Idx < Input->LineCount; ++Idx)
+        {
+            Input->Lines[Idx].Start -= Input->ShiftDelta;
+        }
+    }
+
+    Input->ShiftLine = ShiftLine;
+}
+
+// Last line starting at or before Offset.
+
+static uint32_t
+FindCaretLine(ui_text_input *Input, uint64_t Offset)
+{
+    VOID_ASSERT(Input->LineCount);
+
+    uint32_t Low  = 0;
+    uint32_t High = Input->LineCount - 1;
+
+    while(Low < High)
+    {
+        uint32_t Middle = Low + (High - Low + 1) / 2;
+
+        if(GetCaretLineStart(Input, Middle) <= Offset)
+        {
+            Low = Middle;
+        }
+        else
+        {
+            High = Middle - 1;
+        }
+    }
+
+    return Low;
+}
+
+// Last caret of the line at or before the byte Offset (from the start of the line).
+
+static uint32_t
+FindCaretIndex(ui_caret_line *Line, uint32_t Offset)
+{
+    uint32_t Low  = 0;
+    uint32_t High = Line->CaretCount - 1;
+
+    while(Low < High)
+    {
+        uint32_t Middle = Low + (High - Low + 1) / 2;
+
+        if(Line->Offsets[Middle] <= Offset)
+        {
+            Low = Middle;
+        }
+        else
+        {
+            High = Middle - 1;
+        }
+    }
+
+    return Low;
+}
+
+static float
+GetCaretPenX(ui_caret_line *Line, uint32_t Caret)
+{
+    VOID_ASSERT(Caret < Line->CaretCount);
+
+    float Result = Line->Sums ? Line->Sums[Caret] : Caret * Line->FixedAdvance;
+    return Result;
+}
+
+// Replaces OldCount lines at First with the lines of the content in [Start, End), which must
+// begin and end on line boundaries. New lines are dirty and none of them may be shifted, the
+// caller moves the shift boundary after them. Returns their count.
+
+static uint32_t
+IndexCaretLines(ui_text_input *Input, uint32_t First, uint32_t OldCount, uint64_t Start, uint64_t End)
+{
+    VOID_ASSERT(First + OldCount <= Input->LineCount);
+
+    uint32_t NewCount = 1;
+    for(uint64_t Idx = Start; Idx < End; ++Idx)
+    {
+        NewCount += GetTextInputByte(Input, Idx) == '\n';
+    }
+
+    for(uint32_t Idx = First; Idx < First + OldCount; ++Idx)
+    {
+        free(Input->Lines[Idx].Offsets);
+    }
+
+    uint32_t LineCount = Input->LineCount - OldCount + NewCount;
+
+    if(LineCount > Input->LineCapacity)
+    {
+        uint32_t Capacity = Input->LineCapacity ? Input->LineCapacity * 2 : 16;
+        while(Capacity < LineCount)
+        {
+            Capacity *= 2;
+        }
+
+        Input->Lines        = (ui_caret_line *)realloc(Input->Lines, Capacity * sizeof(ui_caret_line));
+        Input->LineCapacity = Capacity;
+
+        VOID_ASSERT(Input->Lines);
+    }
+
+    if(NewCount != OldCount)
+    {
+        MemoryCopy(Input->Lines + First + NewCount, Input->Lines + First + OldCount, (Input->LineCount - First - OldCount) * sizeof(ui_caret_line));
+    }
+
+    uint64_t LineStart = Start;
+
+    for(uint32_t Idx = 0; Idx < NewCount; ++Idx)
+    {
+        uint64_t LineEnd = LineStart;
+        while(LineEnd < End && GetTextInputByte(Input, LineEnd) != '\n')
+        {
+            ++LineEnd;
+        }
+
+        Input->Lines[First + Idx] = {.Start = LineStart, .Size = (uint32_t)(LineEnd - LineStart), .CaretCount = 0, .Offsets = 0, .Sums = 0, .FixedAdvance = 0.f, .IsDirty = true};
+
+        LineStart = LineEnd + 1;
+    }
+
+    Input->LineCount = LineCount;
+
+    return NewCount;
+}
+
+// Carets are found on the lead bytes of the line. Invalid sequences may shape to more glyphs
+// than carets, the extra ones are never reached. Glyphs missing from the run (the font does
+// not exist) are placed at the end of the run. A fixed pitch run with one glyph per caret
+// keeps no sums. A line split by the gap is shaped from a copy in UploadArena.
+
+static ui_caret_line *
+MeasureCaretLine(ui_text_input *Input, uint32_t LineIndex, memory_arena *UploadArena)
+{
+    VOID_ASSERT(LineIndex < Input->LineCount);
+
+    ui_caret_line *Line = Input->Lines + LineIndex;
+
+    if(Line->IsDirty)
+    {
+        void_context &Context = GetVoidContext();
+
+        byte_string    Text = ReadTextInput(Input, GetCaretLineStart(Input, LineIndex), Line->Size, UploadArena);
+        ui_shaped_run *Run  = FindShapedRun(Text, Input->FontKey, UploadArena, Context.ShapedRunCache);
+
+        uint32_t CaretCount = 1;
+        for(uint32_t Idx = 0; Idx < Line->Size; ++Idx)
+        {
+            CaretCount += (Text.String[Idx] & 0xC0) != 0x80;
+        }
+
+        uint32_t GlyphCount = Run ? Run->GlyphCount : 0;
+        bool     IsFixed    = GlyphCount && Run->FixedAdvance > 0.f && GlyphCount == CaretCount - 1;
+        uint64_t SumSize    = IsFixed ? 0 : CaretCount * sizeof(float);
+
+        uint8_t *Memory = (uint8_t *)malloc(CaretCount * sizeof(uint32_t) + SumSize);
+        VOID_ASSERT(Memory);
+
+        free(Line->Offsets);
+
+        Line->Offsets      = (uint32_t *)Memory;
+        Line->Sums         = IsFixed ? 0 : (float *)(Memory + CaretCount * sizeof(uint32_t));
+        Line->FixedAdvance = IsFixed ? Run->FixedAdvance : 0.f;
+        Line->CaretCount   = CaretCount;
+        Line->IsDirty      = false;
+
+        float    Width = GlyphCount ? GetRunPenX(Run, GlyphCount) : 0.f;
+        uint32_t Caret = 0;
+
+        for(uint32_t Idx = 0; Idx < Line->Size; ++Idx)
+        {
+            if((Text.String[Idx] & 0xC0) != 0x80)
+            {
+                Line->Offsets[Caret] = Idx;
+
+                if(!IsFixed)
+                {
+                    Line->Sums[Caret] = Caret < GlyphCount ? GetRunPenX(Run, Caret) : Width;
+                }
+
+                ++Caret;
+            }
+        }
+
+        Line->Offsets[Caret] = Line->Size;
+
+        if(!IsFixed)
+        {
+            Line->Sums[Caret] = Width;
+        }
+    }
+
+    return Line;
+}
+
+static uint64_t
+GetTextInputFootprint(void)
+{
+    uint64_t Result = sizeof(ui_text_input);
+    return Result;
+}
+
+// The content of a new input is the bytes before the first zero, the gap is the rest of the
+// buffer.
+
+static ui_text_input *
+PlaceTextInputInMemory(uint8_t *Buffer, uint64_t BufferSize, ui_resource_key FontKey, void *Memory)
+{
+    VOID_ASSERT(Buffer && BufferSize);
+
+    ui_text_input *Result = 0;
+
+    if(Memory)
+    {
+        uint64_t Size = 0;
+        while(Size < BufferSize - 1 && Buffer[Size])
+        {
+            ++Size;
+        }
+        Buffer[Size] = 0;
+
+        Result = (ui_text_input *)Memory;
+        Result->FontKey          = FontKey;
+        Result->Buffer           = Buffer;
+        Result->Capacity         = BufferSize;
+        Result->Size             = Size;
+        Result->GapStart         = Size;
+        Result->GapSize          = BufferSize - Size;
+        Result->Caret            = Size;
+        Result->Anchor           = Size;
+        Result->Lines            = 0;
+        Result->LineCount        = 0;
+        Result->LineCapacity     = 0;
+        Result->ShiftLine        = 0;
+        Result->ShiftDelta       = 0;
+        Result->PointerAnchor    = {};
+        Result->PointerCaret     = {};
+        Result->HasPointerAnchor = false;
+        Result->HasPointerCaret  = false;
+        Result->Version          = 0;
+        Result->OnEdit           = 0;
+        Result->UserData         = 0;
+
+        IndexCaretLines(Result, 0, 0, 0, Size);
+    }
+
+    return Result;
+}
+
+static void
+ReleaseTextInput(ui_text_input *Input)
+{
+    if(Input)
+    {
+        for(uint32_t Idx = 0; Idx < Input->LineCount; ++Idx)
+        {
+            free(Input->Lines[Idx].Offsets);
+        }
+
+        free(Input->Lines);
+
+        Input->Lines        = 0;
+        Input->LineCount    = 0;
+        Input->LineCapacity = 0;
+    }
+}
+
+// The shift boundary is first moved after the last touched line, such that the spliced lines
+// are unshifted and the lines after them only take the size difference.
+
+static bool
+ReplaceTextInput(ui_text_input *Input, uint64_t Offset, uint64_t RemoveSize, byte_string Text)
+{
+    VOID_ASSERT(Input && Offset + RemoveSize <= Input->Size);
+
+    uint64_t Size = Input->Size - RemoveSize + Text.Size;
+    if(Size >= Input->Capacity)
+    {
+        return false;
+    }
+
+    uint32_t First = FindCaretLine(Input, Offset);
+    uint32_t Last  = FindCaretLine(Input, Offset + RemoveSize);
+    int64_t  Delta = (int64_t)Text.Size - (int64_t)RemoveSize;
+
+    MoveCaretLineShift(Input, Last + 1);
+
+    uint64_t Start = Input->Lines[First].Start;
+    uint64_t End   = Input->Lines[Last].Start + Input->Lines[Last].Size + Delta;
+
+    MoveTextInputGap(Input, Offset);
+    MemoryCopy(Input->Buffer + Offset, Text.String, Text.Size);
+
+    Input->GapStart += Text.Size;
+    Input->GapSize   = Input->GapSize + RemoveSize - Text.Size;
+    Input->Size      = Size;
+    Input->Caret     = Offset + Text.Size;
+    Input->Anchor    = Input->Caret;
+    Input->Version  += 1;
+
+    uint32_t NewCount = IndexCaretLines(Input, First, Last - First + 1, Start, End);
+
+    Input->ShiftLine   = First + NewCount;
+    Input->ShiftDelta += Delta;
+
+    if(Input->OnEdit)
+    {
+        ui_text_edit Edit =
+        {
+            .Offset            = Offset,
+            .RemovedSize       = RemoveSize,
+            .InsertedSize      = Text.Size,
+            .FirstLine         = First,
+            .RemovedLineCount  = Last - First + 1,
+            .InsertedLineCount = NewCount,
+        };
+
+        Input->OnEdit(Edit, Input->UserData);
+    }
+
+    return true;
+}
+
+static byte_string
+GetTextInputString(ui_text_input *Input)
+{
+    VOID_ASSERT(Input);
+
+    MoveTextInputGap(Input, Input->Size);
+    Input->Buffer[Input->Size] = 0;
+
+    byte_string Result = ByteString(Input->Buffer, Input->Size);
+    return Result;
+}
+
+// The caret goes before the glyph whose center is right of X. Fixed pitch lines round
+// X / FixedAdvance, others binary search their sums for the last pen position at or left of
+// X and then pick the closest neighbour.
+
+static uint64_t
+FindTextInputOffset(ui_text_input *Input, vec2_float Point, memory_arena *UploadArena)
+{
+    VOID_ASSERT(Input);
+
+    float    LineHeight = GetTextInputLineHeight(Input);
+    uint32_t LineIndex  = 0;
+
+    if(LineHeight > 0.f && Point.Y > 0.f)
+    {
+        float Row = Point.Y / LineHeight;
+        LineIndex = Row < (float)(Input->LineCount - 1) ? (uint32_t)Row : Input->LineCount - 1;
+    }
+
+    ui_caret_line *Line   = MeasureCaretLine(Input, LineIndex, UploadArena);
+    uint32_t       Column = 0;
+
+    if(Point.X <= 0.f)
+    {
+        Column = 0;
+    }
+    else if(!Line->Sums)
+    {
+        float Columns = Point.X / Line->FixedAdvance + 0.5f;
+        Column = Columns < (float)(Line->CaretCount - 1) ? (uint32_t)Columns : Line->CaretCount - 1;
+    }
+    else
+    {
+        float    *Sums = Line->Sums;
+        uint32_t  Low  = 0;
+        uint32_t  High = Line->CaretCount - 1;
+
+        while(Low < High)
+        {
+            uint32_t Middle = Low + (High - Low + 1) / 2;
+
+            if(Sums[Middle] <= Point.X)
+            {
+                Low = Middle;
+            }
+            else
+            {
+                High = Middle - 1;
+            }
+        }
+
+        if(Low + 1 < Line->CaretCount && Point.X - Sums[Low] > Sums[Low + 1] - Point.X)
+        {
+            Low += 1;
+        }
+
+        Column = Low;
+    }
+
+    uint64_t Result = GetCaretLineStart(Input, LineIndex) + Line->Offsets[Column];
+    return Result;
+}
+
+static rect_float
+GetTextInputCaretRect(ui_text_input *Input, uint64_t Offset, memory_arena *UploadArena)
+{
+    VOID_ASSERT(Input && Offset <= Input->Size);
+
+    uint32_t       LineIndex  = FindCaretLine(Input, Offset);
+    ui_caret_line *Line       = MeasureCaretLine(Input, LineIndex, UploadArena);
+    uint32_t       Caret      = FindCaretIndex(Line, (uint32_t)(Offset - GetCaretLineStart(Input, LineIndex)));
+    float          LineHeight = GetTextInputLineHeight(Input);
+
+    rect_float Result = rect_float::FromXYWH(GetCaretPenX(Line, Caret), LineIndex * LineHeight, 1.f, LineHeight);
+    return Result;
+}
+
+// Lines inside the selection are covered up to their width, a selection ending at the start
+// of a line does not cover it.
+
+static uint32_t
+GetTextInputSelectionRects(ui_text_input *Input, uint64_t Start, uint64_t End, rect_float *Rects, uint32_t RectCapacity, memory_arena *UploadArena)
+{
+    VOID_ASSERT(Input && Start <= Input->Size && End <= Input->Size);
+
+    if(Start > End)
+    {
+        uint64_t Swap = Start;
+        Start = End;
+        End   = Swap;
+    }
+
+    uint32_t Result = 0;
+
+    if(Start == End)
+    {
+        return Result;
+    }
+
+    float    LineHeight = GetTextInputLineHeight(Input);
+    uint32_t First      = FindCaretLine(Input, Start);
+    uint32_t Last       = FindCaretLine(Input, End);
+
+    if(Last > First && GetCaretLineStart(Input, Last) == End)
+    {
+        Last -= 1;
+    }
+
+    for(uint32_t Idx = First; Idx <= Last && Result < RectCapacity; ++Idx)
+    {
+        ui_caret_line *Line      = MeasureCaretLine(Input, Idx, UploadArena);
+        uint64_t       LineStart = GetCaretLineStart(Input, Idx);
+        float          Left      = 0.f;
+        float          Right     = GetCaretPenX(Line, Line->CaretCount - 1);
+
+        if(Idx == First)
+        {
+            Left = GetCaretPenX(Line, FindCaretIndex(Line, (uint32_t)(Start - LineStart)));
+        }
+
+        if(Idx == Last && End <= LineStart + Line->Size)
+        {
+            Right = GetCaretPenX(Line, FindCaretIndex(Line, (uint32_t)(End - LineStart)));
+        }
+
+        Rects[Result++] = rect_float(Left, Idx * LineHeight, Right, (Idx + 1) * LineHeight);
+    }
+
+    return Result;
+}
+
+static byte_string
+ReadTextInputLine(ui_text_input *Input, uint32_t LineIndex, memory_arena *Arena)
+{
+    VOID_ASSERT(Input && LineIndex < Input->LineCount);
+
+    byte_string Result = ReadTextInput(Input, GetCaretLineStart(Input, LineIndex), Input->Lines[LineIndex].Size, Arena);
+    return Result;
+}
+
+// Pointer events arrive between frames, when no upload arena exists to shape dirty lines.
+// A click followed by drags before the next paint keeps the anchor of the click.
+
+static void
+SetTextInputPointer(ui_text_input *Input, vec2_float Point, bool IsDrag)
+{
+    VOID_ASSERT(Input);
+
+    if(!IsDrag)
+    {
+        Input->PointerAnchor    = Point;
+        Input->HasPointerAnchor = true;
+    }
+
+    Input->PointerCaret    = Point;
+    Input->HasPointerCaret = true;
+}
+
+static uint64_t
+GetPreviousTextInputCaret(ui_text_input *Input, uint64_t Offset)
+{
+    uint64_t Result = Offset;
+
+    if(Result > 0)
+    {
+        Result -= 1;
+        while(Result > 0 && (GetTextInputByte(Input, Result) & 0xC0) == 0x80)
+        {
+            Result -= 1;
+        }
+    }
+
+    return Result;
+}
+
+static uint64_t
+GetNextTextInputCaret(ui_text_input *Input, uint64_t Offset)
+{
+    uint64_t Result = Offset;
+
+    if(Result < Input->Size)
+    {
+        Result += 1;
+        while(Result < Input->Size && (GetTextInputByte(Input, Result) & 0xC0) == 0x80)
+        {
+            Result += 1;
+        }
+    }
+
+    return Result;
+}
+
+// Characters and deletions go through ReplaceTextInput, which notifies OnEdit. Caret moves
+// only bump the version. A character that does not fit is dropped.
+
+static void
+ApplyTextInputEvent(ui_text_input *Input, text_event Event)
+{
+    VOID_ASSERT(Input);
+
+    uint64_t Start = Min(Input->Caret, Input->Anchor);
+    uint64_t End   = Max(Input->Caret, Input->Anchor);
+
+    if(Event.Type == TextEvent::Char)
+    {
+        uint32_t Codepoint = Event.Codepoint;
+        uint8_t  Bytes[4]  = {};
+        uint64_t Size      = 0;
+
+        if(Codepoint < 0x80)
+        {
+            Bytes[Size++] = (uint8_t)Codepoint;
+        }
+        else if(Codepoint < 0x800)
+        {
+            Bytes[Size++] = (uint8_t)(0xC0 | (Codepoint >> 6));
+            Bytes[Size++] = (uint8_t)(0x80 | (Codepoint & 0x3F));
+        }
+        else if(Codepoint < 0x10000)
+        {
+            Bytes[Size++] = (uint8_t)(0xE0 | (Codepoint >> 12));
+            Bytes[Size++] = (uint8_t)(0x80 | ((Codepoint >> 6) & 0x3F));
+            Bytes[Size++] = (uint8_t)(0x80 | (Codepoint & 0x3F));
+        }
+        else if(Codepoint < 0x110000)
+        {
+            Bytes[Size++] = (uint8_t)(0xF0 | (Codepoint >> 18));
+            Bytes[Size++] = (uint8_t)(0x80 | ((Codepoint >> 12) & 0x3F));
+            Bytes[Size++] = (uint8_t)(0x80 | ((Codepoint >> 6) & 0x3F));
+            Bytes[Size++] = (uint8_t)(0x80 | (Codepoint & 0x3F));
+        }
+
+        if(Size)
+        {
+            ReplaceTextInput(Input, Start, End - Start, ByteString(Bytes, Size));
+        }
+
+        return;
+    }
+
+    switch(Event.Key)
+    {
+
+    case OSInputKey_Backspace:
+    {
+        uint64_t From = Start == End ? GetPreviousTextInputCaret(Input, Start) : Start;
+        if(From < End)
+        {
+            ReplaceTextInput(Input, From, End - From, ByteString(0, 0));
+        }
+    } break;
+
+    case OSInputKey_Delete:
+    {
+        uint64_t To = Start == End ? GetNextTextInputCaret(Input, End) : End;
+        if(Start < To)
+        {
+            ReplaceTextInput(Input, Start, To - Start, ByteString(0, 0));
+        }
+    } break;
+
+    case OSInputKey_Left:
+    {
+        Input->Caret    = Start == End ? GetPreviousTextInputCaret(Input, Start) : Start;
+        Input->Anchor   = Input->Caret;
+        Input->Version += 1;
+    } break;
+
+    case OSInputKey_Right:
+    {
+        Input->Caret    = Start == End ? GetNextTextInputCaret(Input, End) : End;
+        Input->Anchor   = Input->Caret;
+        Input->Version += 1;
+    } break;
+
+    case OSInputKey_Home:
+    case OSInputKey_End:
+    {
+        uint32_t LineIndex = FindCaretLine(Input, Input->Caret);
+        uint64_t LineStart = GetCaretLineStart(Input, LineIndex);
+
+        Input->Caret    = Event.Key == OSInputKey_Home ? LineStart : LineStart + Input->Lines[LineIndex].Size;
+        Input->Anchor   = Input->Caret;
+        Input->Version += 1;
+    } break;
+
+    default:
+    {
+    } break;
+
+    }
+}
+
+static void
+ResolveTextInputPointer(ui_text_input *Input, memory_arena *UploadArena)
+{
+    VOID_ASSERT(Input);
+
+    if(Input->HasPointerAnchor)
+    {
+        Input->Anchor           = FindTextInputOffset(Input, Input->PointerAnchor, UploadArena);
+        Input->HasPointerAnchor = false;
+        Input->Version         += 1;
+    }
+
+    if(Input->HasPointerCaret)
+    {
+        Input->Caret           = FindTextInputOffset(Input, Input->PointerCaret, UploadArena);
+        Input->HasPointerCaret = false;
+        Input->Version        += 1;
+    }
+}
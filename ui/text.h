@@ -1,38 +1,375 @@
 // =================================================================
 // @Internal: Fonts Implementation
 
+// Glyphs are shaped and uploaded through the face of the font. A system font is its own face.
+// Distance fonts of the same name share a single face which owns the generator and the
+// atlas, they only scale its glyphs: every size is drawn from one rasterization and all of
+// them batch together. A name and size is loaded once, by whichever loader comes first.
+//
+// The atlas of a face has up to UIFontAtlasPageCount pages of the cache size, glyphs spill
+// to the next page when the current ones are full and the atlas is only repacked once all
+// of them are. A page gets its texture when a glyph first lands on it.
+
+#define UIDistanceFontEmSize 32.f
+#define UIFontAtlasPageCount 4
+
 struct ui_font
 {
-    render_handle          Texture;
-    render_handle          TextureView;
-    vec2_uint16            TextureSize;
+    vec2_uint16            TextureSize;  // Of one atlas page
     ntext::glyph_generator Generator;
+    ui_font               *Face;
+    float                  Scale;        // Size over the size the face rasterizes at
+    float                  Sharpness;    // Distance to coverage factor, 0 for coverage atlases
+    uint32_t               ReadyVersion; // Bumped by the face when pending glyphs land, for damage
     uint16_t               Size;
     byte_string            Name;
+
+    // Faces only
+    ui_font               *Next;
+    render_handle          Textures    [ntext::MaxAtlasPageCount];
+    render_handle          TextureViews[ntext::MaxAtlasPageCount];
+    uint32_t               PageCount;    // Pages with a texture
+    os_mapped_file         CacheFile;
+    const uint8_t         *CachePixels;  // Atlas of the cache file, uploaded when the face first shapes
+    bool                   CacheDirty;   // Glyphs were rasterized since the cache file was read
 };
 
-static ui_resource_key UILoadSystemFont  (byte_string Name, float Size, uint16_t CacheSizeX, uint16_t CacheSizeY);
+static ui_resource_key UILoadSystemFont    (byte_string Name, float Size, uint16_t CacheSizeX, uint16_t CacheSizeY);
+static ui_resource_key UILoadDistanceFont  (byte_string Name, float Size, uint16_t CacheSizeX, uint16_t CacheSizeY);
+
+// Glyph Cache Files:
+//   Once a directory is set, faces created afterwards look for "<Name>-<Size>.glyphs" (or
+//   "<Name>-<Size>-sdf.glyphs") in it. A file written by this version of ntext from the same
+//   font file and atlas setup is mapped: its glyphs are in place without rasterizing any of
+//   them. UISaveGlyphCaches writes the file of every face which rasterized glyphs since,
+//   call it on shutdown.
+
+static void UISetGlyphCacheDirectory  (byte_string Path);
+static void UISaveGlyphCaches         (void);
 
 // =================================================================
 // @Internal: Static Text Implementation
 
+// Position is relative to the top-left of the run. Glyphs with an empty Source have nothing
+// to draw (spaces, glyphs which did not fit in the atlas).
+
 struct ui_shaped_glyph
 {
-    float      OffsetX;
-    float      OffsetY;
+    rect_float Position;
+    rect_float Source;
     float      Advance;
-    rect_float Source;    // Currently have no way of getting this from ntext.
 };
 
-// Do we need to store Texture/TextureSize, since we can always get them from the font?
-// And it would also clear up the problem of who owns what (the font owns the texture)
+// A break opportunity after glyph GlyphIndex. Space and newline glyphs are dropped from the
+// lines they end, a punctuation glyph stays on its line. Newlines always break.
+
+typedef enum UITextBreak_Type
+{
+    UITextBreak_Space       = 0,
+    UITextBreak_Punctuation = 1,
+    UITextBreak_Newline     = 2,
+} UITextBreak_Type;
+
+struct ui_text_break
+{
+    uint32_t         GlyphIndex;
+    UITextBreak_Type Type;
+};
+
+struct ui_text_line
+{
+    uint32_t Start;
+    uint32_t End;
+    float    Width;
+};
+
+struct ui_shaped_run
+{
+    ui_shaped_glyph *Glyphs;
+    uint32_t         GlyphCount;
+    float            Width;
+    float            UnwrappedWidth;  // Of the widest line when only newlines break
+    float            LineHeight;
+    uint32_t         AtlasVersion;    // Sources are only valid for this version of the font atlas
+
+    // Wrapping
+    float           *AdvanceSums;     // GlyphCount + 1 entries, the pen position before each glyph
+    float            FixedAdvance;    // Advance of every glyph when the font is fixed pitch, AdvanceSums is then null
+    ui_text_break   *Breaks;
+    uint32_t         BreakCount;
+    ui_text_line    *Lines;           // BreakCount + 1 entries, the result of the last fit
+    uint32_t         LineCount;
+    float            WrapWidth;
+};
+
+// The text resource only owns a copy of the string. Glyphs are found through the shaped
+// run cache when painting.
 
 struct ui_text
 {
-    ui_resource_key  FontKey;
-    ui_shaped_glyph *Shaped;
-    uint32_t         ShapedCount;
+    ui_resource_key FontKey;
+    byte_string     String;
 };
 
 static uint64_t  GetTextFootprint   (uint64_t Size);
-static ui_text * PlaceTextInMemory  (byte_string String, void *Memory);
+static ui_text * PlaceTextInMemory  (byte_string String, ui_resource_key FontKey, void *Memory);
+
+// -----------------------------------------------------------------------------------
+// Glyph Workers:
+//   Atlas rects of the glyphs missing from a run are reserved by FillAtlas on the shaping
+//   thread, their rasterization is then split across a worker pool. The shaping thread
+//   drains the queue with the workers and waits, such that the upload list is complete
+//   when ShapeTextRun returns. Each job rasterizes into its own scratch arena, which is
+//   cleared on the next dispatch (uploads copy the pixels).
+//
+// CreateGlyphWorkers:
+//   Returns NULL on single core machines, misses are then rasterized serially.
+
+struct ui_glyph_job
+{
+    ntext::rasterized_glyph_list *List;
+    ntext::glyph_generator       *Generator;
+    ntext::memory_arena          *Scratch;
+    uint32_t                      Start;
+    uint32_t                      Stride;
+};
+
+struct ui_glyph_workers
+{
+    os_work_queue *Queue;
+    ui_glyph_job  *Jobs;
+    uint32_t       JobCount;
+};
+
+#define UIGlyphJobScratchSize   VOID_MEGABYTE(1)
+#define UIParallelGlyphMinCount 16
+
+static ui_glyph_workers * CreateGlyphWorkers  (memory_arena *Arena);
+
+// -----------------------------------------------------------------------------------
+// Glyph Budget:
+//   Rasterization is charged to a per frame budget of UIGlyphFrameBudget seconds. Once it
+//   is spent, missing glyphs keep their atlas rect, which is cleared, and wait in the
+//   pending queue: runs are still shaped and drawn without them, the next frames drain the
+//   queue. A face bumps its ReadyVersion when pending glyphs land, which damages the labels
+//   painted with it.
+//
+// ResetGlyphBudget:
+//   Called by UIBeginFrame.
+//
+// CompletePendingGlyphs:
+//   Rasterizes pending glyphs with what is left of the budget, their pixels are uploaded
+//   from UploadArena. Called before a pipeline measures its text. The queue depth and the
+//   budget overruns are sampled by the profiler.
+
+struct ui_pending_glyph
+{
+    ui_font                *Face;
+    uint32_t                AtlasVersion;
+    ntext::rasterized_glyph Glyph;
+};
+
+struct ui_glyph_queue
+{
+    ui_pending_glyph *Items;
+    uint32_t          Capacity;
+    uint32_t          First;
+    uint32_t          Count;
+
+    // Budget (OSReadTimer ticks)
+    uint64_t          BudgetTicks;
+    uint64_t          FrameTicks;
+    bool              FrameOverrun;
+
+    // Stats
+    uint64_t          DeferredCount;
+    uint64_t          OverrunCount;
+};
+
+#define UIGlyphFrameBudget     0.004f
+#define UIPendingGlyphCapacity 1024
+
+static ui_glyph_queue * CreateGlyphQueue       (memory_arena *Arena);
+static void             ResetGlyphBudget       (ui_glyph_queue *Queue);
+static void             CompletePendingGlyphs  (memory_arena *UploadArena);
+
+// -----------------------------------------------------------------------------------
+// Shaped Run Cache:
+//   Runs are keyed by (font key, font size, XXH3 of the text), such that unchanged labels
+//   reuse their glyphs with a single lookup. Runs are evicted in LRU order when the cache
+//   runs out of entries or when the glyph memory exceeds ByteBudget. A run shaped against
+//   an older font atlas (the atlas was repacked) is shaped again.
+//
+// FindShapedRun:
+//   Returns the run for Text, shaping it on a miss. Glyphs rasterized on a miss are
+//   uploaded to the font texture, their pixels are allocated from UploadArena. Glyphs over
+//   the frame budget are left pending. The run stays valid until the next call. Returns
+//   NULL if the font does not exist.
+//
+// ProfileShapedRunCache:
+//   Samples the hit rate and the glyph memory against ByteBudget into the profiler
+//   counters. Called once per frame by UIEndFrame.
+
+typedef struct ui_shaped_run_cache ui_shaped_run_cache;
+
+struct ui_shaped_run_cache_params
+{
+    uint32_t HashSlotCount;
+    uint32_t EntryCount;
+    uint64_t ByteBudget;
+};
+
+static uint64_t              GetShapedRunCacheFootprint   (ui_shaped_run_cache_params Params);
+static ui_shaped_run_cache * PlaceShapedRunCacheInMemory  (ui_shaped_run_cache_params Params, void *Memory);
+static ui_shaped_run       * FindShapedRun                (byte_string Text, ui_resource_key FontKey, memory_arena *UploadArena, ui_shaped_run_cache *Cache);
+static ui_resource_stats     GetShapedRunCacheStats       (ui_shaped_run_cache *Cache);
+static void                  ProfileShapedRunCache        (ui_shaped_run_cache *Cache);
+
+// -----------------------------------------------------------------------------------
+// Text Wrapping:
+//   Break opportunities are found once per shaped run with an SSE scan over the bytes and
+//   kept with the prefix sums of the glyph advances. Fitting a run to a width is a greedy
+//   walk over the breaks where each candidate line is measured with one subtraction, such
+//   that resizing only re-runs the fit. The last fit is kept on the run.
+//
+// WrapShapedRun:
+//   Fits the run to MaxWidth and returns the line count. A MaxWidth <= 0 only breaks on
+//   newlines. Words wider than MaxWidth overflow their line.
+//
+// MeasureText:
+//   Width of the text resource when only newlines break and its line height, read from its
+//   shaped run: a cached run is measured without shaping or wrapping it. Fixed pitch fonts
+//   skip the run when the text is printable ASCII, each line is then its byte count times
+//   the fixed advance. Used by layout to size Fit widths, glyphs shaped here are uploaded
+//   from UploadArena.
+//
+// MeasureTextHeight:
+//   Height of the text resource once wrapped to Width. Used by layout to answer
+//   height-for-width queries, glyphs shaped here are uploaded from UploadArena.
+
+struct ui_text_metrics
+{
+    float Width;
+    float LineHeight;
+};
+
+static uint32_t        FindTextBreaks     (byte_string Text, uint32_t GlyphCount, ui_text_break *Breaks);
+static uint32_t        WrapShapedRun      (float MaxWidth, ui_shaped_run *Run);
+static ui_text_metrics MeasureText        (ui_resource_key TextKey, memory_arena *UploadArena);
+static float           MeasureTextHeight  (ui_resource_key TextKey, float Width, memory_arena *UploadArena);
+
+// -----------------------------------------------------------------------------------
+// Text Columns:
+//   Fixed pitch runs keep no advance sums, every pen position is a multiplication. Other
+//   runs read their prefix sums. Line widths, carets and hit tests never walk the glyphs.
+//
+// GetRunPenX:
+//   Pen position before GlyphIndex from the start of the run. GlyphIndex may be GlyphCount.
+
+static float GetRunPenX  (ui_shaped_run *Run, uint32_t GlyphIndex);
+
+// =================================================================
+// @Internal: Text Input Implementation
+
+// The buffer belongs to the caller and stores the content as a gap buffer: the bytes before
+// the gap, the gap, then the bytes after it. Edits move the gap to their offset first, thus
+// typing at the same place moves no bytes. Offsets are byte offsets in the content and carets
+// sit on codepoint boundaries. Positions are relative to the top-left of the text, one hard
+// line per line height.
+//
+// Every line keeps the pen position and the byte offset of each of its carets, copied from
+// the shaped run of the line. An edit splices the lines it touches and marks them dirty:
+// only dirty lines are shaped again, when a query first reaches them. The lines after an
+// edit only move, their starts are shifted lazily: lines from ShiftLine on are ShiftDelta
+// bytes away from their stored start, and the boundary is moved to each edit. Caret
+// placement, selections and hit tests are binary searches over the line starts and the
+// line's offsets or sums. Lines shaped at a fixed pitch keep no sums, their pen positions
+// and hit tests are column arithmetic.
+
+struct ui_caret_line
+{
+    uint64_t  Start;         // Byte offset of the line in the content, see ShiftLine
+    uint32_t  Size;          // Without its newline
+    uint32_t  CaretCount;    // Glyphs + 1
+    uint32_t *Offsets;       // CaretCount entries, byte offset of each caret from Start
+    float    *Sums;          // CaretCount entries, pen position of each caret, null when FixedAdvance is set
+    float     FixedAdvance;  // Advance of every caret when the line is shaped at a fixed pitch
+    bool      IsDirty;
+};
+
+struct ui_text_input
+{
+    ui_resource_key FontKey;
+    uint8_t        *Buffer;
+    uint64_t        Capacity;
+    uint64_t        Size;     // Of the content
+    uint64_t        GapStart;
+    uint64_t        GapSize;
+    uint64_t        Caret;
+    uint64_t        Anchor;   // The selection spans Caret and Anchor
+
+    // Caret Index
+    ui_caret_line  *Lines;
+    uint32_t        LineCount;
+    uint32_t        LineCapacity;
+    uint32_t        ShiftLine;
+    int64_t         ShiftDelta;
+
+    // Pointer, resolved when the input is painted
+    vec2_float      PointerAnchor;
+    vec2_float      PointerCaret;
+    bool            HasPointerAnchor;
+    bool            HasPointerCaret;
+    uint32_t        Version;  // Bumped by edits and caret moves
+
+    // Notifications
+    ui_text_input_onedit OnEdit;
+    void                *UserData;
+};
+
+static uint64_t        GetTextInputFootprint   (void);
+static ui_text_input * PlaceTextInputInMemory  (uint8_t *Buffer, uint64_t BufferSize, ui_resource_key FontKey, void *Memory);
+static void            ReleaseTextInput        (ui_text_input *Input);
+
+// ReplaceTextInput:
+//   Replaces RemoveSize bytes at Offset with Text, moves the caret after it and notifies
+//   OnEdit. Returns false if the content and a terminator would not fit in the buffer.
+//
+// GetTextInputString:
+//   Closes the gap at the end of the buffer and returns the content, which is then zero
+//   terminated. Costs a move of the bytes after the gap, the next edit reopens it.
+//
+// FindTextInputOffset:
+//   Byte offset of the caret closest to Point (click-to-offset).
+//
+// GetTextInputCaretRect:
+//   Rect of a one pixel wide caret at Offset.
+//
+// GetTextInputSelectionRects:
+//   Writes one rect per line covered by [Start, End) and returns their count, at most
+//   RectCapacity.
+//
+// ReadTextInputLine:
+//   Content of a line without its newline. A line split by the gap is copied to Arena.
+//
+// SetTextInputPointer:
+//   Records a pointer at Point. A click places the caret and the anchor, a drag only the
+//   caret. Offsets need the line shapes, they are found by ResolveTextInputPointer.
+//
+// ResolveTextInputPointer:
+//   Moves the caret (and anchor) to the recorded pointer. Called when painting.
+//
+// ApplyTextInputEvent:
+//   Types a character over the selection, or applies an editing key: backspace and delete
+//   remove the selection or one codepoint, arrows move by one codepoint (or collapse the
+//   selection), home and end move to the bounds of the line.
+
+static bool        ReplaceTextInput            (ui_text_input *Input, uint64_t Offset, uint64_t RemoveSize, byte_string Text);
+static byte_string GetTextInputString          (ui_text_input *Input);
+static uint64_t    FindTextInputOffset         (ui_text_input *Input, vec2_float Point, memory_arena *UploadArena);
+static rect_float  GetTextInputCaretRect       (ui_text_input *Input, uint64_t Offset, memory_arena *UploadArena);
+static uint32_t    GetTextInputSelectionRects  (ui_text_input *Input, uint64_t Start, uint64_t End, rect_float *Rects, uint32_t RectCapacity, memory_arena *UploadArena);
+static byte_string ReadTextInputLine           (ui_text_input *Input, uint32_t LineIndex, memory_arena *Arena);
+static void        SetTextInputPointer         (ui_text_input *Input, vec2_float Point, bool IsDrag);
+static void        ResolveTextInputPointer     (ui_text_input *Input, memory_arena *UploadArena);
+static void        ApplyTextInputEvent         (ui_text_input *Input, text_event Event);